@@ -22,8 +22,8 @@ int main(void) {
     int ret = bigint_from_hex(&n, test_hex);
     printf("Hex parsing result: %d\n", ret);
     printf("Parsed number used words: %d\n", n.used);
-    printf("First word: 0x%08X\n", n.words[0]);
-    printf("Is odd (words[0] & 1): %d\n", n.words[0] & 1);
+    printf("First word: 0x" BIGINT_WORD_FMT "\n", n.words[0]);
+    printf("Is odd (words[0] & 1): %d\n", (int)(n.words[0] & 1));
     
     /* Print first few hex digits back to verify parsing */
     char hex_back[128];
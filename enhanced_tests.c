@@ -124,14 +124,14 @@ int test_edge_cases_zero_one_boundary(void) {
     if (ret == 0 && result.words[0] == 34) {
         printf("   ✅ 34^1 mod 35 = 34\n");
     } else {
-        printf("   ❌ 34^1 mod 35 failed, got %u\n", result.words[0]);
+        printf("   ❌ 34^1 mod 35 failed, got %u\n", (unsigned)result.words[0]);
     }
     
     /* (n-1)^2 mod n should be 1 for prime modulus */
     bigint_set_u32(&result, 2);
     ret = bigint_mod_exp(&result, &boundary_val, &result, &mod);
     if (ret == 0) {
-        printf("   ✅ 34^2 mod 35 = %u (computed successfully)\n", result.words[0]);
+        printf("   ✅ 34^2 mod 35 = %u (computed successfully)\n", (unsigned)result.words[0]);
         passed++;
     } else {
         printf("   ❌ 34^2 mod 35 computation failed\n");
@@ -219,10 +219,10 @@ void print_security_warnings() {
     printf("    - OAEP padding is not implemented\n");
     printf("    - Raw RSA is vulnerable to various attacks\n");
     printf("\n");
-    printf("⚠️  KEY GENERATION: No secure key generation provided\n");
-    printf("    - Use OpenSSL or similar for key generation\n");
-    printf("    - Ensure proper entropy sources\n");
-    printf("    - Use cryptographically secure random numbers\n");
+    printf("⚠️  KEY GENERATION: rsa_4096_keygen() draws primes from the system CSPRNG\n");
+    printf("    - Probable primes only (Miller-Rabin, 2^-128 error bound)\n");
+    printf("    - Not a validated FIPS 186 implementation\n");
+    printf("    - Ensure the system entropy source is seeded before use\n");
     printf("\n");
     printf("⚠️  SIDE CHANNEL ATTACKS: Limited protection\n");
     printf("    - Montgomery ladder helps but isn't complete\n");
@@ -232,7 +232,6 @@ void print_security_warnings() {
     printf("🔧 RECOMMENDATIONS:\n");
     printf("   - Use this for educational purposes or as a foundation\n");
     printf("   - For production, add proper padding schemes\n");
-    printf("   - Implement secure key generation\n");
     printf("   - Consider using established libraries (OpenSSL, etc.)\n");
     printf("========================================\n");
 }
@@ -15,7 +15,7 @@
 int main(int argc, char **argv) {
     printf("[main:%d] Starting RSA-4096 application\n", __LINE__);
     if (argc < 2) {
-        printf("Usage: %s [verify|test|benchmark|binary|manual|real4096|hybrid|roundtrip|boundary|montgomery|algorithms|edge]\n", argv[0]);
+        printf("Usage: %s [verify|test|benchmark|binary|manual|real4096|hybrid|crt|logging|batch|pool|simd|comb|workspace|convert|stats|inverse|blinding|stream|kernels|keystore|async|keygen|shortexp|plan|roundtrip|boundary|montgomery|algorithms|edge]\n", argv[0]);
         return 1;
     }
     if (strcmp(argv[1], "verify") == 0) {
@@ -27,8 +27,21 @@ int main(int argc, char **argv) {
         return test_large_rsa_keys();
     }
     if (strcmp(argv[1], "benchmark") == 0) {
+        /* benchmark [--json FILE] [--budget MS] */
+        const char *json_path = NULL;
+        double budget_ms = 0.0;
+        for (int i = 2; i + 1 < argc; i += 2) {
+            if (strcmp(argv[i], "--json") == 0) {
+                json_path = argv[i + 1];
+            } else if (strcmp(argv[i], "--budget") == 0) {
+                budget_ms = atof(argv[i + 1]);
+            } else {
+                printf("Usage: %s benchmark [--json FILE] [--budget MS]\n", argv[0]);
+                return 1;
+            }
+        }
         printf("[main:%d] Running performance benchmarks\n", __LINE__);
-        return run_benchmarks();
+        return run_benchmark_suite(json_path, budget_ms);
     }
     if (strcmp(argv[1], "binary") == 0) {
         printf("[main:%d] Running binary operations verification\n", __LINE__);
@@ -46,6 +59,78 @@ int main(int argc, char **argv) {
         printf("[main:%d] Running hybrid algorithm selection testing\n", __LINE__);
         return test_hybrid_algorithm_selection();
     }
+    if (strcmp(argv[1], "crt") == 0) {
+        printf("[main:%d] Running CRT private-key decryption testing\n", __LINE__);
+        return test_crt_decryption();
+    }
+    if (strcmp(argv[1], "logging") == 0) {
+        printf("[main:%d] Running logging subsystem testing\n", __LINE__);
+        return test_logging_subsystem();
+    }
+    if (strcmp(argv[1], "batch") == 0) {
+        printf("[main:%d] Running batch operation testing\n", __LINE__);
+        return test_batch_operations();
+    }
+    if (strcmp(argv[1], "pool") == 0) {
+        printf("[main:%d] Running worker pool testing\n", __LINE__);
+        return test_worker_pool();
+    }
+    if (strcmp(argv[1], "simd") == 0) {
+        printf("[main:%d] Running multi-buffer engine testing\n", __LINE__);
+        return test_simd_engine();
+    }
+    if (strcmp(argv[1], "comb") == 0) {
+        printf("[main:%d] Running fixed-base comb testing\n", __LINE__);
+        return test_fixed_base_comb();
+    }
+    if (strcmp(argv[1], "workspace") == 0) {
+        printf("[main:%d] Running scratch workspace testing\n", __LINE__);
+        return test_scratch_workspace();
+    }
+    if (strcmp(argv[1], "convert") == 0) {
+        printf("[main:%d] Running conversion testing\n", __LINE__);
+        return test_conversions();
+    }
+    if (strcmp(argv[1], "stats") == 0) {
+        printf("[main:%d] Running instrumentation counter testing\n", __LINE__);
+        return test_instrumentation();
+    }
+    if (strcmp(argv[1], "inverse") == 0) {
+        printf("[main:%d] Running modular inverse testing\n", __LINE__);
+        return test_mod_inverse();
+    }
+    if (strcmp(argv[1], "blinding") == 0) {
+        printf("[main:%d] Running blinding testing\n", __LINE__);
+        return test_blinding();
+    }
+    if (strcmp(argv[1], "stream") == 0) {
+        printf("[main:%d] Running streaming encryption testing\n", __LINE__);
+        return test_streaming();
+    }
+    if (strcmp(argv[1], "kernels") == 0) {
+        printf("[main:%d] Running fixed-size kernel testing\n", __LINE__);
+        return test_fixed_kernels();
+    }
+    if (strcmp(argv[1], "keystore") == 0) {
+        printf("[main:%d] Running key store testing\n", __LINE__);
+        return test_keystore();
+    }
+    if (strcmp(argv[1], "async") == 0) {
+        printf("[main:%d] Running async and cooperative job testing\n", __LINE__);
+        return test_async();
+    }
+    if (strcmp(argv[1], "keygen") == 0) {
+        printf("[main:%d] Running key generation testing\n", __LINE__);
+        return test_keygen();
+    }
+    if (strcmp(argv[1], "shortexp") == 0) {
+        printf("[main:%d] Running short public exponent testing\n", __LINE__);
+        return test_short_exponent();
+    }
+    if (strcmp(argv[1], "plan") == 0) {
+        printf("[main:%d] Running exponentiation plan testing\n", __LINE__);
+        return test_exponent_plan();
+    }
     /* TODO: Enhanced round-trip testing commands */
     if (strcmp(argv[1], "roundtrip") == 0) {
         printf("[main:%d] Running comprehensive round-trip validation\n", __LINE__);
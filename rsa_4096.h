@@ -13,37 +13,206 @@
 #include <stdint.h>
 #include <stddef.h>
 #include <stdio.h>
+#include <inttypes.h>
 
 /* ===================== CONFIGURATION ===================== */
 
-/* BigInt configuration for 4096-bit numbers */
+/*
+ * Limb width: 64-bit limbs with unsigned __int128 double words where the
+ * compiler provides them (x86-64, aarch64), 32-bit limbs otherwise.
+ * Build with -DBIGINT_WORD_SIZE=32 to force the portable configuration.
+ */
+#ifndef BIGINT_WORD_SIZE
+#if defined(__SIZEOF_INT128__)
+#define BIGINT_WORD_SIZE 64
+#else
 #define BIGINT_WORD_SIZE 32
+#endif
+#endif
+
+#if BIGINT_WORD_SIZE == 64
+typedef uint64_t bigint_word_t;
+typedef unsigned __int128 bigint_dword_t;
+#define BIGINT_WORD_MASK 0xFFFFFFFFFFFFFFFFULL
+#define BIGINT_WORD_FMT "%016" PRIx64
+#elif BIGINT_WORD_SIZE == 32
+typedef uint32_t bigint_word_t;
+typedef uint64_t bigint_dword_t;
 #define BIGINT_WORD_MASK 0xFFFFFFFFUL
-#define BIGINT_4096_WORDS 512  /* Increased to 512 words to handle full RSA-4096 Montgomery multiplication and intermediate results */
+#define BIGINT_WORD_FMT "%08" PRIx32
+#else
+#error "BIGINT_WORD_SIZE must be 32 or 64"
+#endif
+
+#define BIGINT_WORD_BYTES (BIGINT_WORD_SIZE / 8)
+
+/* BigInt configuration for 4096-bit numbers: values are sized to the modulus,
+ * double-width products live in bigint_wide_t */
+#define BIGINT_MAX_BITS   4096
+#define BIGINT_4096_WORDS (BIGINT_MAX_BITS / BIGINT_WORD_SIZE + 2)        /* 4096-bit value + carry/R word slack */
+#define BIGINT_WIDE_WORDS (2 * (BIGINT_MAX_BITS / BIGINT_WORD_SIZE) + 2)  /* 4096 x 4096-bit product + slack */
 
 /* Montgomery REDC specific constants */
-#define MONTGOMERY_R_WORDS 264  /* Doubled to handle larger R values for 4096-bit modulus */
+#define MONTGOMERY_R_WORDS (BIGINT_MAX_BITS / BIGINT_WORD_SIZE + 1)  /* R = 2^(BIGINT_WORD_SIZE * n_words) for a 4096-bit modulus */
+
+/* Montgomery exponentiation window width (bits); AUTO picks from exponent length */
+#define MONTGOMERY_WINDOW_AUTO 0
+#define MONTGOMERY_WINDOW_MIN  1
+#define MONTGOMERY_WINDOW_MAX  7
+
+/* Karatsuba: operands of at least this many limbs are split in halves
+ * (bigint_set_karatsuba_threshold changes them at runtime). Squaring starts
+ * later because the schoolbook square already halves the multiplies. */
+#ifndef BIGINT_KARATSUBA_THRESHOLD
+#define BIGINT_KARATSUBA_THRESHOLD 32
+#endif
+#ifndef BIGINT_KARATSUBA_SQR_THRESHOLD
+#define BIGINT_KARATSUBA_SQR_THRESHOLD 48
+#endif
+/* Scratch limbs bigint_limbs_{mul,sqr}_karatsuba need for operands of up to n limbs */
+#define BIGINT_KARATSUBA_SCRATCH(n) (8 * (n) + 64)
+
+/* Unroll hint for the carry-chain inner loops; measured best at 8 on x86-64
+ * (full unrolling of the 4096-bit kernels costs more in code size than it saves) */
+#ifndef BIGINT_UNROLL
+#define BIGINT_UNROLL _Pragma("GCC unroll 8")
+#endif
+
+/* Smallest modulus hybrid_mod_exp hands to Montgomery; hybrid_set_montgomery_min_bits
+ * or hybrid_calibrate change it at runtime for contexts built afterwards */
+#ifndef HYBRID_MONTGOMERY_MIN_BITS
+#define HYBRID_MONTGOMERY_MIN_BITS 64
+#endif
 
 /* Algorithm limits */
 #define MAX_DIVISION_ITERATIONS 10000
-#define MAX_INVERSE_ITERATIONS 1000
 
 /* Logging levels */
 #define LOG_DEBUG 0
 #define LOG_INFO  1
 #define LOG_ERROR 2
 
+/* LOG_LEVEL is the compile-time floor: messages below it are not compiled in at all */
 #ifndef LOG_LEVEL
 #define LOG_LEVEL LOG_INFO
 #endif
 
+/* ===================== LOGGING ===================== */
+
+#define RSA_4096_LOG_LINE_MAX   256  /* Longest formatted message, including terminator */
+#define RSA_4096_LOG_RING_LINES 64   /* Messages kept by the ring buffer sink */
+
+/**
+ * @brief Log sink: receives each formatted message (no trailing newline)
+ */
+typedef void (*rsa_4096_log_sink_t)(void *user, int level, const char *func, int line, const char *msg);
+
+/**
+ * @brief Fixed-size ring buffer holding the most recent messages
+ */
+typedef struct {
+    char lines[RSA_4096_LOG_RING_LINES][RSA_4096_LOG_LINE_MAX];
+    int levels[RSA_4096_LOG_RING_LINES];
+    unsigned int next;   /* Slot the next message goes to */
+    unsigned int count;  /* Messages held, at most RSA_4096_LOG_RING_LINES */
+} rsa_4096_log_ring_t;
+
+/* Runtime threshold, checked only for messages that survived LOG_LEVEL */
+extern int rsa_4096_log_level;
+
+void rsa_4096_log_set_level(int level);
+int rsa_4096_log_get_level(void);
+void rsa_4096_log_set_sink(rsa_4096_log_sink_t sink, void *user);  /* NULL restores the stdout sink */
+void rsa_4096_log_write(int level, const char *func, int line, const char *fmt, ...)
+    __attribute__((format(printf, 4, 5)));
+
+/* Built-in sinks */
+void rsa_4096_log_stdout_sink(void *user, int level, const char *func, int line, const char *msg);
+void rsa_4096_log_ring_sink(void *user, int level, const char *func, int line, const char *msg);
+void rsa_4096_log_ring_init(rsa_4096_log_ring_t *ring);
+const char *rsa_4096_log_ring_get(const rsa_4096_log_ring_t *ring, unsigned int index);  /* 0 = oldest */
+
+/* ===================== INSTRUMENTATION ===================== */
+
+/* RSA_4096_STATS=1 compiles the hot-path counters in; by default every hook below is a no-op */
+#ifndef RSA_4096_STATS
+#define RSA_4096_STATS 0
+#endif
+
+/**
+ * @brief Counter slots; the RSA_4096_STAT_NS_* slots hold cumulative nanoseconds per phase
+ */
+typedef enum {
+    RSA_4096_STAT_MONT_MUL = 0,             /* Montgomery products (CIOS or Karatsuba + REDC) */
+    RSA_4096_STAT_MONT_SQUARE,              /* Montgomery squarings */
+    RSA_4096_STAT_MONT_REDC,                /* Word-by-word REDC passes, including those inside squarings */
+    RSA_4096_STAT_REDC_FINAL_SUB,           /* Final conditional subtractions that were needed */
+    RSA_4096_STAT_BIGINT_DIV,               /* Long divisions (bigint_div, bigint_mod, bigint_mod_wide) */
+    RSA_4096_STAT_HYBRID_MONTGOMERY,        /* hybrid_mod_exp chose Montgomery */
+    RSA_4096_STAT_HYBRID_TRADITIONAL,       /* hybrid_mod_exp chose the traditional algorithm */
+    RSA_4096_STAT_HYBRID_FALLBACK,          /* Montgomery failed inside hybrid_mod_exp */
+    RSA_4096_STAT_PATH_FALLBACK,            /* A key's planned path failed and another one ran */
+    RSA_4096_STAT_NS_TO_FORM,               /* Conversion into Montgomery form */
+    RSA_4096_STAT_NS_EXP_LOOP,              /* Window tables and the square-and-multiply loop */
+    RSA_4096_STAT_NS_FROM_FORM,             /* Conversion out of Montgomery form */
+    RSA_4096_STAT_NS_ENCODE,                /* Output encoding (hex, decimal, binary) */
+    RSA_4096_STAT_COUNT
+} rsa_4096_stat_t;
+
+typedef enum {
+    RSA_4096_PHASE_TO_FORM = 0,
+    RSA_4096_PHASE_EXP_LOOP,
+    RSA_4096_PHASE_FROM_FORM,
+    RSA_4096_PHASE_ENCODE,
+    RSA_4096_PHASE_COUNT
+} rsa_4096_phase_t;
+
+typedef struct {
+    uint64_t counters[RSA_4096_STAT_COUNT];
+} rsa_4096_stats_t;
+
+/* Profiling hook: called on the measuring thread at the end of every timed phase */
+typedef void (*rsa_4096_phase_hook_t)(void *user, rsa_4096_phase_t phase, uint64_t ns);
+
+int rsa_4096_stats_enabled(void);
+const char *rsa_4096_stat_name(rsa_4096_stat_t stat);
+void rsa_4096_stats_snapshot(rsa_4096_stats_t *stats);         /* All threads since the last reset */
+void rsa_4096_stats_thread_snapshot(rsa_4096_stats_t *stats);  /* Calling thread since its first count */
+void rsa_4096_stats_reset(void);
+void rsa_4096_stats_set_phase_hook(rsa_4096_phase_hook_t hook, void *user);  /* NULL removes it */
+
+/* Used by the macros below */
+void rsa_4096_stats_add(rsa_4096_stat_t stat, uint64_t value);
+uint64_t rsa_4096_stats_now_ns(void);
+void rsa_4096_stats_phase(rsa_4096_phase_t phase, uint64_t start_ns);
+
+#if RSA_4096_STATS
+#define RSA_4096_STAT_ADD(stat, value) rsa_4096_stats_add((stat), (uint64_t)(value))
+#define RSA_4096_PHASE_BEGIN(start) uint64_t start = rsa_4096_stats_now_ns()
+#define RSA_4096_PHASE_END(phase, start) rsa_4096_stats_phase((phase), (start))
+#else
+#define RSA_4096_STAT_ADD(stat, value) ((void)0)
+#define RSA_4096_PHASE_BEGIN(start) ((void)0)
+#define RSA_4096_PHASE_END(phase, start) ((void)0)
+#endif
+
 /* ===================== MACROS ===================== */
 
+/* Constant-folds to 0 below LOG_LEVEL, so the whole call disappears from hot paths */
+#define LOG_ENABLED(level) ((level) >= LOG_LEVEL && (level) >= rsa_4096_log_level)
+
 #define CHECKPOINT(level, fmt, ...) \
     do { \
-        if (level >= LOG_LEVEL) { \
-            printf("[%s:%d] " fmt "\n", __func__, __LINE__, ##__VA_ARGS__); \
-            fflush(stdout); \
+        if (LOG_ENABLED(level)) { \
+            rsa_4096_log_write(level, __func__, __LINE__, fmt, ##__VA_ARGS__); \
+        } \
+    } while(0)
+
+/* Value dumps are debug-only; arguments are not evaluated unless compiled in */
+#define DEBUG_BIGINT(name, a) \
+    do { \
+        if (LOG_ENABLED(LOG_DEBUG)) { \
+            debug_print_bigint(name, a); \
         } \
     } while(0)
 
@@ -57,22 +226,21 @@
 #define ASSERT_ROUND_TRIP(condition, fmt, ...) \
     do { \
         if (!(condition)) { \
-            printf("[ASSERT_FAIL:%s:%d] ROUND-TRIP ASSERTION FAILED: " fmt "\n", __func__, __LINE__, ##__VA_ARGS__); \
-            fflush(stdout); \
+            CHECKPOINT(LOG_ERROR, "[ASSERT_FAIL] ROUND-TRIP ASSERTION FAILED: " fmt, ##__VA_ARGS__); \
         } \
     } while(0)
 
 #define VALIDATE_OVERFLOW(bigint_ptr, operation) \
     do { \
-        if ((bigint_ptr)->used > BIGINT_4096_WORDS - 10) { \
+        if ((bigint_ptr)->used > BIGINT_4096_WORDS - 1) { \
             CHECKPOINT(LOG_ERROR, "POTENTIAL OVERFLOW detected in %s: used=%d, max=%d", operation, (bigint_ptr)->used, BIGINT_4096_WORDS); \
         } \
     } while(0)
 
 #define LOG_CONVERSION(step, input, output) \
     do { \
-        if (LOG_LEVEL <= LOG_DEBUG) { \
-            printf("[CONVERSION:%s] %s\n", step, #input " -> " #output); \
+        if (LOG_ENABLED(LOG_DEBUG)) { \
+            CHECKPOINT(LOG_DEBUG, "[CONVERSION:%s] %s", step, #input " -> " #output); \
             debug_print_bigint("input", input); \
             debug_print_bigint("output", output); \
         } \
@@ -84,11 +252,32 @@
  * @brief Big integer representation
  */
 typedef struct {
-    uint32_t words[BIGINT_4096_WORDS];  /* Little-endian word array */
+    bigint_word_t words[BIGINT_4096_WORDS];  /* Little-endian word array */
     int used;                           /* Number of significant words */
     int sign;                          /* 0 = positive, 1 = negative */
 } bigint_t;
 
+/**
+ * @brief Double-width big integer for full products and REDC input
+ * 
+ * Same layout rules as bigint_t (little-endian, limbs at and above 'used'
+ * are zero), with room for a 4096 x 4096-bit product.
+ */
+typedef struct {
+    bigint_word_t words[BIGINT_WIDE_WORDS];  /* Little-endian word array */
+    int used;                                /* Number of significant words */
+    int sign;                                /* 0 = positive, 1 = negative */
+} bigint_wide_t;
+
+/**
+ * @brief What hybrid_mod_exp does with a context, cached at init/import
+ */
+typedef enum {
+    MONTGOMERY_DISPATCH_INACTIVE = 0,   /* No usable context: traditional */
+    MONTGOMERY_DISPATCH_MONTGOMERY,     /* At or above the threshold: Montgomery kernels */
+    MONTGOMERY_DISPATCH_SMALL           /* Below HYBRID_MONTGOMERY_MIN_BITS: traditional */
+} montgomery_dispatch_t;
+
 /**
  * @brief Complete Montgomery REDC context - FIXED
  */
@@ -97,22 +286,240 @@ typedef struct {
     bigint_t r;          /* R = 2^(32 * n_words) where R > n */
     bigint_t r_squared;  /* R^2 mod n for conversion to Montgomery form */
     bigint_t r_inv;      /* R^(-1) mod n for conversion from Montgomery form */
-    uint32_t n_prime;    /* -n^(-1) mod 2^32 for REDC algorithm */
+    bigint_word_t n_prime;  /* -n^(-1) mod 2^BIGINT_WORD_SIZE for REDC algorithm */
     int n_words;         /* Number of words in modulus */
     int r_words;         /* Number of words in R */
     int is_active;       /* 1 if Montgomery is active, 0 if disabled */
+    int dispatch;        /* montgomery_dispatch_t, decided once when the context is built */
+    int kernel_bits;     /* Fixed-size kernel instance for n_words limbs, 0 = generic loops */
 } montgomery_ctx_t;
 
+/* Longest exponent a recoding covers: any a bigint_t can hold */
+#define MONTGOMERY_RECODING_BITS (BIGINT_4096_WORDS * BIGINT_WORD_SIZE)
+/* Windows start at least w bits apart, so b bits need at most ceil(b / w) of them;
+ * sized for w = 6, the width MONTGOMERY_WINDOW_AUTO picks for the longest exponents */
+#define MONTGOMERY_RECODING_WINDOWS ((MONTGOMERY_RECODING_BITS + 5) / 6)
+
+/**
+ * @brief Sliding-window recoding of a fixed exponent: exp = sum digit[k] * 2^pos[k]
+ */
+typedef struct {
+    int window_bits;              /* Table holds the 2^(w-1) odd powers; 0 = not built */
+    int top;                      /* Bit of the leading digit (pos[0]), -1 for a zero exponent */
+    int count;                    /* Windows in use */
+    uint16_t pos[MONTGOMERY_RECODING_WINDOWS];   /* Low bit of each window, most significant first */
+    uint8_t digit[MONTGOMERY_RECODING_WINDOWS];  /* Odd window value */
+} montgomery_exp_recoding_t;
+
+/* Window table capacity of a resumable exponentiation: 2^(w-1) odd powers, or 2^w powers for w <= 6 */
+#define MONTGOMERY_EXP_JOB_ENTRIES (1 << (MONTGOMERY_WINDOW_MAX - 1))
+
+/**
+ * @brief Resumable exponentiation, advanced a bounded number of exponent bits per step
+ * 
+ * Window table and accumulator live in the job, so nothing is held on the
+ * stack or in the scratch arena between steps and each step may run on a
+ * different thread. The context and recoding are referenced, not copied:
+ * they must outlive the job.
+ */
+typedef struct {
+    const montgomery_ctx_t *ctx;
+    const montgomery_exp_recoding_t *rec;  /* Sliding-window digits, NULL in constant-time mode */
+    int window_bits;
+    int entries;                  /* Table entries in use */
+    int pos;                      /* Next digit (or window) position, -1 once the loop is done */
+    int window;                   /* Next recoding window (sliding mode) */
+    int trivial;                  /* Result is this constant (0 or 1) without any work, else -1 */
+    bigint_word_t exp[BIGINT_4096_WORDS + 1];  /* Constant-time mode: exponent at its public length */
+    bigint_word_t acc[BIGINT_4096_WORDS];
+    bigint_word_t table[MONTGOMERY_EXP_JOB_ENTRIES * BIGINT_4096_WORDS];
+} montgomery_exp_job_t;
+
+/* Fixed-base comb limits; MONTGOMERY_COMB_AUTO picks the defaults */
+#define MONTGOMERY_COMB_AUTO           0
+#define MONTGOMERY_COMB_TEETH_MAX      8   /* 2^8 - 1 entries per block */
+#define MONTGOMERY_COMB_BLOCKS_MAX     8
+#define MONTGOMERY_COMB_DEFAULT_TEETH  6
+#define MONTGOMERY_COMB_DEFAULT_BLOCKS 2
+
+/**
+ * @brief Lim-Lee comb table for one base modulo one context
+ * 
+ * An exponent of up to max_exp_bits is cut into `teeth` rows of row_bits,
+ * each row into `blocks` columns of block_bits. Entry (j, u) holds the
+ * product of base^(2^(i*row_bits + j*block_bits)) over the set bits i of u,
+ * in Montgomery form, so an exponentiation costs block_bits squarings.
+ * The table takes blocks * (2^teeth - 1) * n_words limbs on the heap.
+ */
+typedef struct {
+    int teeth;
+    int blocks;
+    int max_exp_bits;
+    int row_bits;
+    int block_bits;
+    int n_words;
+    bigint_t n;                   /* Modulus the table was built for */
+    bigint_word_t *table;         /* Entry (j, u) at ((j * (2^teeth - 1)) + u - 1) * n_words */
+} montgomery_comb_t;
+
+/**
+ * @brief CRT private key components (PKCS#1 prime1/prime2/exponent1/exponent2/coefficient)
+ */
+typedef struct {
+    bigint_t p;                   /* First prime factor of n */
+    bigint_t q;                   /* Second prime factor of n */
+    bigint_t dp;                  /* d mod (p-1) */
+    bigint_t dq;                  /* d mod (q-1) */
+    bigint_t qinv;                /* q^(-1) mod p */
+    montgomery_ctx_t mont_p;      /* Montgomery REDC context for p */
+    montgomery_ctx_t mont_q;      /* Montgomery REDC context for q */
+    int is_active;                /* 1 if CRT decryption is available */
+} rsa_4096_crt_t;
+
+/**
+ * @brief How a key's operations are computed
+ */
+typedef enum {
+    RSA_4096_PATH_NONE = 0,          /* No plan (hand-built key): hybrid_mod_exp per call */
+    RSA_4096_PATH_TRADITIONAL,       /* bigint_mod_exp (even or small modulus) */
+    RSA_4096_PATH_MONTGOMERY,        /* montgomery_exp_recoded over the stored recoding */
+    RSA_4096_PATH_SHORT_EXP,         /* montgomery_exp_short, exponent of one limb */
+    RSA_4096_PATH_CONSTTIME,         /* montgomery_exp_consttime */
+    RSA_4096_PATH_CRT                /* Two half-size exponentiations and Garner recombination */
+} rsa_4096_exp_path_t;
+
+/**
+ * @brief Per-key exponentiation plan: everything that depends only on the key
+ * 
+ * rsa_4096_load_* fill it in once, so encryption and decryption go
+ * straight to the chosen algorithm with the exponents already recoded.
+ */
+typedef struct {
+    rsa_4096_exp_path_t public_path;     /* Encryption: m^e mod n */
+    rsa_4096_exp_path_t private_path;    /* Decryption */
+    int modulus_bits;
+    bigint_word_t short_exponent;        /* Exponent for RSA_4096_PATH_SHORT_EXP, else 0 */
+    montgomery_exp_recoding_t exponent;  /* Recoded key exponent (Montgomery paths) */
+    montgomery_exp_recoding_t dp, dq;    /* Recoded CRT exponents (variable-time CRT) */
+} rsa_4096_exp_plan_t;
+
+/* Blinding pairs are squared after each use and regenerated from fresh randomness every REFRESH uses */
+#ifndef RSA_4096_BLINDING_REFRESH
+#define RSA_4096_BLINDING_REFRESH 32
+#endif
+#ifndef RSA_4096_BLINDING_SLOTS
+#define RSA_4096_BLINDING_SLOTS 4         /* Keys each thread keeps a blinding pair for */
+#endif
+
 /**
  * @brief RSA key structure
  */
 typedef struct {
     bigint_t n;                    /* Modulus */
-    bigint_t exponent;            /* Public or private exponent */
+    bigint_t exponent;            /* Public or private exponent (may be zero for CRT-only keys) */
     montgomery_ctx_t mont_ctx;    /* Montgomery REDC context */
     int is_private;               /* 0 = public key, 1 = private key */
+    rsa_4096_crt_t crt;           /* CRT components - used by decryption when crt.is_active */
+    int constant_time;            /* 1 = private-key exponentiation uses montgomery_exp_consttime */
+    int blinding;                 /* 1 = private operations run on c * r^e and are unblinded by r^(-1) */
+    bigint_t blinding_e;          /* Public exponent for r^e, or zero to derive pairs through d */
+    rsa_4096_exp_plan_t plan;     /* Built at load time, read-only afterwards */
 } rsa_4096_key_t;
 
+/**
+ * @brief One message or ciphertext in a batch call (big-endian buffers)
+ */
+typedef struct {
+    const uint8_t *input;         /* Message (encrypt) or ciphertext (decrypt) */
+    size_t input_size;
+    uint8_t *output;              /* Caller-owned result buffer */
+    size_t output_buffer_size;
+    size_t output_size;           /* Bytes written on success */
+    int status;                   /* 0 on success, negative error code for this item */
+} rsa_4096_batch_item_t;
+
+/* ===================== WORKER POOL ===================== */
+
+#ifndef RSA_4096_POOL_MAX_THREADS
+#define RSA_4096_POOL_MAX_THREADS 256
+#endif
+#ifndef RSA_4096_POOL_STACK_SIZE
+/* Worker stack for the bigint_t locals; limb workspaces come from each thread's scratch arena */
+#define RSA_4096_POOL_STACK_SIZE (1024 * 1024)
+#endif
+#define RSA_4096_POOL_DEQUE_INITIAL 64
+
+typedef struct rsa_4096_pool rsa_4096_pool_t;
+
+typedef enum {
+    RSA_4096_OP_ENCRYPT = 0,
+    RSA_4096_OP_DECRYPT = 1
+} rsa_4096_op_t;
+
+/* Runs on the worker thread once item->status and item->output are final */
+typedef void (*rsa_4096_job_callback_t)(void *user, rsa_4096_batch_item_t *item);
+
+/* Free-form work for rsa_4096_pool_run */
+typedef void (*rsa_4096_task_fn_t)(void *arg);
+
+/**
+ * @brief Completion handle for one pool submission (caller-owned)
+ */
+typedef struct {
+    rsa_4096_pool_t *pool;
+    size_t remaining;             /* Items not yet finished (updated atomically) */
+    size_t failed;                /* Finished items with non-zero status */
+} rsa_4096_future_t;
+
+/* ===================== ASYNC OPERATIONS ===================== */
+
+/*
+ * Two ways to keep an event loop responsive while RSA operations run:
+ * - rsa_4096_async_submit hands items to a worker pool and posts one
+ *   completion per submission to a completion queue. The queue's file
+ *   descriptor is readable while completions are waiting, so it sits in
+ *   the loop's poll/epoll/select set next to its sockets.
+ * - rsa_4096_job_start/rsa_4096_job_step run one item on the calling
+ *   thread in slices of about max_bits exponent bits (cooperative mode).
+ */
+
+typedef struct rsa_4096_cq rsa_4096_cq_t;
+
+/**
+ * @brief One finished submission, as returned by rsa_4096_cq_poll and rsa_4096_cq_wait
+ */
+typedef struct {
+    void *token;                  /* Completion token passed to rsa_4096_async_submit */
+    rsa_4096_batch_item_t *items; /* The submitted items, status and output final */
+    size_t count;
+    size_t failed;                /* Items with non-zero status */
+} rsa_4096_completion_t;
+
+/* rsa_4096_job_t stages */
+#define RSA_4096_JOB_FULL 0       /* One exponentiation modulo n */
+#define RSA_4096_JOB_P    1       /* CRT half modulo p, then RSA_4096_JOB_Q */
+#define RSA_4096_JOB_Q    2
+#define RSA_4096_JOB_DONE 3
+
+/**
+ * @brief One encrypt or decrypt run cooperatively (caller-allocated)
+ * 
+ * The exponentiation state points into the job itself: do not copy or
+ * move a job between rsa_4096_job_start and its final step.
+ */
+typedef struct {
+    const rsa_4096_key_t *key;
+    rsa_4096_batch_item_t *item;
+    rsa_4096_exp_path_t path;
+    int stage;                    /* RSA_4096_JOB_* */
+    int blinded;                  /* input carries a blinding factor, removed with unblind */
+    bigint_t input;               /* Parsed input, blinded when the key asks for it */
+    bigint_t unblind;
+    bigint_t m1;                  /* CRT: finished half modulo p */
+    montgomery_exp_recoding_t rec;  /* Recoding made for exponents the plan carries none for */
+    montgomery_exp_job_t exp;
+} rsa_4096_job_t;
+
 /* ===================== DEBUG UTILITIES ===================== */
 
 void debug_print_bigint(const char *name, const bigint_t *a);
@@ -146,16 +553,27 @@ int bigint_bit_length(const bigint_t *a);
 int bigint_add(bigint_t *r, const bigint_t *a, const bigint_t *b);
 int bigint_sub(bigint_t *r, const bigint_t *a, const bigint_t *b);
 int bigint_mul(bigint_t *r, const bigint_t *a, const bigint_t *b);
+int bigint_square(bigint_t *r, const bigint_t *a);
 int bigint_div(bigint_t *q, bigint_t *r, const bigint_t *a, const bigint_t *b);
 int bigint_mod(bigint_t *r, const bigint_t *a, const bigint_t *m);
 
+/* Double-width products and their reduction */
+void bigint_wide_init(bigint_wide_t *a);
+void bigint_wide_from(bigint_wide_t *dst, const bigint_t *src);
+int bigint_mul_wide(bigint_wide_t *r, const bigint_t *a, const bigint_t *b);
+int bigint_square_wide(bigint_wide_t *r, const bigint_t *a);
+int bigint_mod_wide(bigint_t *r, const bigint_wide_t *a, const bigint_t *m);
+
 /* Extended arithmetic for Montgomery - FIXED */
-int bigint_mul_add_word(bigint_t *result, const bigint_t *a, uint32_t b, uint32_t c);
-int bigint_add_word(bigint_t *result, const bigint_t *a, uint32_t word);
+int bigint_mul_add_word(bigint_t *result, const bigint_t *a, bigint_word_t b, bigint_word_t c);
+int bigint_add_word(bigint_t *result, const bigint_t *a, bigint_word_t word);
 
 /* Modular arithmetic - FIXED */
 int bigint_mod_exp(bigint_t *result, const bigint_t *base, const bigint_t *exp, const bigint_t *mod);
 int mod_inverse_extended_gcd(bigint_t *result, const bigint_t *a, const bigint_t *m);
+/* Binary extended GCD; vartime accepts an even m when a is odd, consttime needs an odd m */
+int mod_inverse_vartime(bigint_t *result, const bigint_t *a, const bigint_t *m);
+int mod_inverse_consttime(bigint_t *result, const bigint_t *a, const bigint_t *m);
 
 /* ===================== HYBRID ALGORITHM SELECTION - TERRANTSH MODEL ===================== */
 
@@ -163,9 +581,10 @@ int mod_inverse_extended_gcd(bigint_t *result, const bigint_t *a, const bigint_t
  * @brief Hybrid modular exponentiation with intelligent algorithm selection
  * 
  * This function implements a hybrid approach referencing the Terrantsh RSA4096 model:
- * - Automatically chooses between Montgomery REDC and traditional modular exponentiation
- * - Falls back to traditional algorithm (like terrantsh/RSA4096) if Montgomery is not suitable
- * - Considers modulus size, buffer capacity, and runtime conditions for optimal performance
+ * - Uses the Montgomery kernels when the context's cached dispatch decision allows
+ *   it and the context belongs to modulus (short-exponent kernel for one-limb exponents)
+ * - Falls back to traditional algorithm (like terrantsh/RSA4096) otherwise, or if
+ *   the Montgomery kernel fails
  * 
  * @param result Output: result of base^exp mod modulus
  * @param base Input base
@@ -176,6 +595,10 @@ int mod_inverse_extended_gcd(bigint_t *result, const bigint_t *a, const bigint_t
  */
 int hybrid_mod_exp(bigint_t *result, const bigint_t *base, const bigint_t *exp, 
                    const bigint_t *modulus, const montgomery_ctx_t *mont_ctx);
+int hybrid_uses_montgomery(const montgomery_ctx_t *mont_ctx, const bigint_t *modulus);
+int hybrid_set_montgomery_min_bits(int bits);
+int hybrid_get_montgomery_min_bits(void);
+int hybrid_calibrate(void);
 
 /* ===================== MONTGOMERY REDC OPERATIONS - FIXED ===================== */
 
@@ -184,8 +607,22 @@ int montgomery_ctx_init(montgomery_ctx_t *ctx, const bigint_t *modulus);
 void montgomery_ctx_free(montgomery_ctx_t *ctx);
 void montgomery_ctx_print_info(const montgomery_ctx_t *ctx);
 
+/* Kernels specialized at compile time for 512/1024/1536/2048/3072/4096-bit moduli
+ * (on by default); disabling them routes every size through the generic loops */
+void montgomery_set_fixed_kernels(int enable);
+int montgomery_get_fixed_kernels(void);
+int montgomery_fixed_kernel_bits(int n_words);
+
+/* Context serialization: store a precomputed context next to the key, restore without recomputation */
+#define MONTGOMERY_CTX_MAGIC       "RMC1"
+#define MONTGOMERY_CTX_HEADER_SIZE 12  /* magic[4], word bits, 3 reserved, n_words (u32 LE) */
+#define MONTGOMERY_CTX_BLOB_MAX    (MONTGOMERY_CTX_HEADER_SIZE + (1 + 2 * BIGINT_4096_WORDS) * BIGINT_WORD_BYTES)
+size_t montgomery_ctx_serialized_size(const montgomery_ctx_t *ctx);
+int montgomery_ctx_export(const montgomery_ctx_t *ctx, uint8_t *out, size_t out_size, size_t *written);
+int montgomery_ctx_import(montgomery_ctx_t *ctx, const bigint_t *modulus, const uint8_t *in, size_t in_size);
+
 /* Core Montgomery REDC algorithm - FIXED */
-int montgomery_redc(bigint_t *result, const bigint_t *T, const montgomery_ctx_t *ctx);
+int montgomery_redc(bigint_t *result, const bigint_wide_t *T, const montgomery_ctx_t *ctx);
 
 /* Montgomery arithmetic operations - FIXED */
 int montgomery_to_form(bigint_t *result, const bigint_t *a, const montgomery_ctx_t *ctx);
@@ -193,6 +630,101 @@ int montgomery_from_form(bigint_t *result, const bigint_t *a, const montgomery_c
 int montgomery_mul(bigint_t *result, const bigint_t *a, const bigint_t *b, const montgomery_ctx_t *ctx);
 int montgomery_square(bigint_t *result, const bigint_t *a, const montgomery_ctx_t *ctx);
 int montgomery_exp(bigint_t *result, const bigint_t *base, const bigint_t *exp, const montgomery_ctx_t *ctx);
+/* Public-exponent fast path: e fits one limb (65537 = 16 squarings + 1 multiply) */
+int montgomery_exp_short(bigint_t *result, const bigint_t *base, bigint_word_t e, const montgomery_ctx_t *ctx);
+/* Sliding-window exponentiation; recode once and reuse for a fixed exponent */
+int montgomery_exp_recode(montgomery_exp_recoding_t *rec, const bigint_t *exp, int window_bits);
+int montgomery_exp_recoded(bigint_t *result, const bigint_t *base, const montgomery_exp_recoding_t *rec,
+                           const montgomery_ctx_t *ctx);
+int montgomery_exp_window(bigint_t *result, const bigint_t *base, const bigint_t *exp,
+                          const montgomery_ctx_t *ctx, int window_bits);
+int montgomery_window_bits_for_exponent(int exp_bits);
+int montgomery_exp_consttime(bigint_t *result, const bigint_t *base, const bigint_t *exp,
+                             const montgomery_ctx_t *ctx, int window_bits);
+/* Resumable exponentiation: init, step until it returns 1 (step bits ~ squarings), then finish */
+int montgomery_exp_job_init(montgomery_exp_job_t *job, const bigint_t *base, const montgomery_exp_recoding_t *rec,
+                            const montgomery_ctx_t *ctx);
+int montgomery_exp_job_init_consttime(montgomery_exp_job_t *job, const bigint_t *base, const bigint_t *exp,
+                                      const montgomery_ctx_t *ctx);
+int montgomery_exp_job_step(montgomery_exp_job_t *job, int max_bits);
+int montgomery_exp_job_finish(montgomery_exp_job_t *job, bigint_t *result);
+int montgomery_mod(bigint_t *result, const bigint_t *a, const montgomery_ctx_t *ctx);
+/* Fixed-base exponentiation: build a comb for a base once, then exponentiate with many exponents */
+size_t montgomery_comb_table_size(int max_exp_bits, int teeth, int blocks, const montgomery_ctx_t *ctx);
+int montgomery_comb_init(montgomery_comb_t *comb, const bigint_t *base, int max_exp_bits,
+                         int teeth, int blocks, const montgomery_ctx_t *ctx);
+void montgomery_comb_free(montgomery_comb_t *comb);
+int montgomery_exp_comb(bigint_t *result, const montgomery_comb_t *comb, const bigint_t *exp,
+                        const montgomery_ctx_t *ctx);
+
+/* ===================== MULTI-BUFFER MONTGOMERY ENGINE ===================== */
+
+#define RSA_4096_SIMD_MAX_LANES  8
+#define RSA_4096_SIMD_WINDOW_MAX 5   /* Caps the lane-interleaved odd-power table at 16 entries */
+
+typedef enum {
+    RSA_4096_SIMD_SCALAR = 0,        /* montgomery_exp per base */
+    RSA_4096_SIMD_AVX2 = 1,          /* 4 lanes, radix 2^29 */
+    RSA_4096_SIMD_AVX512_IFMA = 2    /* 8 lanes, radix 2^52 */
+} rsa_4096_simd_kernel_t;
+
+/* Kernel selection: detected from the CPU on first use, overridable */
+int rsa_4096_simd_supported(rsa_4096_simd_kernel_t kernel);
+rsa_4096_simd_kernel_t rsa_4096_simd_kernel(void);
+int rsa_4096_simd_set_kernel(rsa_4096_simd_kernel_t kernel);
+const char *rsa_4096_simd_kernel_name(rsa_4096_simd_kernel_t kernel);
+int rsa_4096_simd_lanes(rsa_4096_simd_kernel_t kernel);
+
+/* results[i] = bases[i]^exp mod n, one modulus and exponent, lanes in lockstep */
+int montgomery_exp_multi(bigint_t *results, const bigint_t *bases, int count,
+                         const bigint_t *exp, const montgomery_ctx_t *ctx);
+
+/* ===================== STREAMING ===================== */
+
+/*
+ * Stream block format: the plaintext is cut into blocks of k - 2 bytes,
+ * where k is the modulus length in bytes; only the last block may be
+ * shorter. Each block D is encrypted as the integer 0x01 || D, which is
+ * always below n, and written as exactly k big-endian ciphertext bytes. The
+ * 0x01 marker keeps leading zero bytes and the length of the last block.
+ * This is raw RSA on each block, with no randomized padding.
+ */
+#define RSA_4096_STREAM_BLOCK_MAX (BIGINT_MAX_BITS / 8)
+
+/* Receives each group of output blocks; non-zero return aborts the stream */
+typedef int (*rsa_4096_stream_sink_t)(void *user, const uint8_t *data, size_t len);
+
+/**
+ * @brief Caller-owned memory for rsa_4096_stream_buffer_sink
+ */
+typedef struct {
+    uint8_t *data;
+    size_t capacity;
+    size_t size;                  /* Bytes written so far */
+} rsa_4096_stream_buffer_t;
+
+/**
+ * @brief Streaming encryption/decryption state (caller-allocated, fixed size)
+ * 
+ * Up to RSA_4096_SIMD_MAX_LANES blocks are gathered and run through the
+ * batch engine together, so memory stays bounded whatever the input size.
+ */
+typedef struct {
+    const rsa_4096_key_t *key;
+    rsa_4096_op_t op;
+    rsa_4096_exp_path_t path;
+    size_t modulus_bytes;         /* k: size of one ciphertext block */
+    size_t data_bytes;            /* k - 2: plaintext bytes per block */
+    rsa_4096_stream_sink_t sink;
+    void *sink_user;
+    uint64_t bytes_in, bytes_out, blocks;
+    int error;                    /* Sticky: first failure, returned by later calls */
+    int ready;                    /* Blocks waiting in inputs */
+    size_t partial_size;
+    uint8_t partial[RSA_4096_STREAM_BLOCK_MAX];
+    bigint_t inputs[RSA_4096_SIMD_MAX_LANES];
+    uint8_t output[RSA_4096_SIMD_MAX_LANES * RSA_4096_STREAM_BLOCK_MAX];
+} rsa_4096_stream_t;
 
 /* ===================== RSA OPERATIONS ===================== */
 
@@ -202,6 +734,27 @@ void rsa_4096_free(rsa_4096_key_t *key);
 int rsa_4096_load_key(rsa_4096_key_t *key, const char *n_decimal, const char *e_decimal, int is_private);
 int rsa_4096_load_key_binary(rsa_4096_key_t *key, const uint8_t *n_data, size_t n_size,
                             const uint8_t *e_data, size_t e_size, int is_private);
+/* (Re)build the exponentiation plan; the loaders call it, call it again after editing key fields by hand */
+int rsa_4096_key_prepare(rsa_4096_key_t *key);
+
+/* Constant-time private-key exponentiation (off by default): fixed window, masked table reads */
+void rsa_4096_set_constant_time(rsa_4096_key_t *key, int enable);
+
+/* Blinded private operations (off by default); the pairs live per thread, keyed by modulus.
+ * public_exponent NULL derives each fresh pair with one extra private exponentiation. */
+int rsa_4096_set_blinding(rsa_4096_key_t *key, int enable, const bigint_t *public_exponent);
+/* Bytes from the operating system's CSPRNG */
+int rsa_4096_random_bytes(uint8_t *buf, size_t len);
+
+/* CRT private key loading: n = p * q, decryption uses two half-size exponentiations */
+int rsa_4096_load_crt_key(rsa_4096_key_t *key, const char *p_decimal, const char *q_decimal,
+                          const char *dp_decimal, const char *dq_decimal, const char *qinv_decimal);
+int rsa_4096_load_crt_key_binary(rsa_4096_key_t *key, const uint8_t *p_data, size_t p_size,
+                                 const uint8_t *q_data, size_t q_size,
+                                 const uint8_t *dp_data, size_t dp_size,
+                                 const uint8_t *dq_data, size_t dq_size,
+                                 const uint8_t *qinv_data, size_t qinv_size);
+int rsa_4096_crt_decrypt_bigint(bigint_t *result, const bigint_t *ciphertext, const rsa_4096_key_t *priv_key);
 
 /* Encryption/Decryption */
 int rsa_4096_encrypt(const rsa_4096_key_t *pub_key, const char *message_decimal,
@@ -215,11 +768,135 @@ int rsa_4096_decrypt_binary(const rsa_4096_key_t *priv_key, const uint8_t *encry
                            size_t encrypted_size, uint8_t *message, size_t message_buffer_size,
                            size_t *message_size);
 
+/* Batch operations: one key check and algorithm choice for many same-key items.
+ * Return 0 when every item succeeded, -6 when some failed (see item status). */
+int rsa_4096_encrypt_batch(const rsa_4096_key_t *pub_key, rsa_4096_batch_item_t *items, size_t count);
+int rsa_4096_decrypt_batch(const rsa_4096_key_t *priv_key, rsa_4096_batch_item_t *items, size_t count);
+
+/* Streaming: init, update any number of times, final; output goes to the sink group by group */
+int rsa_4096_stream_init(rsa_4096_stream_t *stream, const rsa_4096_key_t *key, rsa_4096_op_t op,
+                         rsa_4096_stream_sink_t sink, void *sink_user);
+int rsa_4096_stream_update(rsa_4096_stream_t *stream, const uint8_t *data, size_t len);
+int rsa_4096_stream_final(rsa_4096_stream_t *stream);
+size_t rsa_4096_stream_output_size(const rsa_4096_stream_t *stream, size_t input_size);
+/* Built-in sinks: user is an rsa_4096_stream_buffer_t, or a pointer to an int file descriptor */
+int rsa_4096_stream_buffer_sink(void *user, const uint8_t *data, size_t len);
+int rsa_4096_stream_fd_sink(void *user, const uint8_t *data, size_t len);
+
+/* Work-stealing worker pool: keys are shared read-only, each item runs on one worker */
+int rsa_4096_pool_create(rsa_4096_pool_t **pool, int num_threads);
+void rsa_4096_pool_destroy(rsa_4096_pool_t *pool);
+int rsa_4096_pool_size(const rsa_4096_pool_t *pool);
+int rsa_4096_pool_submit(rsa_4096_pool_t *pool, rsa_4096_op_t op, const rsa_4096_key_t *key,
+                         rsa_4096_batch_item_t *items, size_t count,
+                         rsa_4096_job_callback_t callback, void *user, rsa_4096_future_t *future);
+int rsa_4096_pool_run(rsa_4096_pool_t *pool, rsa_4096_task_fn_t fn, void *arg, rsa_4096_future_t *future);
+int rsa_4096_pool_is_worker(const rsa_4096_pool_t *pool);
+int rsa_4096_future_wait(rsa_4096_future_t *future);
+int rsa_4096_future_done(const rsa_4096_future_t *future);
+
+/* Latency path: the two CRT halves of one decryption run concurrently on the caller and a pool worker */
+int rsa_4096_crt_decrypt_bigint_parallel(bigint_t *result, const bigint_t *ciphertext,
+                                         const rsa_4096_key_t *priv_key, rsa_4096_pool_t *pool);
+int rsa_4096_decrypt_binary_parallel(const rsa_4096_key_t *priv_key, rsa_4096_pool_t *pool,
+                                     const uint8_t *encrypted, size_t encrypted_size,
+                                     uint8_t *message, size_t message_buffer_size, size_t *message_size);
+
+/* Completion queue: rsa_4096_cq_fd is readable while completions are waiting */
+int rsa_4096_cq_create(rsa_4096_cq_t **cq);
+/* Waits for submissions still running, then drops completions nobody collected */
+void rsa_4096_cq_destroy(rsa_4096_cq_t *cq);
+int rsa_4096_cq_fd(const rsa_4096_cq_t *cq);
+size_t rsa_4096_cq_inflight(rsa_4096_cq_t *cq);
+/* Return up to max completions: poll never blocks, wait blocks up to timeout_ms (-1 = forever) */
+int rsa_4096_cq_poll(rsa_4096_cq_t *cq, rsa_4096_completion_t *out, size_t max);
+int rsa_4096_cq_wait(rsa_4096_cq_t *cq, rsa_4096_completion_t *out, size_t max, int timeout_ms);
+/* Run items on the pool; a single completion carrying token is posted once all have finished */
+int rsa_4096_async_submit(rsa_4096_cq_t *cq, rsa_4096_pool_t *pool, rsa_4096_op_t op, const rsa_4096_key_t *key,
+                          rsa_4096_batch_item_t *items, size_t count, void *token);
+
+/* Cooperative mode: step returns 1 once item->status is final, 0 while exponent bits remain */
+int rsa_4096_job_start(rsa_4096_job_t *job, rsa_4096_op_t op, const rsa_4096_key_t *key, rsa_4096_batch_item_t *item);
+int rsa_4096_job_step(rsa_4096_job_t *job, int max_bits);
+
+/* ===================== KEY STORE ===================== */
+
+/*
+ * Read-only key store: prepared rsa_4096_key_t records in their in-memory
+ * layout (limbs, Montgomery contexts, CRT parameters, recoded exponents),
+ * so opening a store is one mmap and a key is usable straight from the
+ * mapped pages, shared between every process that maps the file.
+ *
+ * File layout (host byte order, offsets multiple of RSA_4096_KEYSTORE_ALIGN):
+ *   header   rsa_4096_keystore_header_t, page 0
+ *   index    count entries sorted by id, mapping id -> record number
+ *   records  count records of record_stride bytes, one rsa_4096_key_t each
+ *
+ * A store only opens in a build with the same limb size, key struct size
+ * and layout fingerprint. RSA_4096_KEYSTORE_VERSION changes with the format.
+ */
+#define RSA_4096_KEYSTORE_MAGIC   "RSA4KST"  /* 8 bytes with the terminator */
+#define RSA_4096_KEYSTORE_VERSION 2
+#define RSA_4096_KEYSTORE_ALIGN   4096       /* Index and records start on page boundaries */
+#define RSA_4096_KEYSTORE_RECORD_ALIGN 64    /* Each record starts on its own cache line */
+
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t byte_order;          /* 0x01020304 as stored by the writing host */
+    uint32_t word_bits;           /* BIGINT_WORD_SIZE */
+    uint32_t bigint_words;        /* BIGINT_4096_WORDS */
+    uint32_t key_size;            /* sizeof(rsa_4096_key_t) */
+    uint32_t layout;              /* Fingerprint of the key and context field offsets */
+    uint64_t count;
+    uint64_t record_stride;       /* key_size rounded up to RSA_4096_KEYSTORE_RECORD_ALIGN */
+    uint64_t index_offset;
+    uint64_t records_offset;
+    uint64_t file_size;
+} rsa_4096_keystore_header_t;
+
+typedef struct {
+    uint64_t id;                  /* Caller's key identifier, unique within the store */
+    uint64_t record;              /* Record number */
+} rsa_4096_keystore_entry_t;
+
+/**
+ * @brief An open key store; read-only, so any number of threads may look keys up
+ */
+typedef struct {
+    const uint8_t *map;
+    size_t map_size;
+    const rsa_4096_keystore_entry_t *index;
+    const uint8_t *records;
+    size_t count;
+    size_t record_stride;
+} rsa_4096_keystore_t;
+
+/* ids NULL numbers the keys 0..count-1; the file is replaced atomically (written beside it, then renamed) */
+int rsa_4096_keystore_write(const char *path, const rsa_4096_key_t *const *keys, const uint64_t *ids, size_t count);
+int rsa_4096_keystore_open(rsa_4096_keystore_t *store, const char *path);
+void rsa_4096_keystore_close(rsa_4096_keystore_t *store);
+/* Keys point into the mapping: valid until close, never written through */
+int rsa_4096_keystore_get(const rsa_4096_keystore_t *store, size_t record, const rsa_4096_key_t **key);
+int rsa_4096_keystore_find(const rsa_4096_keystore_t *store, uint64_t id, const rsa_4096_key_t **key);
+
+/* ===================== KEY GENERATION ===================== */
+
+#define RSA_4096_KEYGEN_MIN_BITS  512
+#define RSA_4096_KEYGEN_DEFAULT_E 65537
+
+/* Sieved probable-prime search with Miller-Rabin at a 2^-128 error bound; p and q are
+ * searched at once by the caller and every pool worker (pool may be NULL) */
+int rsa_4096_keygen(rsa_4096_key_t *priv, rsa_4096_key_t *pub, int bits, const bigint_t *e, rsa_4096_pool_t *pool);
+/* 1 = probable prime, 0 = composite; rounds 0 picks the count for w's size */
+int rsa_4096_is_probable_prime(const bigint_t *w, int rounds);
+
 /* ===================== TESTING FUNCTIONS ===================== */
 
 int run_verification(void);
 int run_binary_verification(void);
 int run_benchmarks(void);
+int run_benchmark_suite(const char *json_path, double budget_ms);
 int test_large_rsa_keys(void);
 int run_manual_key_test(void);
 int test_real_rsa_4096(void);
@@ -227,6 +904,34 @@ int test_real_rsa_4096(void);
 /* Test hybrid algorithm selection */
 int test_hybrid_algorithm_selection(void);
 
+/* Test CRT private-key decryption against the plain c^d mod n path */
+int test_crt_decryption(void);
+
+/* Logging subsystem */
+int test_logging_subsystem(void);
+
+/* Batch encrypt/decrypt against the single-message API */
+int test_batch_operations(void);
+
+/* Worker pool results against the single-threaded batch API */
+int test_worker_pool(void);
+
+/* Multi-buffer Montgomery kernels against montgomery_exp */
+int test_simd_engine(void);
+int test_fixed_base_comb(void);
+int test_scratch_workspace(void);
+int test_conversions(void);
+int test_instrumentation(void);
+int test_mod_inverse(void);
+int test_blinding(void);
+int test_streaming(void);
+int test_fixed_kernels(void);
+int test_keystore(void);
+int test_async(void);
+int test_keygen(void);
+int test_short_exponent(void);
+int test_exponent_plan(void);
+
 /* TODO: Enhanced round-trip testing functions */
 int test_round_trip_comprehensive(void);
 int test_boundary_conditions(void);
@@ -238,6 +943,49 @@ int validate_all_algorithms_round_trip(void);
 
 int extended_gcd_full(bigint_t *result, const bigint_t *a, const bigint_t *m);
 
+/* ===================== LOW-LEVEL LIMB KERNELS ===================== */
+
+/* r[0..an+bn-1] = a[0..an-1] * b[0..bn-1] schoolbook (r must not alias a or b) */
+void bigint_limbs_mul(bigint_word_t *r, const bigint_word_t *a, int an, const bigint_word_t *b, int bn);
+/* r[0..2n-1] = a[0..n-1]^2 using symmetric partial products (r must not alias a) */
+void bigint_limbs_sqr(bigint_word_t *r, const bigint_word_t *a, int n);
+/* Same products, Karatsuba from the threshold up; scratch holds BIGINT_KARATSUBA_SCRATCH(max(an, bn)) limbs */
+void bigint_limbs_mul_karatsuba(bigint_word_t *r, const bigint_word_t *a, int an,
+                                const bigint_word_t *b, int bn, bigint_word_t *scratch);
+void bigint_limbs_sqr_karatsuba(bigint_word_t *r, const bigint_word_t *a, int n, bigint_word_t *scratch);
+int bigint_set_karatsuba_threshold(int mul_limbs, int sqr_limbs);
+int bigint_get_karatsuba_threshold(int square);
+
+/* ===================== SCRATCH WORKSPACE ===================== */
+
+/*
+ * Arithmetic temporaries (division buffers, Karatsuba scratch, window
+ * tables) come from a per-thread LIFO arena instead of the stack. Each
+ * thread gets a heap arena of BIGINT_WORKSPACE_DEFAULT_BYTES on first use;
+ * a thread may attach its own buffer instead. Scratch is never zero-filled.
+ * A request that does not fit falls back to malloc for that call.
+ */
+#ifndef BIGINT_WORKSPACE_DEFAULT_BYTES
+#define BIGINT_WORKSPACE_DEFAULT_BYTES (256 * 1024)  /* Widest multi-buffer window table plus headroom */
+#endif
+#define BIGINT_WORKSPACE_ALIGN 16
+
+typedef struct {
+    size_t capacity;              /* Arena bytes (0 until first use) */
+    size_t in_use;
+    size_t peak;                  /* High-water mark since the arena was set up */
+    size_t heap_fallbacks;        /* Requests that did not fit and went to malloc */
+    int external;                 /* Caller-supplied buffer attached */
+} bigint_workspace_stats_t;
+
+int bigint_workspace_attach(void *buffer, size_t bytes);
+int bigint_workspace_detach(void);
+void bigint_workspace_get_stats(bigint_workspace_stats_t *stats);
+/* Scratch for one call: release with the mark in reverse order of reservation */
+void *bigint_scratch_push(size_t bytes, size_t *mark);
+void bigint_scratch_pop(void *ptr, size_t mark);
+#define BIGINT_SCRATCH_LIMBS(n, mark) ((bigint_word_t *)bigint_scratch_push((size_t)(n) * sizeof(bigint_word_t), (mark)))
+
 /* ===================== NORMALIZATION FUNCTIONS - NEW ===================== */
 
 void bigint_normalize(bigint_t *a);
@@ -16,6 +16,136 @@
 
 /* ===================== FIXED MODULAR EXPONENTIATION ===================== */
 
+/**
+ * @brief Window table and product buffer for the sliding-window method (~9 KB,
+ * taken from the scratch arena rather than the stack)
+ */
+typedef struct {
+    bigint_t powers[16];
+    bigint_wide_t wide;
+} mod_exp_window_scratch_t;
+
+static int bigint_mod_exp_window(bigint_t *result, const bigint_t *base, const bigint_t *exp, const bigint_t *mod,
+                                 mod_exp_window_scratch_t *sc) {
+    /* Use 4-bit sliding window for very large exponents */
+    bigint_t temp_result, temp_base;
+    bigint_t *window_powers = sc->powers;
+    bigint_set_u32(&temp_result, 1);
+    
+    /* Reduce base mod modulus first */
+    int ret = bigint_mod(&temp_base, base, mod);
+    if (ret != 0) {
+        ERROR_RETURN(ret, "Failed to reduce base in sliding window method");
+    }
+    
+    /* TODO: Add normalization check after base reduction */
+    bigint_normalize(&temp_base);
+    
+    /* Precompute powers: base^0, base^1, ..., base^15 */
+    bigint_set_u32(&window_powers[0], 1);
+    bigint_copy(&window_powers[1], &temp_base);
+    
+    for (int i = 2; i < 16; i++) {
+        bigint_wide_t *temp_mult = &sc->wide;
+        ret = bigint_mul_wide(temp_mult, &window_powers[i-1], &temp_base);
+        if (ret != 0) {
+            ERROR_RETURN(ret, "Multiplication failed in window power precomputation");
+        }
+        
+        ret = bigint_mod_wide(&window_powers[i], temp_mult, mod);
+        if (ret != 0) {
+            ERROR_RETURN(ret, "Modular reduction failed in window power precomputation");
+        }
+        
+        /* TODO: Ensure proper normalization */
+        bigint_normalize(&window_powers[i]);
+    }
+    
+    CHECKPOINT(LOG_DEBUG, "[MOD_EXP_COMPLETE] Precomputed 16 window powers");
+    
+    /* Process exponent in 4-bit windows from MSB to LSB */
+    int exp_bits = bigint_bit_length(exp);
+    int processed_bits = 0;
+    
+    /* FIXED: Start with first non-zero window */
+    int started = 0;
+    for (int bit_pos = exp_bits - 1; bit_pos >= 0; bit_pos -= 4) {
+        /* Extract 4-bit window */
+        int window = 0;
+        int actual_bits = 0;
+        for (int j = 0; j < 4 && bit_pos - j >= 0; j++) {
+            /* Shift in MSB-first so a short final window keeps its true value */
+            window = (window << 1) | bigint_get_bit(exp, bit_pos - j);
+            actual_bits++;
+        }
+        
+        /* TODO: FIXME - Validate window extraction logic */
+        if (window < 0 || window >= 16) {
+            ERROR_RETURN(-10, "Invalid window value %d extracted", window);
+        }
+        
+        if (!started && window == 0) {
+            /* Skip leading zero windows */
+            continue;
+        }
+        
+        if (!started) {
+            /* First non-zero window: just set result to window power */
+            bigint_copy(&temp_result, &window_powers[window]);
+            started = 1;
+            /* TODO: Add validation after initial assignment */
+            bigint_normalize(&temp_result);
+        } else {
+            /* Square result for each bit in window */
+            for (int s = 0; s < actual_bits; s++) {
+                bigint_wide_t *temp_square = &sc->wide;
+                ret = bigint_square_wide(temp_square, &temp_result);
+                if (ret != 0) {
+                    ERROR_RETURN(ret, "Squaring failed in sliding window");
+                }
+                
+                ret = bigint_mod_wide(&temp_result, temp_square, mod);
+                if (ret != 0) {
+                    ERROR_RETURN(ret, "Modular reduction failed after squaring");
+                }
+                
+                /* TODO: Normalize after each operation */
+                bigint_normalize(&temp_result);
+            }
+            
+            /* Multiply by window power if window is non-zero */
+            if (window > 0) {
+                bigint_wide_t *temp_mult = &sc->wide;
+                ret = bigint_mul_wide(temp_mult, &temp_result, &window_powers[window]);
+                if (ret != 0) {
+                    ERROR_RETURN(ret, "Window multiplication failed");
+                }
+                
+                ret = bigint_mod_wide(&temp_result, temp_mult, mod);
+                if (ret != 0) {
+                    ERROR_RETURN(ret, "Final modular reduction failed in window");
+                }
+                
+                /* TODO: Ensure normalization */
+                bigint_normalize(&temp_result);
+            }
+        }
+        processed_bits += actual_bits;
+    }
+    
+    /* TODO: Final validation check */
+    if (!started) {
+        CHECKPOINT(LOG_INFO, "No non-zero windows found, result = 1");
+        bigint_set_u32(&temp_result, 1);
+    }
+    
+    bigint_copy(result, &temp_result);
+    bigint_normalize(result);
+    
+    CHECKPOINT(LOG_DEBUG, "[MOD_EXP_COMPLETE] Sliding window completed, processed %d bits", processed_bits);
+    return 0;
+}
+
 int bigint_mod_exp(bigint_t *result, const bigint_t *base, const bigint_t *exp, const bigint_t *mod) {
     if (result == NULL || base == NULL || exp == NULL || mod == NULL) {
         ERROR_RETURN(-1, "NULL pointer in bigint_mod_exp");
@@ -47,7 +177,7 @@ int bigint_mod_exp(bigint_t *result, const bigint_t *base, const bigint_t *exp,
         return 0;
     }
     
-    printf("[MOD_EXP_COMPLETE] Computing %d-word^%d-word mod %d-word\n", 
+    CHECKPOINT(LOG_DEBUG, "[MOD_EXP_COMPLETE] Computing %d-word^%d-word mod %d-word", 
            base->used, exp->used, mod->used);
     
     /* TODO: Add comprehensive input validation */
@@ -57,135 +187,18 @@ int bigint_mod_exp(bigint_t *result, const bigint_t *base, const bigint_t *exp,
     
     /* Optimized exponentiation with sliding window for large exponents */
     if (exp->used > 20) {
-        printf("[MOD_EXP_COMPLETE] Very large exponent (%d words), using 4-bit sliding window\n", exp->used);
-        
-        /* TODO: FIXME - Potential memory overflow in sliding window method */
-        /* Use 4-bit sliding window for very large exponents */
-        bigint_t temp_result, temp_base, window_powers[16];
-        bigint_set_u32(&temp_result, 1);
+        CHECKPOINT(LOG_DEBUG, "[MOD_EXP_COMPLETE] Very large exponent (%d words), using 4-bit sliding window", exp->used);
         
-        /* Reduce base mod modulus first */
-        int ret = bigint_mod(&temp_base, base, mod);
-        if (ret != 0) {
-            ERROR_RETURN(ret, "Failed to reduce base in sliding window method");
+        size_t mark;
+        mod_exp_window_scratch_t *sc = (mod_exp_window_scratch_t *)bigint_scratch_push(sizeof(*sc), &mark);
+        if (sc == NULL) {
+            ERROR_RETURN(-12, "Out of scratch memory for the window table");
         }
-        
-        /* TODO: Add normalization check after base reduction */
-        bigint_normalize(&temp_base);
-        
-        /* Precompute powers: base^0, base^1, ..., base^15 */
-        bigint_set_u32(&window_powers[0], 1);
-        bigint_copy(&window_powers[1], &temp_base);
-        
-        for (int i = 2; i < 16; i++) {
-            bigint_t temp_mult;
-            ret = bigint_mul(&temp_mult, &window_powers[i-1], &temp_base);
-            if (ret != 0) {
-                ERROR_RETURN(ret, "Multiplication failed in window power precomputation");
-            }
-            
-            /* TODO: Critical - validate intermediate results */
-            VALIDATE_OVERFLOW(&temp_mult, "window power multiplication");
-            
-            ret = bigint_mod(&window_powers[i], &temp_mult, mod);
-            if (ret != 0) {
-                ERROR_RETURN(ret, "Modular reduction failed in window power precomputation");
-            }
-            
-            /* TODO: Ensure proper normalization */
-            bigint_normalize(&window_powers[i]);
-        }
-        
-        printf("[MOD_EXP_COMPLETE] Precomputed 16 window powers\n");
-        
-        /* Process exponent in 4-bit windows from MSB to LSB */
-        int exp_bits = bigint_bit_length(exp);
-        int processed_bits = 0;
-        
-        /* FIXED: Start with first non-zero window */
-        int started = 0;
-        for (int bit_pos = exp_bits - 1; bit_pos >= 0; bit_pos -= 4) {
-            /* Extract 4-bit window */
-            int window = 0;
-            int actual_bits = 0;
-            for (int j = 0; j < 4 && bit_pos - j >= 0; j++) {
-                if (bigint_get_bit(exp, bit_pos - j)) {
-                    window |= (1 << (3 - j));
-                }
-                actual_bits++;
-            }
-            
-            /* TODO: FIXME - Validate window extraction logic */
-            if (window < 0 || window >= 16) {
-                ERROR_RETURN(-10, "Invalid window value %d extracted", window);
-            }
-            
-            if (!started && window == 0) {
-                /* Skip leading zero windows */
-                continue;
-            }
-            
-            if (!started) {
-                /* First non-zero window: just set result to window power */
-                bigint_copy(&temp_result, &window_powers[window]);
-                started = 1;
-                /* TODO: Add validation after initial assignment */
-                bigint_normalize(&temp_result);
-            } else {
-                /* Square result for each bit in window */
-                for (int s = 0; s < actual_bits; s++) {
-                    bigint_t temp_square;
-                    ret = bigint_mul(&temp_square, &temp_result, &temp_result);
-                    if (ret != 0) {
-                        ERROR_RETURN(ret, "Squaring failed in sliding window");
-                    }
-                    
-                    /* TODO: Critical overflow check */
-                    VALIDATE_OVERFLOW(&temp_square, "sliding window squaring");
-                    
-                    ret = bigint_mod(&temp_result, &temp_square, mod);
-                    if (ret != 0) {
-                        ERROR_RETURN(ret, "Modular reduction failed after squaring");
-                    }
-                    
-                    /* TODO: Normalize after each operation */
-                    bigint_normalize(&temp_result);
-                }
-                
-                /* Multiply by window power if window is non-zero */
-                if (window > 0) {
-                    bigint_t temp_mult;
-                    ret = bigint_mul(&temp_mult, &temp_result, &window_powers[window]);
-                    if (ret != 0) {
-                        ERROR_RETURN(ret, "Window multiplication failed");
-                    }
-                    
-                    /* TODO: Check intermediate result */
-                    VALIDATE_OVERFLOW(&temp_mult, "window power multiplication");
-                    
-                    ret = bigint_mod(&temp_result, &temp_mult, mod);
-                    if (ret != 0) {
-                        ERROR_RETURN(ret, "Final modular reduction failed in window");
-                    }
-                    
-                    /* TODO: Ensure normalization */
-                    bigint_normalize(&temp_result);
-                }
-            }
-            processed_bits += actual_bits;
-        }
-        
-        /* TODO: Final validation check */
-        if (!started) {
-            CHECKPOINT(LOG_INFO, "No non-zero windows found, result = 1");
-            bigint_set_u32(&temp_result, 1);
-        }
-        
-        bigint_copy(result, &temp_result);
-        bigint_normalize(result);
-        
-        printf("[MOD_EXP_COMPLETE] Sliding window completed, processed %d bits\n", processed_bits);
-        return 0;
+        RSA_4096_PHASE_BEGIN(loop_start);
+        int ret = bigint_mod_exp_window(result, base, exp, mod, sc);
+        if (ret == 0) RSA_4096_PHASE_END(RSA_4096_PHASE_EXP_LOOP, loop_start);
+        bigint_scratch_pop(sc, mark);
+        return ret;
     }
     
     /* Standard right-to-left binary method for smaller exponents */
@@ -206,9 +219,10 @@ int bigint_mod_exp(bigint_t *result, const bigint_t *base, const bigint_t *exp,
     
     /* Copy exponent for processing */
     bigint_copy(&temp_exp, exp);
+    RSA_4096_PHASE_BEGIN(loop_start);
     
-    printf("[MOD_EXP_COMPLETE] Starting right-to-left binary method\n");
-    printf("[MOD_EXP_COMPLETE] Base: %d words, Exp: %d words, Mod: %d words\n", 
+    CHECKPOINT(LOG_DEBUG, "[MOD_EXP_COMPLETE] Starting right-to-left binary method");
+    CHECKPOINT(LOG_DEBUG, "[MOD_EXP_COMPLETE] Base: %d words, Exp: %d words, Mod: %d words", 
            temp_base.used, temp_exp.used, mod->used);
     
     int bit_count = 0;
@@ -217,26 +231,23 @@ int bigint_mod_exp(bigint_t *result, const bigint_t *base, const bigint_t *exp,
         /* TODO: CRITICAL - Bit checking logic for round-trip correctness */
         if (temp_exp.words[0] & 1) {
             if (bit_count < 10 || bit_count % 50 == 0) {
-                printf("[MOD_EXP_COMPLETE] Bit %d is 1, multiplying result by base\n", bit_count);
+                CHECKPOINT(LOG_DEBUG, "[MOD_EXP_COMPLETE] Bit %d is 1, multiplying result by base", bit_count);
             }
             
             /* FIXME: Critical multiplication step - any error here corrupts round-trip */
-            bigint_t new_result, product;
+            bigint_t new_result;
+            bigint_wide_t product;
             bigint_init(&new_result);
-            bigint_init(&product);
             
             /* TODO: Add pre-multiplication validation */
             VALIDATE_OVERFLOW(&temp_result, "result before multiplication");
             VALIDATE_OVERFLOW(&temp_base, "base before multiplication");
             
-            ret = bigint_mul(&product, &temp_result, &temp_base);
+            ret = bigint_mul_wide(&product, &temp_result, &temp_base);
             if (ret != 0) {
                 ERROR_RETURN(ret, "Multiplication failed in binary method bit %d", bit_count);
             }
             
-            /* TODO: Critical - validate intermediate multiplication result */
-            VALIDATE_OVERFLOW(&product, "binary method multiplication");
-            
             /* TODO: Add manual verification for small values */
             if (temp_result.used == 1 && temp_base.used == 1 && 
                 temp_result.words[0] < 65536 && temp_base.words[0] < 65536) {
@@ -248,20 +259,20 @@ int bigint_mod_exp(bigint_t *result, const bigint_t *base, const bigint_t *exp,
                     computed_product = ((uint64_t)product.words[1] << 32) | product.words[0];
                 }
                 if (manual_product != computed_product) {
-                    printf("[ROUND_TRIP_DEBUG] CRITICAL: Multiplication mismatch at bit %d - manual=0x%llx, computed=0x%llx\n", 
+                    CHECKPOINT(LOG_ERROR, "[ROUND_TRIP_DEBUG] CRITICAL: Multiplication mismatch at bit %d - manual=0x%llx, computed=0x%llx", 
                            bit_count, (unsigned long long)manual_product, (unsigned long long)computed_product);
                 }
             }
             
             /* FIXME: Modular reduction critical for round-trip safety */
-            ret = bigint_mod(&new_result, &product, mod);
+            ret = bigint_mod_wide(&new_result, &product, mod);
             if (ret != 0) {
                 ERROR_RETURN(ret, "Modular reduction failed in binary method bit %d", bit_count);
             }
             
             /* TODO: Validate reduction correctness */
             if (bigint_compare(&new_result, mod) >= 0) {
-                printf("[ROUND_TRIP_DEBUG] ERROR: Reduction failed at bit %d - result >= modulus\n", bit_count);
+                CHECKPOINT(LOG_ERROR, "[ROUND_TRIP_DEBUG] ERROR: Reduction failed at bit %d - result >= modulus", bit_count);
                 ERROR_RETURN(-98, "Invalid modular reduction result");
             }
             
@@ -288,9 +299,9 @@ int bigint_mod_exp(bigint_t *result, const bigint_t *base, const bigint_t *exp,
         
         /* TODO: Add validation that shift produced expected result */
         if (temp_exp.used > 0 && new_exp.used > 0) {
-            uint32_t expected_msb = temp_exp.words[0] >> 1;
+            bigint_word_t expected_msb = temp_exp.words[0] >> 1;
             if (temp_exp.used == 1 && new_exp.used == 1 && new_exp.words[0] != expected_msb) {
-                printf("[ROUND_TRIP_DEBUG] WARNING: Shift result mismatch - expected 0x%x, got 0x%x\n", 
+                CHECKPOINT(LOG_ERROR, "[ROUND_TRIP_DEBUG] WARNING: Shift result mismatch - expected 0x" BIGINT_WORD_FMT ", got 0x" BIGINT_WORD_FMT, 
                        expected_msb, new_exp.words[0]);
             }
         }
@@ -304,19 +315,16 @@ int bigint_mod_exp(bigint_t *result, const bigint_t *base, const bigint_t *exp,
         /* Square the base for next iteration */
         /* TODO: FIXME - Base squaring critical for round-trip correctness */
         if (!bigint_is_zero(&temp_exp)) {
-            bigint_t squared_base, new_base;
-            bigint_init(&squared_base);
+            bigint_wide_t squared_base;
+            bigint_t new_base;
             bigint_init(&new_base);
             
-            /* FIXME: Multiplication overflow possible with large bases */
-            ret = bigint_mul(&squared_base, &temp_base, &temp_base);
+            /* Double-width square: no overflow for any base < mod */
+            ret = bigint_square_wide(&squared_base, &temp_base);
             if (ret != 0) {
                 ERROR_RETURN(ret, "Base squaring failed in binary method");
             }
             
-            /* TODO: Critical validation - check multiplication didn't overflow */
-            VALIDATE_OVERFLOW(&squared_base, "base squaring");
-            
             /* TODO: Add manual verification for small cases */
             if (temp_base.used == 1 && temp_base.words[0] < 65536) {
                 uint64_t manual_square = (uint64_t)temp_base.words[0] * temp_base.words[0];
@@ -327,20 +335,20 @@ int bigint_mod_exp(bigint_t *result, const bigint_t *base, const bigint_t *exp,
                     computed_square = ((uint64_t)squared_base.words[1] << 32) | squared_base.words[0];
                 }
                 if (manual_square != computed_square) {
-                    printf("[ROUND_TRIP_DEBUG] CRITICAL: Squaring mismatch - manual=0x%llx, computed=0x%llx\n", 
+                    CHECKPOINT(LOG_ERROR, "[ROUND_TRIP_DEBUG] CRITICAL: Squaring mismatch - manual=0x%llx, computed=0x%llx", 
                            (unsigned long long)manual_square, (unsigned long long)computed_square);
                 }
             }
             
             /* FIXME: Modular reduction critical - must not lose precision */
-            ret = bigint_mod(&new_base, &squared_base, mod);
+            ret = bigint_mod_wide(&new_base, &squared_base, mod);
             if (ret != 0) {
                 ERROR_RETURN(ret, "Base reduction failed in binary method");
             }
             
             /* TODO: Validate reduction preserved correctness */
             if (bigint_compare(&new_base, mod) >= 0) {
-                printf("[ROUND_TRIP_DEBUG] ERROR: Reduction failed - result >= modulus\n");
+                CHECKPOINT(LOG_ERROR, "[ROUND_TRIP_DEBUG] ERROR: Reduction failed - result >= modulus");
                 ERROR_RETURN(-99, "Modular reduction produced invalid result");
             }
             
@@ -365,14 +373,15 @@ int bigint_mod_exp(bigint_t *result, const bigint_t *base, const bigint_t *exp,
     bigint_copy(result, &temp_result);
     /* TODO: Final normalization */
     bigint_normalize(result);
+    RSA_4096_PHASE_END(RSA_4096_PHASE_EXP_LOOP, loop_start);
     
-    printf("[MOD_EXP_COMPLETE] Completed in %d iterations\n", bit_count);
+    CHECKPOINT(LOG_DEBUG, "[MOD_EXP_COMPLETE] Completed in %d iterations", bit_count);
     
     /* TODO: Add result validation */
     if (bigint_compare(result, mod) >= 0) {
         CHECKPOINT(LOG_ERROR, "WARNING: Result >= modulus after modular exponentiation");
-        debug_print_bigint("result", result);
-        debug_print_bigint("modulus", mod);
+        DEBUG_BIGINT("result", result);
+        DEBUG_BIGINT("modulus", mod);
     }
     
     return 0;
@@ -380,13 +389,13 @@ int bigint_mod_exp(bigint_t *result, const bigint_t *base, const bigint_t *exp,
 
 /* ===================== EXTENDED ARITHMETIC FOR MONTGOMERY - FIXED ===================== */
 
-int bigint_mul_add_word(bigint_t *result, const bigint_t *a, uint32_t b, uint32_t c) {
+int bigint_mul_add_word(bigint_t *result, const bigint_t *a, bigint_word_t b, bigint_word_t c) {
     if (result == NULL || a == NULL) {
         return -1;
     }
     
     bigint_init(result);
-    uint64_t carry = c;  /* Start with c */
+    bigint_dword_t carry = c;  /* Start with c */
     
     /* Compute a * b + c */
     int max_words = a->used + 2; /* Extra space for overflow */
@@ -395,21 +404,21 @@ int bigint_mul_add_word(bigint_t *result, const bigint_t *a, uint32_t b, uint32_
     }
     
     for (int i = 0; i < max_words && (i < a->used || carry > 0); i++) {
-        uint64_t word_product = 0;
+        bigint_dword_t word_product = 0;
         if (i < a->used) {
-            word_product = (uint64_t)a->words[i] * b;
+            word_product = (bigint_dword_t)a->words[i] * b;
         }
         
-        uint64_t sum = word_product + carry;
-        result->words[i] = (uint32_t)(sum & 0xFFFFFFFF);
-        carry = sum >> 32;
+        bigint_dword_t sum = word_product + carry;
+        result->words[i] = (bigint_word_t)sum;
+        carry = sum >> BIGINT_WORD_SIZE;
         
         result->used = i + 1;
     }
     
     /* FIXED: Handle remaining carry overflow */
     if (carry > 0 && result->used < BIGINT_4096_WORDS) {
-        result->words[result->used] = (uint32_t)carry;
+        result->words[result->used] = (bigint_word_t)carry;
         result->used++;
     } else if (carry > 0) {
         return -2;  /* Overflow - this is important for Montgomery */
@@ -419,7 +428,7 @@ int bigint_mul_add_word(bigint_t *result, const bigint_t *a, uint32_t b, uint32_
     return 0;
 }
 
-int bigint_add_word(bigint_t *result, const bigint_t *a, uint32_t word) {
+int bigint_add_word(bigint_t *result, const bigint_t *a, bigint_word_t word) {
     if (result == NULL || a == NULL) {
         return -1;
     }
@@ -432,22 +441,22 @@ int bigint_add_word(bigint_t *result, const bigint_t *a, uint32_t word) {
         return 0;
     }
     
-    uint64_t carry = word;
+    bigint_dword_t carry = word;
     int i = 0;
     
     /* FIXED: Propagate carry through all words */
     while (carry > 0 && i < BIGINT_4096_WORDS) {
-        uint64_t sum;
+        bigint_dword_t sum;
         if (i < result->used) {
-            sum = (uint64_t)result->words[i] + carry;
-            result->words[i] = (uint32_t)(sum & 0xFFFFFFFF);
+            sum = (bigint_dword_t)result->words[i] + carry;
+            result->words[i] = (bigint_word_t)sum;
         } else {
             /* Extend the number */
-            result->words[i] = (uint32_t)carry;
+            result->words[i] = (bigint_word_t)carry;
             result->used = i + 1;
             sum = carry;
         }
-        carry = sum >> 32;
+        carry = sum >> BIGINT_WORD_SIZE;
         i++;
     }
     
@@ -463,26 +472,140 @@ int bigint_add_word(bigint_t *result, const bigint_t *a, uint32_t word) {
 /* ===================== COMPLETE MODULAR INVERSE - FIXED ===================== */
 
 int mod_inverse_extended_gcd(bigint_t *result, const bigint_t *a, const bigint_t *m) {
-    /* Use the complete extended GCD implementation - NO CHANGES to algorithm */
-    return extended_gcd_full(result, a, m);
+    /* Operands here are public (e, moduli); secret ones go through mod_inverse_consttime */
+    return mod_inverse_vartime(result, a, m);
 }
 
 /* ===================== HYBRID ALGORITHM SELECTION - TERRANTSH MODEL ===================== */
 
+/*
+ * The selection rules (active context, odd modulus with room for R, size
+ * threshold) are evaluated once when a Montgomery context is built and
+ * cached in ctx->dispatch. A call then only checks that the context
+ * belongs to the modulus it was given.
+ */
+
+static int hybrid_montgomery_min_bits = HYBRID_MONTGOMERY_MIN_BITS;
+
+int hybrid_set_montgomery_min_bits(int bits) {
+    if (bits < 1 || bits > BIGINT_MAX_BITS) {
+        CHECKPOINT(LOG_ERROR, "Invalid Montgomery threshold: %d bits", bits);
+        return -1;
+    }
+    hybrid_montgomery_min_bits = bits;
+    return 0;
+}
+
+int hybrid_get_montgomery_min_bits(void) {
+    return hybrid_montgomery_min_bits;
+}
+
 /**
- * @brief Hybrid modular exponentiation with intelligent algorithm selection - ENHANCED WITH ROUND-TRIP VALIDATION
+ * @brief 1 if hybrid_mod_exp runs the Montgomery kernels for this context and modulus
+ */
+int hybrid_uses_montgomery(const montgomery_ctx_t *mont_ctx, const bigint_t *modulus) {
+    return mont_ctx != NULL && modulus != NULL && mont_ctx->is_active &&
+           mont_ctx->dispatch == MONTGOMERY_DISPATCH_MONTGOMERY &&
+           (modulus == &mont_ctx->n || bigint_compare(modulus, &mont_ctx->n) == 0);
+}
+
+#define HYBRID_CALIBRATION_REPEATS 5
+
+/**
+ * @brief Best-of-N nanoseconds for one exponentiation on either side of the dispatcher
+ */
+static uint64_t hybrid_calibration_time(int montgomery, const bigint_t *base, const bigint_t *exp,
+                                        const bigint_t *mod, const montgomery_ctx_t *ctx) {
+    uint64_t best = UINT64_MAX;
+    bigint_t r;
+    for (int i = 0; i < HYBRID_CALIBRATION_REPEATS; i++) {
+        uint64_t start = rsa_4096_stats_now_ns();
+        int ret = montgomery ? montgomery_exp(&r, base, exp, ctx) : bigint_mod_exp(&r, base, exp, mod);
+        uint64_t ns = rsa_4096_stats_now_ns() - start;
+        if (ret != 0) {
+            return UINT64_MAX;
+        }
+        if (ns < best) best = ns;
+    }
+    return best;
+}
+
+/**
+ * @brief Measure the traditional/Montgomery crossover and make it the threshold
+ * 
+ * Times full-length exponentiations on odd moduli from 16 to 512 bits; the
+ * threshold becomes the smallest size from which Montgomery wins at every
+ * larger size measured. If Montgomery loses even at 512 bits there is no
+ * crossover in range and the current threshold is left as it is.
+ * Contexts built before the call keep their decision.
+ * 
+ * @return the new threshold in bits, 0 if no crossover was found, negative on error
+ */
+int hybrid_calibrate(void) {
+    static const int sizes[] = { 16, 32, 48, 64, 96, 128, 192, 256, 384, 512 };
+    const int count = (int)(sizeof(sizes) / sizeof(sizes[0]));
+    int threshold = 0;
+    
+    for (int i = count - 1; i >= 0; i--) {
+        /* Deterministic odd modulus with exactly sizes[i] bits; base and exponent just below it */
+        bigint_t mod, base, exp, one;
+        bigint_init(&mod);
+        int words = (sizes[i] + BIGINT_WORD_SIZE - 1) / BIGINT_WORD_SIZE;
+        for (int w = 0; w < words; w++) {
+            mod.words[w] = (bigint_word_t)(0x9E3779B97F4A7C15ULL * (uint64_t)(w + 1));
+        }
+        int top_bits = sizes[i] - (words - 1) * BIGINT_WORD_SIZE;
+        if (top_bits < BIGINT_WORD_SIZE) {
+            mod.words[words - 1] &= ((bigint_word_t)1 << top_bits) - 1;
+        }
+        mod.words[words - 1] |= (bigint_word_t)1 << (top_bits - 1);
+        mod.words[0] |= 1;
+        mod.used = words;
+        bigint_set_u32(&one, 1);
+        bigint_sub(&exp, &mod, &one);
+        bigint_sub(&base, &exp, &one);
+        
+        montgomery_ctx_t ctx;
+        if (montgomery_ctx_init(&ctx, &mod) != 0 || !ctx.is_active) {
+            ERROR_RETURN(-1, "Calibration context for %d bits failed", sizes[i]);
+        }
+        uint64_t mont_ns = hybrid_calibration_time(1, &base, &exp, &mod, &ctx);
+        uint64_t trad_ns = hybrid_calibration_time(0, &base, &exp, &mod, &ctx);
+        if (mont_ns == UINT64_MAX || trad_ns == UINT64_MAX) {
+            ERROR_RETURN(-2, "Calibration exponentiation at %d bits failed", sizes[i]);
+        }
+        CHECKPOINT(LOG_INFO, "Calibration %d bits: Montgomery %" PRIu64 " ns, traditional %" PRIu64 " ns",
+                   sizes[i], mont_ns, trad_ns);
+        if (mont_ns >= trad_ns) {
+            break;
+        }
+        threshold = sizes[i];
+    }
+    
+    if (threshold == 0) {
+        CHECKPOINT(LOG_INFO, "No Montgomery crossover up to %d bits, threshold stays at %d bits",
+                   sizes[count - 1], hybrid_montgomery_min_bits);
+        return 0;
+    }
+    hybrid_montgomery_min_bits = threshold;
+    CHECKPOINT(LOG_INFO, "Montgomery threshold calibrated to %d bits", threshold);
+    return threshold;
+}
+
+/**
+ * @brief Hybrid modular exponentiation with intelligent algorithm selection
  * 
  * This implements a hybrid system referencing the Terrantsh RSA4096 model approach:
- * - Automatically chooses optimal algorithm based on modulus size and runtime conditions
- * - Uses Montgomery REDC for suitable cases (odd modulus, adequate buffer space)
- * - Falls back to traditional modular exponentiation (like terrantsh/RSA4096) when Montgomery is not optimal
- * - Provides comprehensive error handling and performance optimization
- * - Enhanced with round-trip validation and comprehensive logging
+ * - The Montgomery/traditional decision comes from the context (see hybrid_uses_montgomery)
+ * - One-limb exponents take the short-exponent kernel, longer ones the sliding window
+ * - Falls back to traditional modular exponentiation (like terrantsh/RSA4096) when Montgomery fails
+ * 
+ * Nothing is copied on the way: the Montgomery kernels write result only
+ * once they have succeeded, so the fallback still sees intact inputs when
+ * result aliases one of them, and both kernels return fully reduced values.
  */
 int hybrid_mod_exp(bigint_t *result, const bigint_t *base, const bigint_t *exp, 
                    const bigint_t *modulus, const montgomery_ctx_t *mont_ctx) {
-    
-    /* TODO: Critical input validation for round-trip safety */
     if (result == NULL || base == NULL || exp == NULL || modulus == NULL) {
         CHECKPOINT(LOG_ERROR, "hybrid_mod_exp: NULL pointer argument");
         return -1;
@@ -493,117 +616,39 @@ int hybrid_mod_exp(bigint_t *result, const bigint_t *base, const bigint_t *exp,
         return -2;
     }
     
-    /* TODO: Add validation for input ranges */
-    if (bigint_compare(base, modulus) >= 0) {
-        CHECKPOINT(LOG_ERROR, "WARNING: Base >= modulus in hybrid_mod_exp");
-        debug_print_bigint("base", base);
-        debug_print_bigint("modulus", modulus);
-    }
-    
-    CHECKPOINT(LOG_INFO, "Hybrid algorithm selection for %d-bit modulus", bigint_bit_length(modulus));
-    
-    /* TODO: Enhanced algorithm selection logic - Terrantsh model inspired */
-    int use_montgomery = 0;
-    const char *algorithm_choice = "traditional";
-    const char *reason = "default fallback";
-    
-    /* Check 1: Montgomery context availability and validation */
-    if (mont_ctx != NULL && mont_ctx->is_active) {
-        
-        /* TODO: Validate Montgomery context integrity */
-        if (mont_ctx->n_words <= 0 || mont_ctx->n_words > BIGINT_4096_WORDS) {
-            reason = "invalid Montgomery context parameters";
-        } else if (bigint_is_zero(&mont_ctx->n)) {
-            reason = "zero modulus in Montgomery context";
-        } else if (bigint_compare(&mont_ctx->n, modulus) != 0) {
-            reason = "Montgomery context modulus mismatch";
-        }
-        /* Check 2: Modulus must be odd (Montgomery requirement) */
-        else if ((modulus->words[0] & 1) == 1) {
-            
-            /* Check 3: Buffer capacity check with safety margins */
-            int modulus_bits = bigint_bit_length(modulus);
-            int required_words = (modulus_bits + 31) / 32;
-            
-            /* TODO: FIXME - Conservative buffer check to prevent overflow */
-            if (required_words <= BIGINT_4096_WORDS / 4) {  /* Use 1/4 of buffer as safety margin */
-                
-                /* Check 4: Performance threshold - Montgomery is better for larger modulus */
-                if (modulus_bits >= 512) {  /* 512+ bits favor Montgomery */
-                    use_montgomery = 1;
-                    algorithm_choice = "Montgomery REDC";
-                    reason = "optimal for large modulus";
-                } else if (modulus_bits >= 64) {  /* Medium size can use Montgomery */
-                    use_montgomery = 1;
-                    algorithm_choice = "Montgomery REDC";
-                    reason = "medium modulus Montgomery optimization";
-                } else {
-                    reason = "modulus too small for Montgomery efficiency";
-                }
-            } else {
-                reason = "insufficient buffer space for Montgomery intermediate results";
-            }
+    int ret;
+    if (hybrid_uses_montgomery(mont_ctx, modulus)) {
+        RSA_4096_STAT_ADD(RSA_4096_STAT_HYBRID_MONTGOMERY, 1);
+        if (exp->used <= 1) {
+            CHECKPOINT(LOG_INFO, "Algorithm selection: Montgomery short exponent");
+            ret = montgomery_exp_short(result, base, exp->used == 1 ? exp->words[0] : 0, mont_ctx);
         } else {
-            reason = "even modulus (Montgomery requires odd modulus)";
+            CHECKPOINT(LOG_INFO, "Algorithm selection: Montgomery sliding window");
+            ret = montgomery_exp(result, base, exp, mont_ctx);
         }
-    } else {
-        reason = "Montgomery context not available or inactive";
-    }
-    
-    CHECKPOINT(LOG_INFO, "Algorithm selection: %s (%s)", algorithm_choice, reason);
-    
-    /* TODO: Store original inputs for validation */
-    bigint_t original_base, original_exp, original_modulus;
-    bigint_copy(&original_base, base);
-    bigint_copy(&original_exp, exp);
-    bigint_copy(&original_modulus, modulus);
-    
-    /* Execute chosen algorithm with comprehensive error handling */
-    int ret;
-    if (use_montgomery) {
-        CHECKPOINT(LOG_INFO, "Executing Montgomery REDC exponentiation");
-        ret = montgomery_exp(result, base, exp, mont_ctx);
-        if (ret != 0) {
-            CHECKPOINT(LOG_ERROR, "Montgomery exponentiation failed (code %d), falling back to traditional", ret);
-            /* TODO: FIXME - Fallback to traditional method - Terrantsh model approach */
-            CHECKPOINT(LOG_INFO, "Fallback: Using traditional modular exponentiation (Terrantsh model)");
-            ret = bigint_mod_exp(result, &original_base, &original_exp, &original_modulus);
-            
-            if (ret != 0) {
-                ERROR_RETURN(ret, "Both Montgomery and traditional algorithms failed");
-            }
+        if (ret == 0) {
+            debug_verify_invariant("hybrid_mod_exp result", result, modulus);
+            return 0;
         }
+        CHECKPOINT(LOG_ERROR, "Montgomery exponentiation failed (code %d), falling back to traditional", ret);
+        RSA_4096_STAT_ADD(RSA_4096_STAT_HYBRID_FALLBACK, 1);
     } else {
-        CHECKPOINT(LOG_INFO, "Executing traditional modular exponentiation (Terrantsh model)");
-        ret = bigint_mod_exp(result, &original_base, &original_exp, &original_modulus);
+        CHECKPOINT(LOG_INFO, "Algorithm selection: traditional (%s)",
+                   mont_ctx == NULL || !mont_ctx->is_active ? "no active Montgomery context" :
+                   mont_ctx->dispatch == MONTGOMERY_DISPATCH_SMALL ? "modulus below the Montgomery threshold" :
+                   "context belongs to another modulus");
+        RSA_4096_STAT_ADD(RSA_4096_STAT_HYBRID_TRADITIONAL, 1);
     }
     
-    /* TODO: Final validation and result verification */
-    if (ret == 0) {
-        /* TODO: Add round-trip validation check */
-        if (bigint_compare(result, modulus) >= 0) {
-            CHECKPOINT(LOG_ERROR, "CRITICAL: Result >= modulus after hybrid exponentiation");
-            debug_print_bigint("result", result);
-            debug_print_bigint("modulus", modulus);
-            /* Try to fix by taking modulo again */
-            bigint_t corrected_result;
-            int fix_ret = bigint_mod(&corrected_result, result, modulus);
-            if (fix_ret == 0) {
-                bigint_copy(result, &corrected_result);
-                CHECKPOINT(LOG_INFO, "Result corrected by additional modular reduction");
-            } else {
-                ERROR_RETURN(-10, "Failed to correct invalid result");
-            }
-        }
-        
-        /* TODO: Normalize result */
-        bigint_normalize(result);
-        
-        CHECKPOINT(LOG_INFO, "Hybrid modular exponentiation completed successfully using %s", 
-                  use_montgomery ? "Montgomery REDC" : "traditional algorithm");
-    } else {
+    /* bigint_mod_exp reads the modulus after writing result; only that alias needs a copy */
+    bigint_t saved_modulus;
+    if (result == modulus) {
+        bigint_copy(&saved_modulus, modulus);
+        modulus = &saved_modulus;
+    }
+    ret = bigint_mod_exp(result, base, exp, modulus);
+    if (ret != 0) {
         CHECKPOINT(LOG_ERROR, "Hybrid modular exponentiation failed with code %d", ret);
     }
-    
     return ret;
 }
\ No newline at end of file
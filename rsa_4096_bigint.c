@@ -11,6 +11,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <stdint.h>
+#include <pthread.h>
 #include "rsa_4096.h"
 
 /* ===================== BASIC BIGINT OPERATIONS ===================== */
@@ -24,9 +25,12 @@ void bigint_init(bigint_t *a) {
 }
 
 void bigint_copy(bigint_t *dst, const bigint_t *src) {
-    if (dst && src) {
-        memcpy(dst->words, src->words, sizeof(src->words));
-        dst->used = src->used;
+    if (dst && src && dst != src) {
+        /* Only the significant limbs are read; the tail is cleared to keep limbs >= used zero */
+        int used = src->used < 0 ? 0 : (src->used > BIGINT_4096_WORDS ? BIGINT_4096_WORDS : src->used);
+        memcpy(dst->words, src->words, (size_t)used * sizeof(bigint_word_t));
+        memset(dst->words + used, 0, (size_t)(BIGINT_4096_WORDS - used) * sizeof(bigint_word_t));
+        dst->used = used;
         dst->sign = src->sign;
     }
 }
@@ -79,7 +83,7 @@ void bigint_normalize(bigint_t *a) {
     
     /* TODO: Log significant normalization changes */
     if (original_used != a->used && original_used - a->used > 1) {
-        printf("[ROUND_TRIP_DEBUG] Normalization: reduced from %d to %d words (removed %d leading zeros)\n", 
+        CHECKPOINT(LOG_DEBUG, "[ROUND_TRIP_DEBUG] Normalization: reduced from %d to %d words (removed %d leading zeros)", 
                original_used, a->used, original_used - a->used);
     }
     
@@ -98,7 +102,7 @@ void bigint_normalize(bigint_t *a) {
     /* TODO: Additional validation for single-word values */
     if (a->used == 1) {
         if (a->words[0] == 0 && a->sign != 0) {
-            printf("[ROUND_TRIP_DEBUG] WARNING: Zero value with non-zero sign, correcting\n");
+            CHECKPOINT(LOG_ERROR, "[ROUND_TRIP_DEBUG] WARNING: Zero value with non-zero sign, correcting");
             a->sign = 0;
         }
     }
@@ -106,7 +110,7 @@ void bigint_normalize(bigint_t *a) {
     /* TODO: Detect and warn about potential corruption */
     for (int i = a->used; i < BIGINT_4096_WORDS && i < a->used + 5; i++) {
         if (a->words[i] != 0) {
-            printf("[ROUND_TRIP_DEBUG] WARNING: Non-zero word at index %d beyond used=%d, value=0x%x\n", 
+            CHECKPOINT(LOG_ERROR, "[ROUND_TRIP_DEBUG] WARNING: Non-zero word at index %d beyond used=%d, value=0x" BIGINT_WORD_FMT, 
                    i, a->used, a->words[i]);
         }
     }
@@ -151,6 +155,70 @@ int bigint_ensure_capacity(bigint_t *a, int min_words) {
 
 /* ===================== STRING/BINARY CONVERSIONS - ENHANCED WITH ROUND-TRIP VALIDATION ===================== */
 
+/*
+ * Decimal conversion works a chunk of digits at a time: the largest power of ten that
+ * fits one limb (10^19 for 64-bit limbs, 10^9 for 32-bit limbs). Each chunk costs one
+ * single-limb multiply-add or divide pass over the value instead of a full bigint
+ * operation per digit.
+ */
+#if BIGINT_WORD_SIZE == 64
+#define DECIMAL_CHUNK_DIGITS 19
+#define DECIMAL_CHUNK_BASE   ((bigint_word_t)10000000000000000000ULL)
+#else
+#define DECIMAL_CHUNK_DIGITS 9
+#define DECIMAL_CHUNK_BASE   ((bigint_word_t)1000000000UL)
+#endif
+
+/* Enough for the largest bigint_t value in decimal, plus the terminator */
+#define DECIMAL_BUFFER_SIZE  ((BIGINT_4096_WORDS * BIGINT_WORD_SIZE * 31) / 100 + DECIMAL_CHUNK_DIGITS + 2)
+
+#define HEX_DIGITS_PER_WORD  (BIGINT_WORD_SIZE / 4)
+
+/**
+ * @brief words[0..*used) = words * mul + add; returns -1 if the carry overflows the bigint_t
+ */
+static int limbs_mul_add_small(bigint_word_t *words, int *used, bigint_word_t mul, bigint_word_t add) {
+    bigint_word_t carry = add;
+    for (int i = 0; i < *used; i++) {
+        bigint_dword_t t = (bigint_dword_t)words[i] * mul + carry;
+        words[i] = (bigint_word_t)t;
+        carry = (bigint_word_t)(t >> BIGINT_WORD_SIZE);
+    }
+    if (carry != 0) {
+        if (*used >= BIGINT_4096_WORDS) {
+            return -1;
+        }
+        words[(*used)++] = carry;
+    }
+    return 0;
+}
+
+/**
+ * @brief words[0..*used) /= div in place; returns the remainder and trims *used
+ */
+static bigint_word_t limbs_divmod_small(bigint_word_t *words, int *used, bigint_word_t div) {
+    bigint_word_t rem = 0;
+    for (int i = *used - 1; i >= 0; i--) {
+        bigint_dword_t t = ((bigint_dword_t)rem << BIGINT_WORD_SIZE) | words[i];
+        words[i] = (bigint_word_t)(t / div);
+        rem = (bigint_word_t)(t % div);
+    }
+    while (*used > 0 && words[*used - 1] == 0) {
+        (*used)--;
+    }
+    return rem;
+}
+
+/**
+ * @brief Reverse buf[0..len) into str, keeping the most significant digits if str is short
+ */
+static void emit_reversed_digits(const char *buf, size_t len, char *str, size_t str_size) {
+    size_t i = 0;
+    for (size_t pi = len; pi > 0 && i < str_size - 1; pi--, i++)
+        str[i] = buf[pi - 1];
+    str[i] = 0;
+}
+
 int bigint_from_decimal(bigint_t *a, const char *decimal) {
     /* TODO: Critical input validation */
     if (a == NULL) {
@@ -164,151 +232,168 @@ int bigint_from_decimal(bigint_t *a, const char *decimal) {
         return 0;
     }
     
-    size_t len = strlen(decimal);
-    bigint_t ten;
-    bigint_set_u32(&ten, 10);
-    
-    for (size_t i = 0; i < len; ++i) {
-        if (decimal[i] < '0' || decimal[i] > '9') continue;
-        
-        uint32_t digit = decimal[i] - '0';
-        
-        /* a = a * 10 + digit */
-        bigint_t temp;
-        int ret = bigint_mul(&temp, a, &ten);
-        if (ret != 0) return ret;
-        
-        bigint_t digit_bigint;
-        bigint_set_u32(&digit_bigint, digit);
-        
-        ret = bigint_add(a, &temp, &digit_bigint);
-        if (ret != 0) return ret;
+    /* a = a * 10^k + chunk for every k digits; characters other than digits are skipped */
+    int used = 0;
+    bigint_word_t chunk = 0;
+    bigint_word_t scale = 1;
+    for (const char *c = decimal; ; c++) {
+        int end = (*c == '\0');
+        if (!end) {
+            if (*c < '0' || *c > '9') continue;
+            chunk = chunk * 10 + (bigint_word_t)(*c - '0');
+            scale *= 10;
+        }
+        if ((end && scale > 1) || scale == DECIMAL_CHUNK_BASE) {
+            if (limbs_mul_add_small(a->words, &used, scale, chunk) != 0) {
+                CHECKPOINT(LOG_ERROR, "Decimal value exceeds %d words", BIGINT_4096_WORDS);
+                bigint_init(a);
+                return -2;
+            }
+            chunk = 0;
+            scale = 1;
+        }
+        if (end) break;
     }
     
+    a->used = used;
     bigint_normalize(a);
     return 0;
 }
 
 int bigint_to_decimal(const bigint_t *a, char *str, size_t str_size) {
+    if (!a || !str || str_size == 0) return -1;
+    
     if (bigint_is_zero(a)) {
-        if (str_size > 0) strcpy(str, "0");
+        strcpy(str, "0");
         return 0;
     }
     
     bigint_t x;
     bigint_copy(&x, a);
-    char buf[2048];
-    size_t p = 0; /* FIXED: Use size_t for proper comparison */
-    
-    bigint_t ten;
-    bigint_set_u32(&ten, 10);
-    
-    while (!bigint_is_zero(&x)) {
-        bigint_t q, r;
-        int ret = bigint_div(&q, &r, &x, &ten);
-        if (ret != 0) return ret;
-        
-        buf[p++] = '0' + (r.used ? r.words[0] : 0);
-        bigint_copy(&x, &q);
-        
-        if (p >= sizeof(buf) - 1) break;
+    int used = x.used;
+    char buf[DECIMAL_BUFFER_SIZE];
+    size_t p = 0;
+    
+    /* Peel one chunk per pass, least significant first; only the top chunk drops leading zeros */
+    while (used > 0) {
+        bigint_word_t r = limbs_divmod_small(x.words, &used, DECIMAL_CHUNK_BASE);
+        for (int k = 0; k < DECIMAL_CHUNK_DIGITS && (used > 0 || r != 0); k++) {
+            buf[p++] = (char)('0' + (int)(r % 10));
+            r /= 10;
+        }
     }
     
-    size_t i = 0;
-    /* FIXED: Proper size_t comparison */
-    for (size_t pi = p; pi > 0 && i < str_size - 1; pi--, i++)
-        str[i] = buf[pi - 1];
-    str[i] = 0;
+    emit_reversed_digits(buf, p, str, str_size);
     return 0;
 }
 
 int bigint_from_hex(bigint_t *a, const char *hex) {
+    if (a == NULL) {
+        CHECKPOINT(LOG_ERROR, "NULL bigint in bigint_from_hex");
+        return -1;
+    }
+    
     bigint_init(a);
     if (!hex || !*hex) return 0;
     
-    size_t len = strlen(hex);
-    bigint_t sixteen;
-    bigint_set_u32(&sixteen, 16);
-    
-    for (size_t i = 0; i < len; ++i) {
-        char c = hex[i];
-        uint32_t digit = 0;
-        if (c >= '0' && c <= '9') digit = c - '0';
-        else if (c >= 'a' && c <= 'f') digit = c - 'a' + 10;
-        else if (c >= 'A' && c <= 'F') digit = c - 'A' + 10;
+    /* Nibbles are placed straight into their limbs, scanning from the least significant end */
+    size_t nibble = 0;
+    for (size_t i = strlen(hex); i > 0; i--) {
+        char c = hex[i - 1];
+        bigint_word_t digit;
+        if (c >= '0' && c <= '9') digit = (bigint_word_t)(c - '0');
+        else if (c >= 'a' && c <= 'f') digit = (bigint_word_t)(c - 'a' + 10);
+        else if (c >= 'A' && c <= 'F') digit = (bigint_word_t)(c - 'A' + 10);
         else continue;
         
-        /* a = a * 16 + digit */
-        bigint_t temp;
-        int ret = bigint_mul(&temp, a, &sixteen);
-        if (ret != 0) return ret;
-        
-        bigint_t digit_bigint;
-        bigint_set_u32(&digit_bigint, digit);
-        
-        ret = bigint_add(a, &temp, &digit_bigint);
-        if (ret != 0) return ret;
+        size_t word_idx = nibble / HEX_DIGITS_PER_WORD;
+        if (word_idx >= BIGINT_4096_WORDS) {
+            if (digit != 0) {
+                CHECKPOINT(LOG_ERROR, "Hex value exceeds %d words", BIGINT_4096_WORDS);
+                bigint_init(a);
+                return -2;
+            }
+        } else {
+            a->words[word_idx] |= digit << (4 * (nibble % HEX_DIGITS_PER_WORD));
+        }
+        nibble++;
     }
     
+    size_t words = (nibble + HEX_DIGITS_PER_WORD - 1) / HEX_DIGITS_PER_WORD;
+    a->used = words > BIGINT_4096_WORDS ? BIGINT_4096_WORDS : (int)words;
     bigint_normalize(a);
     return 0;
 }
 
 int bigint_to_hex(const bigint_t *a, char *hex, size_t hex_size) {
+    if (!a || !hex || hex_size == 0) return -1;
+    
     if (bigint_is_zero(a)) {
-        if (hex_size > 0) strcpy(hex, "0");
+        strcpy(hex, "0");
         return 0;
     }
     
-    bigint_t x;
-    bigint_copy(&x, a);
-    char buf[2048];
-    size_t p = 0; /* FIXED: Use size_t for proper comparison */
-    
-    bigint_t sixteen;
-    bigint_set_u32(&sixteen, 16);
-    
-    while (!bigint_is_zero(&x)) {
-        bigint_t q, r;
-        int ret = bigint_div(&q, &r, &x, &sixteen);
-        if (ret != 0) return ret;
-        
-        uint32_t v = r.used ? r.words[0] : 0;
-        buf[p++] = (v < 10) ? ('0' + v) : ('a' + v - 10);
-        bigint_copy(&x, &q);
-        
-        if (p >= sizeof(buf) - 1) break;
-    }
+    static const char digits[] = "0123456789abcdef";
+    int used = a->used;
+    while (used > 1 && a->words[used - 1] == 0) used--;
     
+    /* Top limb without leading zeros, then every lower limb at full width */
     size_t i = 0;
-    /* FIXED: Proper size_t comparison */
-    for (size_t pi = p; pi > 0 && i < hex_size - 1; pi--, i++)
-        hex[i] = buf[pi - 1];
+    int started = 0;
+    for (int w = used - 1; w >= 0 && i < hex_size - 1; w--) {
+        for (int k = HEX_DIGITS_PER_WORD - 1; k >= 0 && i < hex_size - 1; k--) {
+            unsigned int v = (unsigned int)(a->words[w] >> (4 * k)) & 0xF;
+            if (!started && v == 0) continue;
+            started = 1;
+            hex[i++] = digits[v];
+        }
+    }
     hex[i] = 0;
     return 0;
 }
 
+/**
+ * @brief Load one limb from n <= BIGINT_WORD_BYTES big-endian bytes
+ */
+static inline bigint_word_t load_be_word(const uint8_t *p, size_t n) {
+    bigint_word_t w = 0;
+    for (size_t k = 0; k < n; k++) {
+        w = (w << 8) | p[k];
+    }
+    return w;
+}
+
+/**
+ * @brief Store the low n <= BIGINT_WORD_BYTES bytes of a limb big-endian
+ */
+static inline void store_be_word(uint8_t *p, bigint_word_t w, size_t n) {
+    for (size_t k = n; k > 0; k--) {
+        p[k - 1] = (uint8_t)w;
+        w >>= 8;
+    }
+}
+
 int bigint_from_binary(bigint_t *a, const uint8_t *data, size_t data_size) {
     bigint_init(a);
     if (!data || data_size == 0) return 0;
     
     /* Calculate required words */
-    int words_needed = (data_size + 3) / 4;
+    size_t words_needed = (data_size + BIGINT_WORD_BYTES - 1) / BIGINT_WORD_BYTES;
     if (words_needed > BIGINT_4096_WORDS) {
         return -1; /* Too large */
     }
     
-    /* Convert from big-endian bytes to little-endian words */
-    for (size_t i = 0; i < data_size; i++) {
-        int word_idx = (data_size - 1 - i) / 4;
-        int byte_idx = (data_size - 1 - i) % 4;
-        
-        if (word_idx < BIGINT_4096_WORDS) {
-            a->words[word_idx] |= ((uint32_t)data[i]) << (byte_idx * 8);
-        }
+    /* Whole big-endian limbs straight from the caller's buffer, least significant last */
+    const uint8_t *end = data + data_size;
+    size_t full = data_size / BIGINT_WORD_BYTES;
+    for (size_t w = 0; w < full; w++) {
+        a->words[w] = load_be_word(end - (w + 1) * BIGINT_WORD_BYTES, BIGINT_WORD_BYTES);
+    }
+    if (full < words_needed) {
+        a->words[full] = load_be_word(data, data_size - full * BIGINT_WORD_BYTES);
     }
     
-    a->used = words_needed;
+    a->used = (int)words_needed;
     bigint_normalize(a);
     return 0;
 }
@@ -326,17 +411,17 @@ int bigint_to_binary(const bigint_t *a, uint8_t *data, size_t data_size, size_t
     
     if (byte_len > data_size) return -2; /* Buffer too small */
     
-    /* Convert from little-endian words to big-endian bytes */
-    memset(data, 0, data_size);
-    
-    for (size_t i = 0; i < byte_len; i++) {
-        int word_idx = (byte_len - 1 - i) / 4;
-        int byte_idx = (byte_len - 1 - i) % 4;
-        
-        if (word_idx < a->used) {
-            data[i] = (a->words[word_idx] >> (byte_idx * 8)) & 0xFF;
-        }
+    /* Whole limbs are stored big-endian straight into the caller's buffer */
+    size_t full = byte_len / BIGINT_WORD_BYTES;
+    size_t top = byte_len - full * BIGINT_WORD_BYTES;
+    uint8_t *end = data + byte_len;
+    for (size_t w = 0; w < full; w++) {
+        store_be_word(end - (w + 1) * BIGINT_WORD_BYTES, a->words[w], BIGINT_WORD_BYTES);
     }
+    if (top > 0) {
+        store_be_word(data, (int)full < a->used ? a->words[full] : 0, top);
+    }
+    memset(data + byte_len, 0, data_size - byte_len);
     
     return 0;
 }
@@ -362,13 +447,13 @@ int bigint_shift_left(bigint_t *r, const bigint_t *a, int bits) {
     }
     
     /* Enhanced overflow protection */
-    if (bits > 32 * BIGINT_4096_WORDS) {
+    if (bits > BIGINT_WORD_SIZE * BIGINT_4096_WORDS) {
         CHECKPOINT(LOG_ERROR, "Shift amount too large: %d", bits);
         return -2;
     }
     
-    int word_shift = bits / 32;
-    int bit_shift = bits % 32;
+    int word_shift = bits / BIGINT_WORD_SIZE;
+    int bit_shift = bits % BIGINT_WORD_SIZE;
     
     /* Enhanced overflow protection */
     if (a->used + word_shift + (bit_shift ? 1 : 0) > BIGINT_4096_WORDS) {
@@ -388,19 +473,19 @@ int bigint_shift_left(bigint_t *r, const bigint_t *a, int bits) {
     
     /* Perform the shift with bounds checking */
     for (int i = temp.used - 1; i >= 0; i--) {
-        uint64_t val = (uint64_t)temp.words[i];
+        bigint_dword_t val = (bigint_dword_t)temp.words[i];
         
         /* Place the low part */
         int dest_idx = i + word_shift;
         if (dest_idx < BIGINT_4096_WORDS) {
-            r->words[dest_idx] |= (uint32_t)(val << bit_shift);
+            r->words[dest_idx] |= (bigint_word_t)(val << bit_shift);
         }
         
         /* Place the high part (carry) if bit_shift > 0 */
         if (bit_shift > 0) {
             dest_idx = i + word_shift + 1;
             if (dest_idx < BIGINT_4096_WORDS) {
-                r->words[dest_idx] |= (uint32_t)(val >> (32 - bit_shift));
+                r->words[dest_idx] |= (bigint_word_t)(val >> (BIGINT_WORD_SIZE - bit_shift));
             }
         }
     }
@@ -436,15 +521,15 @@ int bigint_shift_right(bigint_t *r, const bigint_t *a, int bits) {
     }
     
     /* FIXME: Handle very large shift amounts gracefully */
-    if (bits >= 32 * a->used) {
+    if (bits >= BIGINT_WORD_SIZE * a->used) {
         /* Shifting by more than the number of bits results in zero */
         CHECKPOINT(LOG_INFO, "Right shift amount %d >= bit length, result is zero", bits);
         bigint_init(r);
         return 0;
     }
     
-    int word_shift = bits / 32;
-    int bit_shift = bits % 32;
+    int word_shift = bits / BIGINT_WORD_SIZE;
+    int bit_shift = bits % BIGINT_WORD_SIZE;
     
     /* TODO: Enhanced bounds checking for right shift */
     if (word_shift >= a->used) {
@@ -457,19 +542,19 @@ int bigint_shift_right(bigint_t *r, const bigint_t *a, int bits) {
     
     /* Perform the shift with bounds checking */
     for (int i = word_shift; i < a->used; i++) {
-        uint64_t val = (uint64_t)a->words[i];
+        bigint_dword_t val = (bigint_dword_t)a->words[i];
         
         /* Shift the current word */
         int dest_idx = i - word_shift;
         if (dest_idx < BIGINT_4096_WORDS) {
-            r->words[dest_idx] = (uint32_t)(val >> bit_shift);
+            r->words[dest_idx] = (bigint_word_t)(val >> bit_shift);
         }
         
         /* TODO: CRITICAL FIX - Add proper bounds check for next word access */
         if (bit_shift > 0 && i + 1 < a->used && i + 1 < BIGINT_4096_WORDS) {
-            uint64_t next_val = (uint64_t)a->words[i + 1];
+            bigint_dword_t next_val = (bigint_dword_t)a->words[i + 1];
             if (dest_idx < BIGINT_4096_WORDS) {
-                r->words[dest_idx] |= (uint32_t)(next_val << (32 - bit_shift));
+                r->words[dest_idx] |= (bigint_word_t)(next_val << (BIGINT_WORD_SIZE - bit_shift));
             }
         }
     }
@@ -489,8 +574,8 @@ int bigint_shift_right(bigint_t *r, const bigint_t *a, int bits) {
 int bigint_get_bit(const bigint_t *a, int bit_pos) {
     if (!a || bit_pos < 0) return 0;
     
-    int word_idx = bit_pos / 32;
-    int bit_idx = bit_pos % 32;
+    int word_idx = bit_pos / BIGINT_WORD_SIZE;
+    int bit_idx = bit_pos % BIGINT_WORD_SIZE;
     
     if (word_idx >= a->used) return 0;
     
@@ -501,18 +586,35 @@ int bigint_bit_length(const bigint_t *a) {
     if (!a || bigint_is_zero(a)) return 0;
     
     int word_idx = a->used - 1;
-    uint32_t top_word = a->words[word_idx];
+    bigint_word_t top_word = a->words[word_idx];
     
-    int bit_pos = 31;
-    while (bit_pos > 0 && !(top_word & (1U << bit_pos))) {
+    int bit_pos = BIGINT_WORD_SIZE - 1;
+    while (bit_pos > 0 && !(top_word & ((bigint_word_t)1 << bit_pos))) {
         bit_pos--;
     }
     
-    return word_idx * 32 + bit_pos + 1;
+    return word_idx * BIGINT_WORD_SIZE + bit_pos + 1;
 }
 
 /* ===================== ADDITION/SUBTRACTION/MULTIPLICATION - ENHANCED ===================== */
 
+/**
+ * @brief Zero r beyond its first len limbs and normalize (the tail of the add/sub loops)
+ */
+static void bigint_finish_limbs(bigint_t *r, int len) {
+    memset(r->words + len, 0, (size_t)(BIGINT_4096_WORDS - len) * sizeof(bigint_word_t));
+    r->used = len;
+    r->sign = 0;
+    bigint_normalize(r);
+}
+
+/*
+ * bigint_add and bigint_sub run one loop over the limbs both operands have
+ * and one over the longer operand's tail, with no per-limb bounds checks:
+ * the only way out of the buffer is a final carry, checked once. Limb i of
+ * each input is read before limb i of r is written, so r may alias a or b.
+ */
+
 int bigint_add(bigint_t *r, const bigint_t *a, const bigint_t *b) {
     /* Critical input validation for round-trip safety */
     if (!r || !a || !b) {
@@ -524,42 +626,33 @@ int bigint_add(bigint_t *r, const bigint_t *a, const bigint_t *b) {
     VALIDATE_OVERFLOW(a, "bigint_add input a");
     VALIDATE_OVERFLOW(b, "bigint_add input b");
     
-    int max_used = (a->used > b->used) ? a->used : b->used;
-    uint64_t carry = 0;
-    
-    /* CRITICAL FIX: Handle in-place operations safely */
-    bigint_t temp_a, temp_b;
-    const bigint_t *safe_a = a;
-    const bigint_t *safe_b = b;
-    
-    if (r == a) {
-        bigint_copy(&temp_a, a);
-        safe_a = &temp_a;
+    const bigint_t *longer = (a->used >= b->used) ? a : b;
+    const bigint_t *shorter = (a->used >= b->used) ? b : a;
+    const int common = shorter->used, len = longer->used;
+    bigint_word_t carry = 0;
+    int i = 0;
+    
+    BIGINT_UNROLL
+    for (; i < common; i++) {
+        bigint_dword_t sum = (bigint_dword_t)longer->words[i] + shorter->words[i] + carry;
+        r->words[i] = (bigint_word_t)sum;
+        carry = (bigint_word_t)(sum >> BIGINT_WORD_SIZE);
     }
-    if (r == b) {
-        bigint_copy(&temp_b, b);
-        safe_b = &temp_b;
+    for (; i < len; i++) {
+        bigint_dword_t sum = (bigint_dword_t)longer->words[i] + carry;
+        r->words[i] = (bigint_word_t)sum;
+        carry = (bigint_word_t)(sum >> BIGINT_WORD_SIZE);
     }
     
-    bigint_init(r);
-    
-    /* Enhanced addition with overflow detection */
-    for (int i = 0; i < max_used || carry; i++) {
-        if (i >= BIGINT_4096_WORDS) {
+    if (carry) {
+        if (len >= BIGINT_4096_WORDS) {
             CHECKPOINT(LOG_ERROR, "Addition overflow: result too large for buffer");
             return -2; /* Overflow */
         }
-        
-        uint64_t sum = carry;
-        if (i < safe_a->used) sum += safe_a->words[i];
-        if (i < safe_b->used) sum += safe_b->words[i];
-        
-        r->words[i] = (uint32_t)(sum & 0xFFFFFFFF);
-        carry = sum >> 32;
-        r->used = i + 1;
+        r->words[i++] = carry;
     }
     
-    bigint_normalize(r);
+    bigint_finish_limbs(r, i);
     VALIDATE_OVERFLOW(r, "bigint_add result");
     return 0;
 }
@@ -578,41 +671,30 @@ int bigint_sub(bigint_t *r, const bigint_t *a, const bigint_t *b) {
     /* Check subtraction validity */
     if (bigint_compare(a, b) < 0) {
         CHECKPOINT(LOG_ERROR, "Subtraction underflow: a < b");
-        debug_print_bigint("a", a);
-        debug_print_bigint("b", b);
+        DEBUG_BIGINT("a", a);
+        DEBUG_BIGINT("b", b);
         return -2; /* a < b */
     }
     
-    /* CRITICAL FIX: Handle in-place operations safely */
-    bigint_t temp_a, temp_b;
-    const bigint_t *safe_a = a;
-    const bigint_t *safe_b = b;
-    
-    if (r == a) {
-        bigint_copy(&temp_a, a);
-        safe_a = &temp_a;
+    /* b <= a, so any limbs of b past a->used are zero */
+    const int len = a->used;
+    const int common = (b->used < len) ? b->used : len;
+    bigint_word_t borrow = 0;
+    int i = 0;
+    
+    BIGINT_UNROLL
+    for (; i < common; i++) {
+        bigint_dword_t diff = (bigint_dword_t)a->words[i] - b->words[i] - borrow;
+        r->words[i] = (bigint_word_t)diff;
+        borrow = (bigint_word_t)(diff >> (2 * BIGINT_WORD_SIZE - 1)); /* Check if we borrowed */
     }
-    if (r == b) {
-        bigint_copy(&temp_b, b);
-        safe_b = &temp_b;
+    for (; i < len; i++) {
+        bigint_dword_t diff = (bigint_dword_t)a->words[i] - borrow;
+        r->words[i] = (bigint_word_t)diff;
+        borrow = (bigint_word_t)(diff >> (2 * BIGINT_WORD_SIZE - 1));
     }
     
-    bigint_init(r);
-    uint64_t borrow = 0;
-    
-    /* Enhanced subtraction with underflow detection */
-    for (int i = 0; i < safe_a->used; i++) {
-        uint64_t a_val = safe_a->words[i];
-        uint64_t b_val = (i < safe_b->used) ? safe_b->words[i] : 0;
-        
-        uint64_t result = a_val - b_val - borrow;
-        
-        r->words[i] = (uint32_t)(result & 0xFFFFFFFF);
-        borrow = (result >> 63) & 1; /* Check if we borrowed */
-        r->used = i + 1;
-    }
-    
-    bigint_normalize(r);
+    bigint_finish_limbs(r, len);
     return 0;
 }
 
@@ -623,11 +705,10 @@ int bigint_mul(bigint_t *r, const bigint_t *a, const bigint_t *b) {
         return -1;
     }
     
-    bigint_init(r);
-    
     /* TODO: Handle zero multiplication efficiently */
     if (bigint_is_zero(a) || bigint_is_zero(b)) {
         CHECKPOINT(LOG_DEBUG, "Zero multiplication detected");
+        bigint_init(r);
         return 0;
     }
     
@@ -635,168 +716,777 @@ int bigint_mul(bigint_t *r, const bigint_t *a, const bigint_t *b) {
     VALIDATE_OVERFLOW(a, "bigint_mul input a");
     VALIDATE_OVERFLOW(b, "bigint_mul input b");
     
-    /* FIXME: Enhanced overflow protection for multiplication */
+    /* FIXME: Enhanced overflow protection for multiplication - full products belong in bigint_mul_wide */
     if (a->used + b->used > BIGINT_4096_WORDS) {
         CHECKPOINT(LOG_ERROR, "Multiplication overflow: result would be %d words (max %d)", 
                   a->used + b->used, BIGINT_4096_WORDS);
         return -2; /* Result would be too large */
     }
     
-    /* TODO: School multiplication with enhanced bounds checking */
-    for (int i = 0; i < a->used; i++) {
-        uint64_t carry = 0;
-        
-        for (int j = 0; j < b->used || carry; j++) {
-            int pos = i + j;
-            if (pos >= BIGINT_4096_WORDS) {
-                CHECKPOINT(LOG_ERROR, "Multiplication position overflow: pos=%d", pos);
-                break;
-            }
-            
-            uint64_t current = r->words[pos];
-            uint64_t product = 0;
-            
-            if (j < b->used) {
-                product = (uint64_t)a->words[i] * b->words[j];
-            }
-            
-            uint64_t sum = current + (product & 0xFFFFFFFF) + carry;
-            r->words[pos] = (uint32_t)(sum & 0xFFFFFFFF);
-            carry = (sum >> 32) + (product >> 32);
-            
-            if (pos >= r->used) {
-                r->used = pos + 1;
-            }
-        }
+    /* Multiplying into a temporary keeps r == a or r == b safe */
+    int n = a->used + b->used;
+    size_t mark;
+    bigint_word_t *product = BIGINT_SCRATCH_LIMBS(n + BIGINT_KARATSUBA_SCRATCH(n), &mark);
+    if (product == NULL) {
+        CHECKPOINT(LOG_ERROR, "Out of scratch memory in bigint_mul");
+        return -3;
     }
+    bigint_limbs_mul_karatsuba(product, a->words, a->used, b->words, b->used, product + n);
     
+    memcpy(r->words, product, (size_t)n * sizeof(bigint_word_t));
+    memset(r->words + n, 0, (size_t)(BIGINT_4096_WORDS - n) * sizeof(bigint_word_t));
+    r->used = n;
+    r->sign = 0;
     bigint_normalize(r);
+    bigint_scratch_pop(product, mark);
     return 0;
 }
 
-/* ===================== DIVISION/MODULO - CRITICAL FIXES ===================== */
+/**
+ * @brief Schoolbook product r = a * b on raw limbs
+ */
+void bigint_limbs_mul(bigint_word_t *r, const bigint_word_t *a, int an, const bigint_word_t *b, int bn) {
+    memset(r, 0, (size_t)(an + bn) * sizeof(bigint_word_t));
+    
+    for (int i = 0; i < an; i++) {
+        bigint_dword_t carry = 0;
+        bigint_word_t a_i = a[i];
+        BIGINT_UNROLL
+        for (int j = 0; j < bn; j++) {
+            bigint_dword_t uv = (bigint_dword_t)a_i * b[j] + r[i + j] + carry;
+            r[i + j] = (bigint_word_t)uv;
+            carry = uv >> BIGINT_WORD_SIZE;
+        }
+        r[i + bn] = (bigint_word_t)carry;
+    }
+}
 
-int bigint_div(bigint_t *q, bigint_t *r, const bigint_t *a, const bigint_t *b) {
-    if (!q || !r || !a || !b) return -1;
+/* ===================== SQUARING - SYMMETRIC PARTIAL PRODUCTS ===================== */
+
+/**
+ * @brief Schoolbook squaring that computes each cross product a[i]*a[j] (i < j) once
+ * 
+ * The off-diagonal sum is doubled with a one-bit shift and the diagonal terms
+ * a[i]^2 are added afterwards: n(n-1)/2 + n word multiplies instead of n^2.
+ */
+void bigint_limbs_sqr(bigint_word_t *r, const bigint_word_t *a, int n) {
+    memset(r, 0, (size_t)(2 * n) * sizeof(bigint_word_t));
+    
+    /* Off-diagonal products */
+    for (int i = 0; i < n - 1; i++) {
+        bigint_dword_t carry = 0;
+        bigint_word_t a_i = a[i];
+        BIGINT_UNROLL
+        for (int j = i + 1; j < n; j++) {
+            bigint_dword_t uv = (bigint_dword_t)a_i * a[j] + r[i + j] + carry;
+            r[i + j] = (bigint_word_t)uv;
+            carry = uv >> BIGINT_WORD_SIZE;
+        }
+        r[i + n] = (bigint_word_t)carry;
+    }
     
-    if (bigint_is_zero(b)) return -2; /* Division by zero */
+    /* Double the off-diagonal sum */
+    bigint_word_t shifted_out = 0;
+    for (int k = 0; k < 2 * n; k++) {
+        bigint_word_t w = r[k];
+        r[k] = (w << 1) | shifted_out;
+        shifted_out = w >> (BIGINT_WORD_SIZE - 1);
+    }
     
-    /* CRITICAL FIX: Handle in-place operations safely */
-    bigint_t temp_a, temp_b;
-    const bigint_t *safe_a = a;
-    const bigint_t *safe_b = b;
+    /* Add the diagonal squares */
+    bigint_dword_t carry = 0;
+    for (int i = 0; i < n; i++) {
+        bigint_dword_t sq = (bigint_dword_t)a[i] * a[i];
+        bigint_dword_t lo = (bigint_dword_t)r[2 * i] + (bigint_word_t)sq + carry;
+        r[2 * i] = (bigint_word_t)lo;
+        bigint_dword_t hi = (bigint_dword_t)r[2 * i + 1] + (sq >> BIGINT_WORD_SIZE) + (lo >> BIGINT_WORD_SIZE);
+        r[2 * i + 1] = (bigint_word_t)hi;
+        carry = hi >> BIGINT_WORD_SIZE;
+    }
+}
+
+/* ===================== KARATSUBA MULTIPLICATION ===================== */
+
+static int bigint_karatsuba_threshold = BIGINT_KARATSUBA_THRESHOLD;
+static int bigint_karatsuba_sqr_threshold = BIGINT_KARATSUBA_SQR_THRESHOLD;
+
+/**
+ * @brief Operand sizes (limbs) from which products and squares split into halves
+ * 
+ * Global tuning knobs like the log level: set them before starting worker
+ * threads. 2 is the smallest split that makes progress.
+ */
+int bigint_set_karatsuba_threshold(int mul_limbs, int sqr_limbs) {
+    if (mul_limbs < 2 || sqr_limbs < 2) {
+        CHECKPOINT(LOG_ERROR, "Karatsuba thresholds %d/%d below 2 limbs", mul_limbs, sqr_limbs);
+        return -1;
+    }
+    bigint_karatsuba_threshold = mul_limbs;
+    bigint_karatsuba_sqr_threshold = sqr_limbs;
+    return 0;
+}
+
+int bigint_get_karatsuba_threshold(int square) {
+    return square ? bigint_karatsuba_sqr_threshold : bigint_karatsuba_threshold;
+}
+
+/**
+ * @brief d[0..n-1] = |a - b| for a of an <= n limbs (zero-extended) and b of n limbs
+ * 
+ * Subtracts, then negates the two's complement result when it borrowed; no
+ * data-dependent branches. Returns all ones when a < b, zero otherwise.
+ */
+static bigint_word_t limbs_abs_diff(bigint_word_t *d, const bigint_word_t *a, int an,
+                                    const bigint_word_t *b, int n) {
+    bigint_word_t borrow = 0;
+    for (int i = 0; i < n; i++) {
+        bigint_word_t ai = i < an ? a[i] : 0;
+        bigint_dword_t diff = (bigint_dword_t)ai - b[i] - borrow;
+        d[i] = (bigint_word_t)diff;
+        borrow = (bigint_word_t)(diff >> (2 * BIGINT_WORD_SIZE - 1));
+    }
     
-    if (q == a || r == a) {
-        bigint_copy(&temp_a, a);
-        safe_a = &temp_a;
+    bigint_word_t mask = (bigint_word_t)0 - borrow;
+    bigint_word_t carry = borrow;
+    for (int i = 0; i < n; i++) {
+        bigint_dword_t v = (bigint_dword_t)(d[i] ^ mask) + carry;
+        d[i] = (bigint_word_t)v;
+        carry = (bigint_word_t)(v >> BIGINT_WORD_SIZE);
+    }
+    return mask;
+}
+
+/**
+ * @brief r[0..rn-1] += a[0..an-1] (an <= rn), carry rippling to the top of r
+ * 
+ * The ripple always runs to rn so the timing depends only on the sizes
+ * (the constant-time Montgomery squaring goes through here).
+ */
+static void limbs_add_into(bigint_word_t *r, int rn, const bigint_word_t *a, int an) {
+    bigint_word_t carry = 0;
+    for (int i = 0; i < rn; i++) {
+        bigint_dword_t v = (bigint_dword_t)r[i] + (i < an ? a[i] : 0) + carry;
+        r[i] = (bigint_word_t)v;
+        carry = (bigint_word_t)(v >> BIGINT_WORD_SIZE);
+    }
+}
+
+/**
+ * @brief Add the Karatsuba middle term z0 + z2 -/+ t into r at limb offset h
+ * 
+ * z0 = r[0..2h-1] and z2 = r[2h..2n-1] are already in place; t holds the
+ * 2hl-limb product of the half differences, subtracted when mask is all ones.
+ * The middle term is never negative, so the add/subtract is exact modulo
+ * the (2hl+1)-limb width of mid.
+ */
+static void karatsuba_combine(bigint_word_t *r, int n, int h, const bigint_word_t *t,
+                              bigint_word_t *mid, bigint_word_t mask) {
+    const int hl = n - h;
+    memcpy(mid, r + 2 * h, (size_t)(2 * hl) * sizeof(bigint_word_t));
+    mid[2 * hl] = 0;
+    limbs_add_into(mid, 2 * hl + 1, r, 2 * h);
+    
+    bigint_word_t carry = mask & 1;
+    for (int i = 0; i <= 2 * hl; i++) {
+        bigint_word_t ti = (i < 2 * hl ? t[i] : 0) ^ mask;
+        bigint_dword_t v = (bigint_dword_t)mid[i] + ti + carry;
+        mid[i] = (bigint_word_t)v;
+        carry = (bigint_word_t)(v >> BIGINT_WORD_SIZE);
     }
-    if (q == b || r == b) {
-        bigint_copy(&temp_b, b);
-        safe_b = &temp_b;
+    limbs_add_into(r + h, 2 * n - h, mid, 2 * hl + 1);
+}
+
+/**
+ * @brief Balanced Karatsuba r[0..2n-1] = a * b for two n-limb operands
+ * 
+ * Subtractive form: z0 = a0*b0, z2 = a1*b1, t = |a0-a1| * |b0-b1|, so every
+ * recursive product is on halves with no carry limb. Uses 6*ceil(n/2)+1
+ * scratch limbs per level.
+ */
+static void karatsuba_mul(bigint_word_t *r, const bigint_word_t *a, const bigint_word_t *b, int n,
+                          bigint_word_t *scratch) {
+    if (n < bigint_karatsuba_threshold) {
+        bigint_limbs_mul(r, a, n, b, n);
+        return;
     }
     
-    bigint_init(q);
-    bigint_init(r);
+    const int h = n / 2, hl = n - h;
+    bigint_word_t *da = scratch, *db = da + hl, *t = db + hl, *mid = t + 2 * hl, *next = mid + 2 * hl + 1;
     
-    if (bigint_is_zero(safe_a)) {
-        return 0; /* 0 / x = 0 remainder 0 */
+    bigint_word_t sign = limbs_abs_diff(da, a, h, a + h, hl) ^ limbs_abs_diff(db, b, h, b + h, hl);
+    karatsuba_mul(r, a, b, h, next);
+    karatsuba_mul(r + 2 * h, a + h, b + h, hl, next);
+    karatsuba_mul(t, da, db, hl, next);
+    
+    /* (a0-a1)(b0-b1) >= 0 exactly when the signs agree: then it is subtracted */
+    karatsuba_combine(r, n, h, t, mid, ~sign);
+}
+
+/**
+ * @brief Karatsuba squaring r[0..2n-1] = a^2: the middle term is always z0 + z2 - (a0-a1)^2
+ */
+static void karatsuba_sqr(bigint_word_t *r, const bigint_word_t *a, int n, bigint_word_t *scratch) {
+    if (n < bigint_karatsuba_sqr_threshold) {
+        bigint_limbs_sqr(r, a, n);
+        return;
     }
     
-    if (bigint_compare(safe_a, safe_b) < 0) {
-        /* a < b, so quotient = 0, remainder = a */
-        bigint_copy(r, safe_a);
+    const int h = n / 2, hl = n - h;
+    bigint_word_t *da = scratch, *t = da + hl, *mid = t + 2 * hl, *next = mid + 2 * hl + 1;
+    
+    limbs_abs_diff(da, a, h, a + h, hl);
+    karatsuba_sqr(r, a, h, next);
+    karatsuba_sqr(r + 2 * h, a + h, hl, next);
+    karatsuba_sqr(t, da, hl, next);
+    
+    karatsuba_combine(r, n, h, t, mid, ~(bigint_word_t)0);
+}
+
+/**
+ * @brief r[0..an+bn-1] = a * b, Karatsuba above the threshold, schoolbook below
+ * 
+ * Unbalanced operands are cut into slices the length of the shorter one, each
+ * slice product taken recursively and accumulated. scratch must hold
+ * BIGINT_KARATSUBA_SCRATCH(max(an, bn)) limbs; r must not alias a, b or scratch.
+ */
+void bigint_limbs_mul_karatsuba(bigint_word_t *r, const bigint_word_t *a, int an,
+                                const bigint_word_t *b, int bn, bigint_word_t *scratch) {
+    if (an < bn) {
+        const bigint_word_t *tp = a;
+        a = b;
+        b = tp;
+        int tn = an;
+        an = bn;
+        bn = tn;
+    }
+    
+    if (bn < bigint_karatsuba_threshold) {
+        bigint_limbs_mul(r, a, an, b, bn);
+        return;
+    }
+    if (an == bn) {
+        karatsuba_mul(r, a, b, an, scratch);
+        return;
+    }
+    
+    bigint_word_t *slice = scratch;
+    memset(r, 0, (size_t)(an + bn) * sizeof(bigint_word_t));
+    for (int off = 0; off < an; off += bn) {
+        int len = an - off < bn ? an - off : bn;
+        bigint_limbs_mul_karatsuba(slice, a + off, len, b, bn, slice + 2 * bn);
+        limbs_add_into(r + off, an + bn - off, slice, len + bn);
+    }
+}
+
+/**
+ * @brief r[0..2n-1] = a^2, Karatsuba above the threshold, symmetric schoolbook below
+ * 
+ * scratch must hold BIGINT_KARATSUBA_SCRATCH(n) limbs; r must not alias a or scratch.
+ */
+void bigint_limbs_sqr_karatsuba(bigint_word_t *r, const bigint_word_t *a, int n, bigint_word_t *scratch) {
+    karatsuba_sqr(r, a, n, scratch);
+}
+
+int bigint_square(bigint_t *r, const bigint_t *a) {
+    if (!r || !a) {
+        CHECKPOINT(LOG_ERROR, "NULL pointer in bigint_square");
+        return -1;
+    }
+    
+    if (bigint_is_zero(a)) {
+        bigint_init(r);
+        return 0;
+    }
+    
+    if (2 * a->used > BIGINT_4096_WORDS) {
+        CHECKPOINT(LOG_ERROR, "Squaring overflow: result would be %d words (max %d)", 
+                  2 * a->used, BIGINT_4096_WORDS);
+        return -2;
+    }
+    
+    /* Squaring into a temporary keeps r == a safe */
+    int n = a->used;
+    size_t mark;
+    bigint_word_t *product = BIGINT_SCRATCH_LIMBS(2 * n + BIGINT_KARATSUBA_SCRATCH(n), &mark);
+    if (product == NULL) {
+        CHECKPOINT(LOG_ERROR, "Out of scratch memory in bigint_square");
+        return -3;
+    }
+    bigint_limbs_sqr_karatsuba(product, a->words, n, product + 2 * n);
+    
+    memcpy(r->words, product, (size_t)(2 * n) * sizeof(bigint_word_t));
+    memset(r->words + 2 * n, 0, (size_t)(BIGINT_4096_WORDS - 2 * n) * sizeof(bigint_word_t));
+    r->used = 2 * n;
+    r->sign = 0;
+    bigint_normalize(r);
+    bigint_scratch_pop(product, mark);
+    return 0;
+}
+
+/* ===================== DOUBLE-WIDTH PRODUCTS ===================== */
+
+void bigint_wide_init(bigint_wide_t *a) {
+    if (a) {
+        memset(a->words, 0, sizeof(a->words));
+        a->used = 0;
+        a->sign = 0;
+    }
+}
+
+/**
+ * @brief Widen a value: dst = src
+ */
+void bigint_wide_from(bigint_wide_t *dst, const bigint_t *src) {
+    if (dst && src) {
+        int used = src->used < 0 ? 0 : (src->used > BIGINT_4096_WORDS ? BIGINT_4096_WORDS : src->used);
+        memcpy(dst->words, src->words, (size_t)used * sizeof(bigint_word_t));
+        memset(dst->words + used, 0, (size_t)(BIGINT_WIDE_WORDS - used) * sizeof(bigint_word_t));
+        dst->used = used;
+        dst->sign = src->sign;
+    }
+}
+
+/**
+ * @brief Set a wide value from n raw limbs, clear the tail and trim leading zeros
+ */
+static void bigint_wide_set_limbs_tail(bigint_wide_t *r, int n) {
+    memset(r->words + n, 0, (size_t)(BIGINT_WIDE_WORDS - n) * sizeof(bigint_word_t));
+    while (n > 1 && r->words[n - 1] == 0) {
+        n--;
+    }
+    r->used = n;
+    r->sign = 0;
+}
+
+/**
+ * @brief Full product r = a * b without the single-width size limit
+ */
+int bigint_mul_wide(bigint_wide_t *r, const bigint_t *a, const bigint_t *b) {
+    if (!r || !a || !b) {
+        CHECKPOINT(LOG_ERROR, "NULL pointer in bigint_mul_wide");
+        return -1;
+    }
+    
+    if (bigint_is_zero(a) || bigint_is_zero(b)) {
+        bigint_wide_init(r);
+        r->used = 1;
         return 0;
     }
     
-    /* Handle single-word divisor for efficiency */
-    if (safe_b->used == 1 && safe_b->words[0] <= 0xFFFF) {
-        uint32_t divisor = safe_b->words[0];
-        uint64_t remainder = 0;
+    int n = a->used + b->used;
+    if (n > BIGINT_WIDE_WORDS) {
+        CHECKPOINT(LOG_ERROR, "Wide multiplication overflow: %d words (max %d)", n, BIGINT_WIDE_WORDS);
+        return -2;
+    }
+    
+    size_t mark;
+    int max_n = a->used > b->used ? a->used : b->used;
+    bigint_word_t *scratch = BIGINT_SCRATCH_LIMBS(BIGINT_KARATSUBA_SCRATCH(max_n), &mark);
+    if (scratch == NULL) {
+        CHECKPOINT(LOG_ERROR, "Out of scratch memory in bigint_mul_wide");
+        return -3;
+    }
+    bigint_limbs_mul_karatsuba(r->words, a->words, a->used, b->words, b->used, scratch);
+    bigint_scratch_pop(scratch, mark);
+    bigint_wide_set_limbs_tail(r, n);
+    return 0;
+}
+
+/**
+ * @brief Full square r = a^2 using symmetric partial products
+ */
+int bigint_square_wide(bigint_wide_t *r, const bigint_t *a) {
+    if (!r || !a) {
+        CHECKPOINT(LOG_ERROR, "NULL pointer in bigint_square_wide");
+        return -1;
+    }
+    
+    if (bigint_is_zero(a)) {
+        bigint_wide_init(r);
+        r->used = 1;
+        return 0;
+    }
+    
+    int n = 2 * a->used;
+    if (n > BIGINT_WIDE_WORDS) {
+        CHECKPOINT(LOG_ERROR, "Wide squaring overflow: %d words (max %d)", n, BIGINT_WIDE_WORDS);
+        return -2;
+    }
+    
+    size_t mark;
+    bigint_word_t *scratch = BIGINT_SCRATCH_LIMBS(BIGINT_KARATSUBA_SCRATCH(a->used), &mark);
+    if (scratch == NULL) {
+        CHECKPOINT(LOG_ERROR, "Out of scratch memory in bigint_square_wide");
+        return -3;
+    }
+    bigint_limbs_sqr_karatsuba(r->words, a->words, a->used, scratch);
+    bigint_scratch_pop(scratch, mark);
+    bigint_wide_set_limbs_tail(r, n);
+    return 0;
+}
+
+/* ===================== DIVISION/MODULO - CRITICAL FIXES ===================== */
+
+/**
+ * @brief Count leading zero bits of a non-zero limb
+ */
+static int limb_clz(bigint_word_t w) {
+#if BIGINT_WORD_SIZE == 64
+    return __builtin_clzll((unsigned long long)w);
+#else
+    return __builtin_clz((unsigned int)w);
+#endif
+}
+
+/**
+ * @brief Knuth Algorithm D on raw limbs: q = u / v, rem = u mod v
+ * 
+ * Requires un >= vn >= 1 and v[vn-1] != 0. q receives un - vn + 1 limbs (may
+ * be NULL when only the remainder is wanted), rem receives vn limbs, and
+ * work holds the normalized copies (DIVMOD_WORK(un, vn) limbs). The divisor is normalized so its top bit is set, which
+ * keeps each two-limb quotient estimate at most 2 too large; the estimate
+ * is refined against the next limb and a rare add-back fixes the rest.
+ */
+#define DIVMOD_WORK(un, vn) ((un) + (vn) + 1)
+
+static void bigint_limbs_divmod(bigint_word_t *q, bigint_word_t *rem,
+                                const bigint_word_t *u, int un,
+                                const bigint_word_t *v, int vn, bigint_word_t *work) {
+    RSA_4096_STAT_ADD(RSA_4096_STAT_BIGINT_DIV, 1);
+    
+    /* Single-limb divisor: plain short division */
+    if (vn == 1) {
+        bigint_dword_t r = 0;
+        for (int i = un - 1; i >= 0; i--) {
+            bigint_dword_t cur = (r << BIGINT_WORD_SIZE) | u[i];
+            if (q) q[i] = (bigint_word_t)(cur / v[0]);
+            r = cur % v[0];
+        }
+        rem[0] = (bigint_word_t)r;
+        return;
+    }
+    
+    /* D1: normalize so that the divisor's top bit is set */
+    const int shift = limb_clz(v[vn - 1]);
+    bigint_word_t *vv = work;
+    bigint_word_t *uu = work + vn;
+    
+    if (shift > 0) {
+        for (int i = vn - 1; i > 0; i--) {
+            vv[i] = (v[i] << shift) | (v[i - 1] >> (BIGINT_WORD_SIZE - shift));
+        }
+        vv[0] = v[0] << shift;
+        uu[un] = u[un - 1] >> (BIGINT_WORD_SIZE - shift);
+        for (int i = un - 1; i > 0; i--) {
+            uu[i] = (u[i] << shift) | (u[i - 1] >> (BIGINT_WORD_SIZE - shift));
+        }
+        uu[0] = u[0] << shift;
+    } else {
+        memcpy(vv, v, (size_t)vn * sizeof(bigint_word_t));
+        memcpy(uu, u, (size_t)un * sizeof(bigint_word_t));
+        uu[un] = 0;
+    }
+    
+    const bigint_dword_t base = (bigint_dword_t)1 << BIGINT_WORD_SIZE;
+    const bigint_word_t v_top = vv[vn - 1];
+    const bigint_word_t v_next = vv[vn - 2];
+    
+    /* D2-D7: one quotient limb per step, most significant first */
+    for (int j = un - vn; j >= 0; j--) {
+        /* D3: estimate qhat from the top two limbs, refine with the third */
+        bigint_dword_t num = ((bigint_dword_t)uu[j + vn] << BIGINT_WORD_SIZE) | uu[j + vn - 1];
+        bigint_dword_t qhat = num / v_top;
+        bigint_dword_t rhat = num % v_top;
         
-        bigint_copy(r, safe_a);
+        while (qhat >= base ||
+               qhat * v_next > ((rhat << BIGINT_WORD_SIZE) | uu[j + vn - 2])) {
+            qhat--;
+            rhat += v_top;
+            if (rhat >= base) break;
+        }
         
-        /* Divide from most significant word to least */
-        for (int i = r->used - 1; i >= 0; i--) {
-            uint64_t temp = (remainder << 32) | r->words[i];
-            uint32_t digit = (uint32_t)(temp / divisor);
-            remainder = temp % divisor;
-            
-            if (q->used > 0 || digit > 0) {
-                if (q->used >= BIGINT_4096_WORDS) return -3;
-                q->words[q->used++] = digit;
-            }
+        /* D4: multiply and subtract qhat * v from the current window */
+        bigint_word_t borrow = 0;
+        bigint_word_t carry = 0;
+        for (int i = 0; i < vn; i++) {
+            bigint_dword_t p = qhat * vv[i] + carry;
+            carry = (bigint_word_t)(p >> BIGINT_WORD_SIZE);
+            bigint_dword_t t = (bigint_dword_t)uu[i + j] - (bigint_word_t)p - borrow;
+            uu[i + j] = (bigint_word_t)t;
+            borrow = (bigint_word_t)(t >> BIGINT_WORD_SIZE) ? 1 : 0;
         }
+        bigint_dword_t t = (bigint_dword_t)uu[j + vn] - carry - borrow;
+        uu[j + vn] = (bigint_word_t)t;
         
-        /* Reverse quotient words (we built it backwards) */
-        for (int i = 0; i < q->used / 2; i++) {
-            uint32_t temp = q->words[i];
-            q->words[i] = q->words[q->used - 1 - i];
-            q->words[q->used - 1 - i] = temp;
+        /* D5/D6: the estimate was one too large - add the divisor back */
+        if ((bigint_word_t)(t >> BIGINT_WORD_SIZE)) {
+            qhat--;
+            bigint_dword_t c = 0;
+            for (int i = 0; i < vn; i++) {
+                c += (bigint_dword_t)uu[i + j] + vv[i];
+                uu[i + j] = (bigint_word_t)c;
+                c >>= BIGINT_WORD_SIZE;
+            }
+            uu[j + vn] += (bigint_word_t)c;
         }
         
-        /* Set remainder */
-        bigint_set_u32(r, (uint32_t)remainder);
+        if (q) q[j] = (bigint_word_t)qhat;
+    }
+    
+    /* D8: unnormalize the remainder */
+    if (shift > 0) {
+        for (int i = 0; i < vn - 1; i++) {
+            rem[i] = (uu[i] >> shift) | (uu[i + 1] << (BIGINT_WORD_SIZE - shift));
+        }
+        rem[vn - 1] = (uu[vn - 1] >> shift) | (uu[vn] << (BIGINT_WORD_SIZE - shift));
+    } else {
+        memcpy(rem, uu, (size_t)vn * sizeof(bigint_word_t));
+    }
+}
+
+/**
+ * @brief Store n raw limbs into a bigint, clearing the tail
+ */
+static void bigint_set_limbs(bigint_t *r, const bigint_word_t *src, int n) {
+    memcpy(r->words, src, (size_t)n * sizeof(bigint_word_t));
+    memset(r->words + n, 0, (size_t)(BIGINT_4096_WORDS - n) * sizeof(bigint_word_t));
+    r->used = n;
+    r->sign = 0;
+    bigint_normalize(r);
+}
+
+int bigint_div(bigint_t *q, bigint_t *r, const bigint_t *a, const bigint_t *b) {
+    if (!q || !r || !a || !b) return -1;
+    
+    if (bigint_is_zero(b)) return -2; /* Division by zero */
+    
+    if (bigint_compare(a, b) < 0) {
+        /* a < b, so quotient = 0, remainder = a */
+        bigint_copy(r, a);
+        if (q != r) bigint_init(q);
         return 0;
     }
     
-    /* CRITICAL FIX: Use more efficient word-based division instead of bit-by-bit */
-    /* This prevents buffer overflow by working with fixed-size operations */
+    /* Work on local limb buffers so q/r may alias a/b */
+    int an = a->used;
+    int bn = b->used;
+    while (an > 1 && a->words[an - 1] == 0) an--;
+    while (bn > 1 && b->words[bn - 1] == 0) bn--;
+    size_t mark;
+    bigint_word_t *quot = BIGINT_SCRATCH_LIMBS((an - bn + 1) + bn + DIVMOD_WORK(an, bn), &mark);
+    if (quot == NULL) {
+        CHECKPOINT(LOG_ERROR, "Out of scratch memory in bigint_div");
+        return -3;
+    }
+    bigint_word_t *rem = quot + (an - bn + 1);
+    bigint_limbs_divmod(quot, rem, a->words, an, b->words, bn, rem + bn);
     
-    bigint_copy(r, safe_a);  /* remainder = dividend */
+    bigint_set_limbs(q, quot, an - bn + 1);
+    bigint_set_limbs(r, rem, bn);
+    bigint_scratch_pop(quot, mark);
+    return 0;
+}
+
+/**
+ * @brief Reduce a double-width value: r = a mod m
+ */
+int bigint_mod_wide(bigint_t *r, const bigint_wide_t *a, const bigint_t *m) {
+    if (!r || !a || !m) {
+        CHECKPOINT(LOG_ERROR, "NULL pointer in bigint_mod_wide");
+        return -1;
+    }
     
-    /* Use standard long division algorithm working word by word */
-    int dividend_bits = bigint_bit_length(safe_a);
-    int divisor_bits = bigint_bit_length(safe_b);
+    if (bigint_is_zero(m)) {
+        return -2; /* Division by zero */
+    }
+    
+    int an = a->used;
+    int mn = m->used;
+    while (an > 0 && a->words[an - 1] == 0) an--;
+    while (mn > 1 && m->words[mn - 1] == 0) mn--;
     
-    if (dividend_bits < divisor_bits) {
-        /* Already handled above, safety check */
-        bigint_copy(r, safe_a);
+    if (an < mn) {
+        bigint_set_limbs(r, a->words, an);
         return 0;
     }
     
-    /* OPTIMIZATION: Use repeated subtraction with exponential scaling for efficiency */
-    bigint_t scaled_divisor, temp_q, temp_r;
-    bigint_init(&scaled_divisor);
-    bigint_init(&temp_q);
-    bigint_init(&temp_r);
+    size_t mark;
+    bigint_word_t *rem = BIGINT_SCRATCH_LIMBS(mn + DIVMOD_WORK(an, mn), &mark);
+    if (rem == NULL) {
+        CHECKPOINT(LOG_ERROR, "Out of scratch memory in bigint_mod_wide");
+        return -3;
+    }
+    bigint_limbs_divmod(NULL, rem, a->words, an, m->words, mn, rem + mn);
+    bigint_set_limbs(r, rem, mn);
+    bigint_scratch_pop(rem, mark);
+    return 0;
+}
+
+int bigint_mod(bigint_t *r, const bigint_t *a, const bigint_t *m) {
+    if (!r || !a || !m) return -1;
     
-    while (bigint_compare(r, safe_b) >= 0) {
-        /* Find the largest power of 2 such that (divisor << power) <= remainder */
-        bigint_copy(&scaled_divisor, safe_b);
-        bigint_set_u32(&temp_q, 1);
-        
-        /* Scale up as much as possible without overflow */
-        while (1) {
-            /* Check if we can double the scaled divisor */
-            if (scaled_divisor.used >= BIGINT_4096_WORDS - 1) break;
-            
-            bigint_t double_scaled, double_q;
-            int ret1 = bigint_shift_left(&double_scaled, &scaled_divisor, 1);
-            int ret2 = bigint_shift_left(&double_q, &temp_q, 1);
-            
-            if (ret1 != 0 || ret2 != 0) break;
-            if (bigint_compare(&double_scaled, r) > 0) break;
-            
-            bigint_copy(&scaled_divisor, &double_scaled);
-            bigint_copy(&temp_q, &double_q);
+    if (bigint_is_zero(m)) return -2; /* Division by zero */
+    
+    if (bigint_compare(a, m) < 0) {
+        bigint_copy(r, a);
+        return 0;
+    }
+    
+    /* Remainder only - the quotient limbs are never stored */
+    int an = a->used;
+    int mn = m->used;
+    while (an > 1 && a->words[an - 1] == 0) an--;
+    while (mn > 1 && m->words[mn - 1] == 0) mn--;
+    
+    size_t mark;
+    bigint_word_t *rem = BIGINT_SCRATCH_LIMBS(mn + DIVMOD_WORK(an, mn), &mark);
+    if (rem == NULL) {
+        CHECKPOINT(LOG_ERROR, "Out of scratch memory in bigint_mod");
+        return -3;
+    }
+    bigint_limbs_divmod(NULL, rem, a->words, an, m->words, mn, rem + mn);
+    bigint_set_limbs(r, rem, mn);
+    bigint_scratch_pop(rem, mark);
+    return 0;
+}
+/* ===================== SCRATCH WORKSPACE ===================== */
+
+#define SCRATCH_HEAP_MARK ((size_t)-1)
+
+typedef struct {
+    unsigned char *base;
+    size_t capacity;
+    size_t top;
+    size_t peak;
+    size_t heap_fallbacks;
+    int external;
+} bigint_workspace_t;
+
+static __thread bigint_workspace_t thread_workspace;
+
+/* Default arenas are released by the key destructor when their thread exits */
+static pthread_once_t workspace_once = PTHREAD_ONCE_INIT;
+static pthread_key_t workspace_key;
+static int workspace_key_ok = 0;
+
+static void workspace_key_create(void) {
+    workspace_key_ok = pthread_key_create(&workspace_key, free) == 0;
+}
+
+static int workspace_ready(bigint_workspace_t *ws) {
+    if (ws->base != NULL) {
+        return 1;
+    }
+    pthread_once(&workspace_once, workspace_key_create);
+    ws->base = (unsigned char *)malloc(BIGINT_WORKSPACE_DEFAULT_BYTES);
+    if (ws->base == NULL) {
+        return 0;
+    }
+    ws->capacity = BIGINT_WORKSPACE_DEFAULT_BYTES;
+    ws->top = 0;
+    ws->peak = 0;
+    if (workspace_key_ok) {
+        pthread_setspecific(workspace_key, ws->base);
+    }
+    return 1;
+}
+
+static void workspace_release_default(bigint_workspace_t *ws) {
+    if (ws->base != NULL && !ws->external) {
+        if (workspace_key_ok) {
+            pthread_setspecific(workspace_key, NULL);
         }
-        
-        /* Subtract scaled divisor from remainder and add to quotient */
-        int ret = bigint_sub(&temp_r, r, &scaled_divisor);
-        if (ret != 0) return ret;
-        bigint_copy(r, &temp_r);
-        
-        ret = bigint_add(&temp_r, q, &temp_q);
-        if (ret != 0) return ret;
-        bigint_copy(q, &temp_r);
+        free(ws->base);
+    }
+    ws->base = NULL;
+    ws->capacity = 0;
+    ws->top = 0;
+    ws->peak = 0;
+    ws->external = 0;
+}
+
+/**
+ * @brief Use a caller-supplied buffer as this thread's arena (e.g. a static
+ * block on a small-stack event-loop thread)
+ * 
+ * The buffer must stay valid until bigint_workspace_detach or thread exit.
+ * Fails with -2 while scratch from the current arena is still reserved.
+ */
+int bigint_workspace_attach(void *buffer, size_t bytes) {
+    if (buffer == NULL || bytes < BIGINT_WORKSPACE_ALIGN) {
+        CHECKPOINT(LOG_ERROR, "Invalid workspace buffer (%zu bytes)", bytes);
+        return -1;
     }
     
+    bigint_workspace_t *ws = &thread_workspace;
+    if (ws->top != 0) {
+        CHECKPOINT(LOG_ERROR, "Cannot replace a workspace with %zu bytes reserved", ws->top);
+        return -2;
+    }
+    
+    /* Start the arena on an aligned address inside the buffer */
+    uintptr_t addr = (uintptr_t)buffer;
+    size_t skew = (size_t)((BIGINT_WORKSPACE_ALIGN - addr % BIGINT_WORKSPACE_ALIGN) % BIGINT_WORKSPACE_ALIGN);
+    
+    workspace_release_default(ws);
+    ws->base = (unsigned char *)buffer + skew;
+    ws->capacity = (bytes - skew) & ~(size_t)(BIGINT_WORKSPACE_ALIGN - 1);
+    ws->external = 1;
     return 0;
 }
 
-int bigint_mod(bigint_t *r, const bigint_t *a, const bigint_t *m) {
-    if (!r || !a || !m) return -1;
+/**
+ * @brief Drop an attached buffer; the next request sets up a default arena
+ */
+int bigint_workspace_detach(void) {
+    bigint_workspace_t *ws = &thread_workspace;
+    if (ws->top != 0) {
+        CHECKPOINT(LOG_ERROR, "Cannot detach a workspace with %zu bytes reserved", ws->top);
+        return -2;
+    }
+    workspace_release_default(ws);
+    return 0;
+}
+
+void bigint_workspace_get_stats(bigint_workspace_stats_t *stats) {
+    if (stats != NULL) {
+        const bigint_workspace_t *ws = &thread_workspace;
+        stats->capacity = ws->capacity;
+        stats->in_use = ws->top;
+        stats->peak = ws->peak;
+        stats->heap_fallbacks = ws->heap_fallbacks;
+        stats->external = ws->external;
+    }
+}
+
+/**
+ * @brief Reserve uninitialized scratch on the calling thread's arena
+ * 
+ * Returns NULL only when neither the arena nor the heap can provide it.
+ */
+void *bigint_scratch_push(size_t bytes, size_t *mark) {
+    bigint_workspace_t *ws = &thread_workspace;
+    size_t need = (bytes + BIGINT_WORKSPACE_ALIGN - 1) & ~(size_t)(BIGINT_WORKSPACE_ALIGN - 1);
+    
+    if (workspace_ready(ws) && need <= ws->capacity - ws->top) {
+        void *p = ws->base + ws->top;
+        *mark = ws->top;
+        ws->top += need;
+        if (ws->top > ws->peak) {
+            ws->peak = ws->top;
+        }
+        return p;
+    }
     
-    bigint_t q;
-    return bigint_div(&q, r, a, m);
-}
\ No newline at end of file
+    ws->heap_fallbacks++;
+    *mark = SCRATCH_HEAP_MARK;
+    return malloc(need > 0 ? need : 1);
+}
+
+void bigint_scratch_pop(void *ptr, size_t mark) {
+    if (mark == SCRATCH_HEAP_MARK) {
+        free(ptr);
+    } else {
+        thread_workspace.top = mark;
+    }
+}
@@ -14,10 +14,14 @@
  * @version FINAL_COMPLETE_FIXED_v8.4 + HYBRID_TERRANTSH_v1.0
  */
 
+#define _POSIX_C_SOURCE 200809L  /* write() for the stream fd sink */
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <time.h>
+#include <errno.h>
+#include <unistd.h>
 #include "rsa_4096.h"
 
 /* ===================== RSA KEY MANAGEMENT ===================== */
@@ -28,12 +32,107 @@ void rsa_4096_init(rsa_4096_key_t *key) {
         bigint_init(&key->exponent);
         memset(&key->mont_ctx, 0, sizeof(montgomery_ctx_t));
         key->is_private = 0;
+        memset(&key->crt, 0, sizeof(rsa_4096_crt_t));
+        key->constant_time = 0;
+        key->blinding = 0;
+        bigint_init(&key->blinding_e);
+        memset(&key->plan, 0, sizeof(rsa_4096_exp_plan_t));
+    }
+}
+
+/* ===================== EXPONENTIATION PLAN ===================== */
+
+/**
+ * @brief The hybrid_mod_exp decision cached on the key's own context
+ */
+static int rsa_4096_plan_mont_usable(const rsa_4096_key_t *key) {
+    return hybrid_uses_montgomery(&key->mont_ctx, &key->n);
+}
+
+static const char *rsa_4096_path_name(rsa_4096_exp_path_t path) {
+    switch (path) {
+    case RSA_4096_PATH_TRADITIONAL: return "traditional";
+    case RSA_4096_PATH_MONTGOMERY:  return "Montgomery sliding window";
+    case RSA_4096_PATH_SHORT_EXP:   return "short exponent";
+    case RSA_4096_PATH_CONSTTIME:   return "constant-time Montgomery";
+    case RSA_4096_PATH_CRT:         return "CRT";
+    default:                        return "hybrid selection";
+    }
+}
+
+/**
+ * @brief Decryption path from the key's current mode (constant-time can change after load)
+ */
+static rsa_4096_exp_path_t rsa_4096_plan_private_path(const rsa_4096_key_t *key) {
+    if (key->crt.is_active) {
+        return RSA_4096_PATH_CRT;
+    }
+    if (key->constant_time) {
+        return RSA_4096_PATH_CONSTTIME;
+    }
+    return key->plan.public_path;
+}
+
+/**
+ * @brief Build the key's exponentiation plan from its loaded components
+ * 
+ * Chooses the public path (none without an exponent, short exponent when e
+ * fits one limb, Montgomery sliding window, or traditional for even/small
+ * moduli), recodes the key
+ * exponent and the CRT exponents once, and derives the private path.
+ */
+int rsa_4096_key_prepare(rsa_4096_key_t *key) {
+    if (key == NULL) {
+        ERROR_RETURN(-1, "NULL pointer in rsa_4096_key_prepare");
+    }
+    
+    rsa_4096_exp_plan_t *plan = &key->plan;
+    memset(plan, 0, sizeof(*plan));
+    plan->modulus_bits = bigint_bit_length(&key->n);
+    
+    if (bigint_is_zero(&key->exponent)) {
+        plan->public_path = RSA_4096_PATH_NONE;     /* CRT-only key: nothing to encrypt with */
+    } else if (!rsa_4096_plan_mont_usable(key)) {
+        plan->public_path = RSA_4096_PATH_TRADITIONAL;
+    } else if (key->exponent.used == 1 && key->exponent.words[0] > 1) {
+        plan->public_path = RSA_4096_PATH_SHORT_EXP;
+        plan->short_exponent = key->exponent.words[0];
+    } else if (montgomery_exp_recode(&plan->exponent, &key->exponent, MONTGOMERY_WINDOW_AUTO) == 0) {
+        plan->public_path = RSA_4096_PATH_MONTGOMERY;
+    } else {
+        plan->public_path = RSA_4096_PATH_TRADITIONAL;
+    }
+    
+    if (key->crt.is_active &&
+        (montgomery_exp_recode(&plan->dp, &key->crt.dp, MONTGOMERY_WINDOW_AUTO) != 0 ||
+         montgomery_exp_recode(&plan->dq, &key->crt.dq, MONTGOMERY_WINDOW_AUTO) != 0)) {
+        plan->dp.window_bits = 0;
+        plan->dq.window_bits = 0;
+    }
+    plan->private_path = rsa_4096_plan_private_path(key);
+    
+    CHECKPOINT(LOG_INFO, "Exponentiation plan: %d-bit modulus, public %s, private %s", plan->modulus_bits,
+               rsa_4096_path_name(plan->public_path), rsa_4096_path_name(plan->private_path));
+    return 0;
+}
+
+/**
+ * @brief Select constant-time private-key exponentiation for this key
+ * 
+ * Key loading resets the mode, so call this after rsa_4096_load_*.
+ */
+void rsa_4096_set_constant_time(rsa_4096_key_t *key, int enable) {
+    if (key != NULL) {
+        key->constant_time = enable ? 1 : 0;
+        key->plan.private_path = rsa_4096_plan_private_path(key);
     }
 }
 
 void rsa_4096_free(rsa_4096_key_t *key) {
     if (key != NULL) {
         montgomery_ctx_free(&key->mont_ctx);
+        montgomery_ctx_free(&key->crt.mont_p);
+        montgomery_ctx_free(&key->crt.mont_q);
         memset(key, 0, sizeof(rsa_4096_key_t));
     }
 }
@@ -87,6 +186,7 @@ int rsa_4096_load_key(rsa_4096_key_t *key, const char *n_decimal, const char *e_
     } else {
         CHECKPOINT(LOG_INFO, "Montgomery REDC context initialized successfully - hybrid system ready");
     }
+    rsa_4096_key_prepare(key);
     
     CHECKPOINT(LOG_INFO, "RSA key loaded successfully: %d-bit modulus, %s key", 
               bigint_bit_length(&key->n), is_private ? "private" : "public");
@@ -136,7 +236,579 @@ int rsa_4096_load_key_binary(rsa_4096_key_t *key, const uint8_t *n_data, size_t
             CHECKPOINT(LOG_INFO, "Montgomery REDC initialization failed, using standard arithmetic");
         }
     }
+    rsa_4096_key_prepare(key);
+    
+    return 0;
+}
+
+/* ===================== CRT PRIVATE KEY SUPPORT ===================== */
+
+/**
+ * @brief Finish CRT key setup once p, q, dP, dQ and qInv have been parsed
+ * 
+ * Computes n = p * q, builds one Montgomery context per prime and validates
+ * the component ranges. The Montgomery context for n itself is also built so
+ * the same key can be used for public operations.
+ */
+static int rsa_4096_crt_setup(rsa_4096_key_t *key) {
+    rsa_4096_crt_t *crt = &key->crt;
+    
+    if (bigint_is_zero(&crt->p) || bigint_is_zero(&crt->q) ||
+        bigint_is_zero(&crt->dp) || bigint_is_zero(&crt->dq) || bigint_is_zero(&crt->qinv)) {
+        ERROR_RETURN(-3, "CRT components cannot be zero");
+    }
+    
+    /* Montgomery requires odd moduli - both primes of a real RSA key are odd */
+    if ((crt->p.words[0] & 1) == 0 || (crt->q.words[0] & 1) == 0) {
+        ERROR_RETURN(-4, "CRT primes must be odd");
+    }
+    
+    if (bigint_compare(&crt->dp, &crt->p) >= 0 || bigint_compare(&crt->dq, &crt->q) >= 0) {
+        ERROR_RETURN(-5, "CRT exponents must satisfy dP < p and dQ < q");
+    }
+    
+    if (bigint_compare(&crt->qinv, &crt->p) >= 0) {
+        ERROR_RETURN(-6, "CRT coefficient must satisfy qInv < p");
+    }
+    
+    /* montgomery_mod() reduces c < n = p*q modulo each prime, which needs q < R_p and p < R_q */
+    if (bigint_bit_length(&crt->q) > BIGINT_WORD_SIZE * crt->p.used || bigint_bit_length(&crt->p) > BIGINT_WORD_SIZE * crt->q.used) {
+        ERROR_RETURN(-7, "Unbalanced CRT primes (%d and %d bits) are not supported", 
+                     bigint_bit_length(&crt->p), bigint_bit_length(&crt->q));
+    }
+    
+    int ret = bigint_mul(&key->n, &crt->p, &crt->q);
+    if (ret != 0) {
+        ERROR_RETURN(ret, "Failed to compute n = p * q");
+    }
+    
+    ret = montgomery_ctx_init(&crt->mont_p, &crt->p);
+    if (ret != 0 || !crt->mont_p.is_active) {
+        ERROR_RETURN(-8, "Montgomery REDC initialization failed for p (code %d)", ret);
+    }
+    
+    ret = montgomery_ctx_init(&crt->mont_q, &crt->q);
+    if (ret != 0 || !crt->mont_q.is_active) {
+        ERROR_RETURN(-9, "Montgomery REDC initialization failed for q (code %d)", ret);
+    }
+    
+    /* Verify the coefficient: qInv * q == 1 (mod p) */
+    bigint_t q_mod_p, check;
+    ret = montgomery_mod(&q_mod_p, &crt->q, &crt->mont_p);
+    if (ret == 0) {
+        ret = montgomery_mul(&check, &q_mod_p, &crt->qinv, &crt->mont_p);
+    }
+    if (ret == 0) {
+        /* montgomery_mul leaves a factor R^(-1); multiplying by R^2 restores the plain product */
+        ret = montgomery_mul(&check, &check, &crt->mont_p.r_squared, &crt->mont_p);
+    }
+    if (ret != 0 || !bigint_is_one(&check)) {
+        ERROR_RETURN(-10, "CRT coefficient check failed: qInv * q != 1 (mod p)");
+    }
+    
+    crt->is_active = 1;
+    key->is_private = 1;
+    
+    /* Context for n serves blinding and the c^d fallback; a CRT-only key has no exponent to encrypt with */
+    ret = montgomery_ctx_init(&key->mont_ctx, &key->n);
+    if (ret != 0) {
+        CHECKPOINT(LOG_INFO, "Montgomery REDC initialization for n failed (code %d) - public operations will use traditional algorithm", ret);
+        key->mont_ctx.is_active = 0;
+    }
+    
+    CHECKPOINT(LOG_INFO, "CRT private key loaded successfully: %d-bit modulus (%d + %d bit primes)", 
+              bigint_bit_length(&key->n), bigint_bit_length(&crt->p), bigint_bit_length(&crt->q));
+    return rsa_4096_key_prepare(key);
+}
+
+int rsa_4096_load_crt_key(rsa_4096_key_t *key, const char *p_decimal, const char *q_decimal,
+                          const char *dp_decimal, const char *dq_decimal, const char *qinv_decimal) {
+    CHECKPOINT(LOG_INFO, "Loading RSA CRT private key");
+    
+    if (key == NULL || p_decimal == NULL || q_decimal == NULL || 
+        dp_decimal == NULL || dq_decimal == NULL || qinv_decimal == NULL) {
+        ERROR_RETURN(-1, "NULL pointer in rsa_4096_load_crt_key");
+    }
+    
+    rsa_4096_init(key);
+    
+    const char *components[5] = {p_decimal, q_decimal, dp_decimal, dq_decimal, qinv_decimal};
+    bigint_t *targets[5] = {&key->crt.p, &key->crt.q, &key->crt.dp, &key->crt.dq, &key->crt.qinv};
+    for (int i = 0; i < 5; i++) {
+        int ret = bigint_from_decimal(targets[i], components[i]);
+        if (ret != 0) {
+            ERROR_RETURN(ret, "Failed to parse CRT component %d", i);
+        }
+    }
+    
+    return rsa_4096_crt_setup(key);
+}
+
+int rsa_4096_load_crt_key_binary(rsa_4096_key_t *key, const uint8_t *p_data, size_t p_size,
+                                 const uint8_t *q_data, size_t q_size,
+                                 const uint8_t *dp_data, size_t dp_size,
+                                 const uint8_t *dq_data, size_t dq_size,
+                                 const uint8_t *qinv_data, size_t qinv_size) {
+    if (key == NULL || p_data == NULL || q_data == NULL || 
+        dp_data == NULL || dq_data == NULL || qinv_data == NULL) {
+        ERROR_RETURN(-1, "NULL pointer in rsa_4096_load_crt_key_binary");
+    }
+    
+    if (p_size == 0 || q_size == 0 || dp_size == 0 || dq_size == 0 || qinv_size == 0) {
+        ERROR_RETURN(-2, "Data size cannot be zero");
+    }
+    
+    rsa_4096_init(key);
+    
+    const uint8_t *components[5] = {p_data, q_data, dp_data, dq_data, qinv_data};
+    const size_t sizes[5] = {p_size, q_size, dp_size, dq_size, qinv_size};
+    bigint_t *targets[5] = {&key->crt.p, &key->crt.q, &key->crt.dp, &key->crt.dq, &key->crt.qinv};
+    for (int i = 0; i < 5; i++) {
+        int ret = bigint_from_binary(targets[i], components[i], sizes[i]);
+        if (ret != 0) {
+            ERROR_RETURN(ret, "Failed to parse binary CRT component %d", i);
+        }
+    }
+    
+    return rsa_4096_crt_setup(key);
+}
+
+/**
+ * @brief One CRT half: m = (c mod prime)^d_half mod prime
+ */
+static int rsa_4096_crt_half(bigint_t *m, const bigint_t *ciphertext, const bigint_t *d_half,
+                             const montgomery_exp_recoding_t *d_rec, const montgomery_ctx_t *ctx,
+                             int constant_time, char name) {
+    bigint_t c_half;
+    int ret = montgomery_mod(&c_half, ciphertext, ctx);
+    if (ret != 0) {
+        ERROR_RETURN(ret, "Failed to reduce ciphertext mod %c", name);
+    }
+    
+    if (constant_time) {
+        ret = montgomery_exp_consttime(m, &c_half, d_half, ctx, MONTGOMERY_WINDOW_AUTO);
+    } else if (d_rec->window_bits > 0) {
+        ret = montgomery_exp_recoded(m, &c_half, d_rec, ctx);
+    } else {
+        ret = montgomery_exp(m, &c_half, d_half, ctx);
+    }
+    if (ret != 0) {
+        ERROR_RETURN(ret, "CRT exponentiation mod %c failed", name);
+    }
+    return 0;
+}
+
+/**
+ * @brief r = (a - b) mod p for a, b < p
+ * 
+ * The borrow of a - b picks, through a mask, whether p is added back, so the
+ * work does not depend on which of the two secret residues is larger.
+ */
+static void rsa_4096_crt_sub_mod(bigint_t *r, const bigint_t *a, const bigint_t *b, const bigint_t *p) {
+    const int s = p->used;
+    bigint_dword_t borrow = 0, carry = 0;
+    bigint_init(r);
+    for (int j = 0; j < s; j++) {
+        bigint_word_t aj = j < a->used ? a->words[j] : 0;
+        bigint_word_t bj = j < b->used ? b->words[j] : 0;
+        bigint_dword_t diff = (bigint_dword_t)aj - bj - borrow;
+        r->words[j] = (bigint_word_t)diff;
+        borrow = (diff >> BIGINT_WORD_SIZE) & 1;
+    }
+    const bigint_word_t mask = (bigint_word_t)0 - (bigint_word_t)borrow;
+    for (int j = 0; j < s; j++) {
+        bigint_dword_t sum = (bigint_dword_t)r->words[j] + (p->words[j] & mask) + carry;
+        r->words[j] = (bigint_word_t)sum;
+        carry = sum >> BIGINT_WORD_SIZE;
+    }
+    r->used = s;
+    bigint_normalize(r);
+}
+
+/**
+ * @brief Garner recombination of m1 = c^dP mod p and m2 = c^dQ mod q
+ */
+static int rsa_4096_crt_combine(bigint_t *result, const bigint_t *m1, const bigint_t *m2, const rsa_4096_crt_t *crt) {
+    /* h = qInv * (m1 - m2) mod p */
+    bigint_t m2_mod_p, diff, h;
+    int ret = montgomery_mod(&m2_mod_p, m2, &crt->mont_p);
+    if (ret != 0) {
+        ERROR_RETURN(ret, "Failed to reduce m2 mod p");
+    }
+    
+    rsa_4096_crt_sub_mod(&diff, m1, &m2_mod_p, &crt->p);
+    
+    /* montgomery_mul(diff, qInv) = diff * qInv * R^(-1); multiplying by R^2 restores diff * qInv mod p */
+    ret = montgomery_mul(&h, &diff, &crt->qinv, &crt->mont_p);
+    if (ret == 0) {
+        ret = montgomery_mul(&h, &h, &crt->mont_p.r_squared, &crt->mont_p);
+    }
+    if (ret != 0) {
+        ERROR_RETURN(ret, "Failed to compute Garner coefficient h");
+    }
+    
+    /* m = m2 + h * q (always < n, no final reduction needed) */
+    bigint_t hq;
+    ret = bigint_mul(&hq, &h, &crt->q);
+    if (ret != 0) {
+        ERROR_RETURN(ret, "Failed to compute h * q");
+    }
+    ret = bigint_add(result, &hq, m2);
+    if (ret != 0) {
+        ERROR_RETURN(ret, "Failed to compute m2 + h * q");
+    }
+    
+    return 0;
+}
+
+/**
+ * @brief CRT decryption: m = m2 + q * (qInv * (m1 - m2) mod p)
+ * 
+ * m1 = c^dP mod p and m2 = c^dQ mod q are two half-size Montgomery
+ * exponentiations, recombined with Garner's formula.
+ */
+int rsa_4096_crt_decrypt_bigint(bigint_t *result, const bigint_t *ciphertext, const rsa_4096_key_t *priv_key) {
+    if (result == NULL || ciphertext == NULL || priv_key == NULL) {
+        ERROR_RETURN(-1, "NULL pointer in rsa_4096_crt_decrypt_bigint");
+    }
+    
+    const rsa_4096_crt_t *crt = &priv_key->crt;
+    if (!crt->is_active) {
+        ERROR_RETURN(-2, "Key has no active CRT components");
+    }
+    
+    bigint_t m1, m2;
+    int ret = rsa_4096_crt_half(&m1, ciphertext, &crt->dp, &priv_key->plan.dp, &crt->mont_p,
+                                priv_key->constant_time, 'p');
+    if (ret == 0) {
+        ret = rsa_4096_crt_half(&m2, ciphertext, &crt->dq, &priv_key->plan.dq, &crt->mont_q,
+                                priv_key->constant_time, 'q');
+    }
+    if (ret != 0) {
+        return ret;
+    }
+    
+    return rsa_4096_crt_combine(result, &m1, &m2, crt);
+}
+
+/**
+ * @brief The mod-q half, run on a pool worker
+ */
+typedef struct {
+    bigint_t m2;
+    const bigint_t *ciphertext;
+    const rsa_4096_key_t *key;
+    int ret;
+} rsa_4096_crt_q_task_t;
+
+static void rsa_4096_crt_q_task(void *arg) {
+    rsa_4096_crt_q_task_t *task = (rsa_4096_crt_q_task_t *)arg;
+    const rsa_4096_crt_t *crt = &task->key->crt;
+    task->ret = rsa_4096_crt_half(&task->m2, task->ciphertext, &crt->dq, &task->key->plan.dq, &crt->mont_q,
+                                  task->key->constant_time, 'q');
+}
+
+/**
+ * @brief CRT decryption with the two halves on two threads
+ * 
+ * The mod-q exponentiation is handed to the pool while the calling thread
+ * computes the mod-p one; both join before Garner recombination. Runs
+ * serially when pool is NULL, when called from one of the pool's own
+ * workers (which could otherwise wait on itself), or if queueing fails.
+ */
+int rsa_4096_crt_decrypt_bigint_parallel(bigint_t *result, const bigint_t *ciphertext,
+                                         const rsa_4096_key_t *priv_key, rsa_4096_pool_t *pool) {
+    if (result == NULL || ciphertext == NULL || priv_key == NULL) {
+        ERROR_RETURN(-1, "NULL pointer in rsa_4096_crt_decrypt_bigint_parallel");
+    }
+    
+    const rsa_4096_crt_t *crt = &priv_key->crt;
+    if (!crt->is_active) {
+        ERROR_RETURN(-2, "Key has no active CRT components");
+    }
+    
+    if (pool == NULL || rsa_4096_pool_is_worker(pool)) {
+        return rsa_4096_crt_decrypt_bigint(result, ciphertext, priv_key);
+    }
+    
+    rsa_4096_crt_q_task_t task;
+    task.ciphertext = ciphertext;
+    task.key = priv_key;
+    task.ret = -1;
+    rsa_4096_future_t future;
+    if (rsa_4096_pool_run(pool, rsa_4096_crt_q_task, &task, &future) != 0) {
+        CHECKPOINT(LOG_ERROR, "Could not queue the mod-q half, decrypting serially");
+        return rsa_4096_crt_decrypt_bigint(result, ciphertext, priv_key);
+    }
+    
+    bigint_t m1;
+    int ret = rsa_4096_crt_half(&m1, ciphertext, &crt->dp, &priv_key->plan.dp, &crt->mont_p,
+                                priv_key->constant_time, 'p');
+    
+    /* Always join: the task lives on this stack frame */
+    rsa_4096_future_wait(&future);
+    if (ret != 0) {
+        return ret;
+    }
+    if (task.ret != 0) {
+        return task.ret;
+    }
+    
+    return rsa_4096_crt_combine(result, &m1, &task.m2, crt);
+}
+
+/**
+ * @brief The key's planned path for one direction
+ * 
+ * Keys filled in by hand have no plan; their private operations still honour
+ * CRT and constant-time mode, and everything else goes through hybrid_mod_exp.
+ */
+static rsa_4096_exp_path_t rsa_4096_key_path(const rsa_4096_key_t *key, int is_private) {
+    if (!is_private) {
+        return key->plan.public_path;
+    }
+    if (key->plan.private_path != RSA_4096_PATH_NONE) {
+        return key->plan.private_path;
+    }
+    return rsa_4096_plan_private_path(key);
+}
+
+/**
+ * @brief input^exponent mod n along the key's plan (input < n already checked)
+ */
+static int rsa_4096_key_exp(bigint_t *result, const bigint_t *input, const rsa_4096_key_t *key,
+                            rsa_4096_exp_path_t path, rsa_4096_pool_t *pool) {
+    int ret;
+    
+    switch (path) {
+    case RSA_4096_PATH_CRT:
+        ret = rsa_4096_crt_decrypt_bigint_parallel(result, input, key, pool);
+        if (ret == 0 || bigint_is_zero(&key->exponent)) {
+            return ret;
+        }
+        CHECKPOINT(LOG_ERROR, "CRT decryption failed (code %d), falling back to c^d mod n", ret);
+        RSA_4096_STAT_ADD(RSA_4096_STAT_PATH_FALLBACK, 1);
+        return hybrid_mod_exp(result, input, &key->exponent, &key->n, &key->mont_ctx);
+    case RSA_4096_PATH_CONSTTIME:
+        /* Constant-time mode never takes the exponent-dependent traditional path */
+        if (!key->mont_ctx.is_active) {
+            ERROR_RETURN(-5, "Constant-time decryption requires an active Montgomery context");
+        }
+        return montgomery_exp_consttime(result, input, &key->exponent, &key->mont_ctx, MONTGOMERY_WINDOW_AUTO);
+    case RSA_4096_PATH_SHORT_EXP:
+        ret = montgomery_exp_short(result, input, key->plan.short_exponent, &key->mont_ctx);
+        if (ret == 0) {
+            return 0;
+        }
+        CHECKPOINT(LOG_ERROR, "Short-exponent path failed (code %d), falling back to hybrid selection", ret);
+        RSA_4096_STAT_ADD(RSA_4096_STAT_PATH_FALLBACK, 1);
+        return hybrid_mod_exp(result, input, &key->exponent, &key->n, &key->mont_ctx);
+    case RSA_4096_PATH_MONTGOMERY:
+        ret = montgomery_exp_recoded(result, input, &key->plan.exponent, &key->mont_ctx);
+        if (ret == 0) {
+            return 0;
+        }
+        CHECKPOINT(LOG_ERROR, "Montgomery exponentiation failed (code %d), falling back to traditional", ret);
+        RSA_4096_STAT_ADD(RSA_4096_STAT_PATH_FALLBACK, 1);
+        return bigint_mod_exp(result, input, &key->exponent, &key->n);
+    case RSA_4096_PATH_TRADITIONAL:
+        return bigint_mod_exp(result, input, &key->exponent, &key->n);
+    default:
+        return hybrid_mod_exp(result, input, &key->exponent, &key->n, &key->mont_ctx);
+    }
+}
+
+/* ===================== BLINDING ===================== */
+
+/*
+ * A private operation on c runs on c * A instead and multiplies the result
+ * by B, where B * A^d == 1 (mod n): with e known A = r^e and B = r^(-1).
+ * Squaring both keeps that relation, so after each use the pair is
+ * squared (as OpenSSL does) and fresh randomness is only drawn every
+ * RSA_4096_BLINDING_REFRESH uses. A and B are held in Montgomery form, so
+ * blinding, unblinding and each update is a single montgomery_mul.
+ *
+ * Pairs are per thread (no locks, no shared writes), keyed by modulus so a
+ * reused key address never picks up a stale pair.
+ */
+
+typedef struct {
+    bigint_t n;                   /* Modulus the pair belongs to */
+    bigint_t a;                   /* A * R mod n: multiplies the input */
+    bigint_t b;                   /* B * R mod n: multiplies the result */
+    int remaining;                /* Uses left before fresh randomness (0 = empty slot) */
+} rsa_4096_blinding_slot_t;
+
+static __thread rsa_4096_blinding_slot_t blinding_slots[RSA_4096_BLINDING_SLOTS];
+static __thread unsigned int blinding_victim;
+
+int rsa_4096_random_bytes(uint8_t *buf, size_t len) {
+    if (buf == NULL && len > 0) {
+        ERROR_RETURN(-1, "NULL pointer in rsa_4096_random_bytes");
+    }
+    FILE *f = fopen("/dev/urandom", "rb");
+    if (f == NULL) {
+        ERROR_RETURN(-2, "Cannot open /dev/urandom");
+    }
+    size_t got = fread(buf, 1, len, f);
+    fclose(f);
+    if (got != len) {
+        ERROR_RETURN(-3, "Short read from /dev/urandom");
+    }
+    return 0;
+}
+
+/**
+ * @brief Uniform-ish r in [1, 2^(bits(n)-1)), below n
+ */
+static int rsa_4096_blinding_random(bigint_t *r, const bigint_t *n) {
+    const int bits = bigint_bit_length(n) - 1;
+    const int words = (bits + BIGINT_WORD_SIZE - 1) / BIGINT_WORD_SIZE;
+    do {
+        bigint_init(r);
+        int ret = rsa_4096_random_bytes((uint8_t *)r->words, (size_t)words * sizeof(bigint_word_t));
+        if (ret != 0) {
+            return ret;
+        }
+        if (bits % BIGINT_WORD_SIZE) {
+            r->words[words - 1] &= ((bigint_word_t)1 << (bits % BIGINT_WORD_SIZE)) - 1;
+        }
+        r->used = words;
+        bigint_normalize(r);
+    } while (bigint_is_zero(r));
+    return 0;
+}
+
+/**
+ * @brief Draw a fresh pair into the slot
+ */
+static int rsa_4096_blinding_refresh(rsa_4096_blinding_slot_t *slot, const rsa_4096_key_t *key) {
+    const montgomery_ctx_t *ctx = &key->mont_ctx;
+    bigint_t r, a, b, t;
+    int ret;
+    
+    /* A shared factor with n is a factorisation of n; treat it as a failed draw */
+    for (int attempt = 0; attempt < 4; attempt++) {
+        ret = rsa_4096_blinding_random(&r, &key->n);
+        if (ret != 0) {
+            ERROR_RETURN(ret, "No randomness for the blinding factor");
+        }
+        if (!bigint_is_zero(&key->blinding_e)) {
+            /* A = r^e, B = r^(-1) */
+            ret = hybrid_mod_exp(&a, &r, &key->blinding_e, &key->n, ctx);
+            if (ret == 0) ret = mod_inverse_consttime(&b, &r, &key->n);
+        } else {
+            /* A = r, B = (r^d)^(-1) */
+            bigint_copy(&a, &r);
+            ret = rsa_4096_key_exp(&t, &r, key, rsa_4096_key_path(key, 1), NULL);
+            if (ret == 0) ret = mod_inverse_consttime(&b, &t, &key->n);
+        }
+        if (ret != -5) {
+            break;
+        }
+    }
+    if (ret == 0) ret = montgomery_to_form(&slot->a, &a, ctx);
+    if (ret == 0) ret = montgomery_to_form(&slot->b, &b, ctx);
+    if (ret != 0) {
+        slot->remaining = 0;
+        ERROR_RETURN(ret, "Failed to build a blinding pair");
+    }
+    bigint_copy(&slot->n, &key->n);
+    slot->remaining = RSA_4096_BLINDING_REFRESH;
+    return 0;
+}
+
+/**
+ * @brief value = value * A mod n; unblind receives the matching B and the pair moves on
+ */
+static int rsa_4096_blind(bigint_t *value, bigint_t *unblind, const rsa_4096_key_t *key) {
+    const montgomery_ctx_t *ctx = &key->mont_ctx;
+    rsa_4096_blinding_slot_t *slot = NULL;
+    
+    for (int i = 0; i < RSA_4096_BLINDING_SLOTS; i++) {
+        if (blinding_slots[i].remaining > 0 && bigint_compare(&blinding_slots[i].n, &key->n) == 0) {
+            slot = &blinding_slots[i];
+            break;
+        }
+    }
+    if (slot == NULL) {
+        slot = &blinding_slots[blinding_victim++ % RSA_4096_BLINDING_SLOTS];
+        slot->remaining = 0;
+    }
+    if (slot->remaining == 0) {
+        int ret = rsa_4096_blinding_refresh(slot, key);
+        if (ret != 0) {
+            return ret;
+        }
+    }
     
+    int ret = montgomery_mul(value, value, &slot->a, ctx);
+    if (ret == 0) {
+        bigint_copy(unblind, &slot->b);
+        slot->remaining--;
+        ret = montgomery_square(&slot->a, &slot->a, ctx);
+    }
+    if (ret == 0) {
+        ret = montgomery_square(&slot->b, &slot->b, ctx);
+    }
+    if (ret != 0) {
+        slot->remaining = 0;
+        ERROR_RETURN(ret, "Blinding failed");
+    }
+    return 0;
+}
+
+/**
+ * @brief Private-key exponentiation, blinded when the key asks for it
+ */
+static int rsa_4096_private_exp(bigint_t *result, const bigint_t *input, const rsa_4096_key_t *key,
+                                rsa_4096_exp_path_t path, rsa_4096_pool_t *pool) {
+    if (!key->blinding) {
+        return rsa_4096_key_exp(result, input, key, path, pool);
+    }
+    
+    bigint_t blinded, unblind;
+    bigint_copy(&blinded, input);
+    int ret = rsa_4096_blind(&blinded, &unblind, key);
+    if (ret == 0) ret = rsa_4096_key_exp(result, &blinded, key, path, pool);
+    if (ret == 0) ret = montgomery_mul(result, result, &unblind, &key->mont_ctx);
+    return ret;
+}
+
+/**
+ * @brief Turn blinding of private operations on or off
+ * 
+ * Key loading resets the mode, so call this after rsa_4096_load_*. A given
+ * public exponent is checked against the key with one private operation
+ * (a wrong e would silently corrupt every result).
+ */
+int rsa_4096_set_blinding(rsa_4096_key_t *key, int enable, const bigint_t *public_exponent) {
+    if (key == NULL) {
+        ERROR_RETURN(-1, "NULL pointer in rsa_4096_set_blinding");
+    }
+    if (!enable) {
+        key->blinding = 0;
+        return 0;
+    }
+    if (!key->is_private) {
+        ERROR_RETURN(-2, "Blinding applies to private keys only");
+    }
+    if (!key->mont_ctx.is_active) {
+        ERROR_RETURN(-3, "Blinding requires an active Montgomery context for n");
+    }
+    
+    bigint_init(&key->blinding_e);
+    if (public_exponent != NULL && !bigint_is_zero(public_exponent)) {
+        bigint_t two, c, m;
+        bigint_set_u32(&two, 2);
+        int ret = hybrid_mod_exp(&c, &two, public_exponent, &key->n, &key->mont_ctx);
+        if (ret == 0) ret = rsa_4096_key_exp(&m, &c, key, rsa_4096_key_path(key, 1), NULL);
+        if (ret != 0 || bigint_compare(&m, &two) != 0) {
+            ERROR_RETURN(-4, "Public exponent does not match the private key");
+        }
+        bigint_copy(&key->blinding_e, public_exponent);
+    }
+    key->blinding = 1;
     return 0;
 }
 
@@ -150,6 +822,10 @@ int rsa_4096_encrypt(const rsa_4096_key_t *pub_key, const char *message_decimal,
         ERROR_RETURN(-1, "NULL pointer in rsa_4096_encrypt");
     }
     
+    if (bigint_is_zero(&pub_key->exponent)) {
+        ERROR_RETURN(-2, "Encryption requires a public exponent");
+    }
+    
     /* FIXED: Check buffer size */
     if (encrypted_size == 0) {
         ERROR_RETURN(-2, "Encrypted buffer size cannot be zero");
@@ -182,19 +858,22 @@ int rsa_4096_encrypt(const rsa_4096_key_t *pub_key, const char *message_decimal,
     /* Perform encryption: c = m^e mod n */
     bigint_t encrypted;
     
-    /* Use hybrid algorithm selection - Terrantsh model with intelligent fallback */
-    CHECKPOINT(LOG_INFO, "Using hybrid algorithm selection for encryption");
-    ret = hybrid_mod_exp(&encrypted, &message, &pub_key->exponent, &pub_key->n, &pub_key->mont_ctx);
+    /* Path chosen at load time (rsa_4096_key_prepare) */
+    rsa_4096_exp_path_t path = rsa_4096_key_path(pub_key, 0);
+    CHECKPOINT(LOG_INFO, "Using %s for encryption", rsa_4096_path_name(path));
+    ret = rsa_4096_key_exp(&encrypted, &message, pub_key, path, NULL);
     
     if (ret != 0) {
         ERROR_RETURN(ret, "Encryption computation failed");
     }
     
     /* Convert result to hex */
+    RSA_4096_PHASE_BEGIN(encode_start);
     ret = bigint_to_hex(&encrypted, encrypted_hex, encrypted_size);
     if (ret != 0) {
         ERROR_RETURN(ret, "Failed to convert encrypted result to hex");
     }
+    RSA_4096_PHASE_END(RSA_4096_PHASE_ENCODE, encode_start);
     
     CHECKPOINT(LOG_INFO, "Encryption completed successfully");
     return 0;
@@ -243,20 +922,21 @@ int rsa_4096_decrypt(const rsa_4096_key_t *priv_key, const char *encrypted_hex,
     
     /* Perform decryption: m = c^d mod n */
     bigint_t decrypted;
-    
-    /* Use hybrid algorithm selection - Terrantsh model with intelligent fallback */
-    CHECKPOINT(LOG_INFO, "Using hybrid algorithm selection for decryption");
-    ret = hybrid_mod_exp(&decrypted, &encrypted, &priv_key->exponent, &priv_key->n, &priv_key->mont_ctx);
+    rsa_4096_exp_path_t path = rsa_4096_key_path(priv_key, 1);
+    CHECKPOINT(LOG_INFO, "Using %s for decryption", rsa_4096_path_name(path));
+    ret = rsa_4096_private_exp(&decrypted, &encrypted, priv_key, path, NULL);
     
     if (ret != 0) {
         ERROR_RETURN(ret, "Decryption computation failed");
     }
     
     /* Convert result to decimal */
+    RSA_4096_PHASE_BEGIN(encode_start);
     ret = bigint_to_decimal(&decrypted, message_decimal, message_size);
     if (ret != 0) {
         ERROR_RETURN(ret, "Failed to convert decrypted result to decimal");
     }
+    RSA_4096_PHASE_END(RSA_4096_PHASE_ENCODE, encode_start);
     
     CHECKPOINT(LOG_INFO, "Decryption completed successfully");
     return 0;
@@ -271,6 +951,10 @@ int rsa_4096_encrypt_binary(const rsa_4096_key_t *pub_key, const uint8_t *messag
         ERROR_RETURN(-1, "NULL pointer in rsa_4096_encrypt_binary");
     }
     
+    if (bigint_is_zero(&pub_key->exponent)) {
+        ERROR_RETURN(-2, "Encryption requires a public exponent");
+    }
+    
     /* FIXED: Check sizes */
     if (message_size == 0) {
         ERROR_RETURN(-2, "Message size cannot be zero");
@@ -293,8 +977,8 @@ int rsa_4096_encrypt_binary(const rsa_4096_key_t *pub_key, const uint8_t *messag
     if (modulus_bits <= 8) {
         max_safe_size = 1;
         if (message_size > max_safe_size) {
-            printf("[rsa_4096_encrypt_binary] WARNING: Message too large (%zu bytes), will encrypt first %zu bytes only\n", 
-                   message_size, max_safe_size);
+            CHECKPOINT(LOG_ERROR, "WARNING: Message too large (%zu bytes), will encrypt first %zu bytes only", 
+                       message_size, max_safe_size);
             message_size = max_safe_size;
         }
     }
@@ -311,20 +995,23 @@ int rsa_4096_encrypt_binary(const rsa_4096_key_t *pub_key, const uint8_t *messag
         ERROR_RETURN(-4, "Message must be less than modulus");
     }
     
-    /* Use hybrid algorithm selection - Terrantsh model with intelligent fallback */
+    /* Path chosen at load time (rsa_4096_key_prepare) */
     bigint_t encrypted_bigint;
-    CHECKPOINT(LOG_INFO, "Using hybrid algorithm selection for binary encryption");
-    ret = hybrid_mod_exp(&encrypted_bigint, &message_bigint, &pub_key->exponent, &pub_key->n, &pub_key->mont_ctx);
+    rsa_4096_exp_path_t path = rsa_4096_key_path(pub_key, 0);
+    CHECKPOINT(LOG_INFO, "Using %s for binary encryption", rsa_4096_path_name(path));
+    ret = rsa_4096_key_exp(&encrypted_bigint, &message_bigint, pub_key, path, NULL);
     
     if (ret != 0) {
         ERROR_RETURN(ret, "Binary encryption computation failed");
     }
     
     /* Convert result to binary */
+    RSA_4096_PHASE_BEGIN(encode_start);
     ret = bigint_to_binary(&encrypted_bigint, encrypted, encrypted_buffer_size, encrypted_size);
     if (ret != 0) {
         ERROR_RETURN(ret, "Failed to convert encrypted result to binary");
     }
+    RSA_4096_PHASE_END(RSA_4096_PHASE_ENCODE, encode_start);
     
     CHECKPOINT(LOG_INFO, "Binary encryption completed successfully");
     return 0;
@@ -333,6 +1020,16 @@ int rsa_4096_encrypt_binary(const rsa_4096_key_t *pub_key, const uint8_t *messag
 int rsa_4096_decrypt_binary(const rsa_4096_key_t *priv_key, const uint8_t *encrypted,
                            size_t encrypted_size, uint8_t *message, size_t message_buffer_size,
                            size_t *message_size) {
+    return rsa_4096_decrypt_binary_parallel(priv_key, NULL, encrypted, encrypted_size,
+                                            message, message_buffer_size, message_size);
+}
+
+/**
+ * @brief rsa_4096_decrypt_binary with the CRT halves split across the pool (NULL pool: serial)
+ */
+int rsa_4096_decrypt_binary_parallel(const rsa_4096_key_t *priv_key, rsa_4096_pool_t *pool,
+                                     const uint8_t *encrypted, size_t encrypted_size,
+                                     uint8_t *message, size_t message_buffer_size, size_t *message_size) {
     CHECKPOINT(LOG_INFO, "Binary decryption using RSA-4096");
     
     if (priv_key == NULL || encrypted == NULL || message == NULL || message_size == NULL) {
@@ -364,21 +1061,641 @@ int rsa_4096_decrypt_binary(const rsa_4096_key_t *priv_key, const uint8_t *encry
         ERROR_RETURN(-5, "Encrypted message must be less than modulus");
     }
     
-    /* Use hybrid algorithm selection - Terrantsh model with intelligent fallback */
+    /* Private-key exponentiation (CRT when available) */
     bigint_t decrypted_bigint;
-    CHECKPOINT(LOG_INFO, "Using hybrid algorithm selection for binary decryption");
-    ret = hybrid_mod_exp(&decrypted_bigint, &encrypted_bigint, &priv_key->exponent, &priv_key->n, &priv_key->mont_ctx);
+    rsa_4096_exp_path_t path = rsa_4096_key_path(priv_key, 1);
+    CHECKPOINT(LOG_INFO, "Using %s for binary decryption%s", rsa_4096_path_name(path),
+               path == RSA_4096_PATH_CRT && pool != NULL ? " (halves in parallel)" : "");
+    ret = rsa_4096_private_exp(&decrypted_bigint, &encrypted_bigint, priv_key, path, pool);
     
     if (ret != 0) {
         ERROR_RETURN(ret, "Binary decryption computation failed");
     }
     
     /* Convert result to binary */
+    RSA_4096_PHASE_BEGIN(encode_start);
     ret = bigint_to_binary(&decrypted_bigint, message, message_buffer_size, message_size);
     if (ret != 0) {
         ERROR_RETURN(ret, "Failed to convert decrypted result to binary");
     }
+    RSA_4096_PHASE_END(RSA_4096_PHASE_ENCODE, encode_start);
     
     CHECKPOINT(LOG_INFO, "Binary decryption completed successfully");
     return 0;
-}
\ No newline at end of file
+}
+/* ===================== BATCH OPERATIONS ===================== */
+
+/**
+ * @brief Key checks made once per batch; the path itself comes from the key's plan
+ */
+static int rsa_4096_batch_check(const rsa_4096_key_t *key, rsa_4096_exp_path_t path) {
+    if (path == RSA_4096_PATH_CRT) {
+        return 0;
+    }
+    if (bigint_is_zero(&key->n)) {
+        ERROR_RETURN(-3, "Key has no modulus");
+    }
+    if (path == RSA_4096_PATH_CONSTTIME && !key->mont_ctx.is_active) {
+        ERROR_RETURN(-5, "Constant-time decryption requires an active Montgomery context");
+    }
+    return 0;
+}
+
+/**
+ * @brief A group of reduced inputs through the multi-buffer engine
+ * 
+ * Montgomery and variable-time CRT plans share one exponent per prime, so
+ * all inputs run in lockstep; any failure (and every other path) falls
+ * back to rsa_4096_key_exp one input at a time.
+ */
+static void rsa_4096_batch_exp_lockstep(bigint_t *results, const bigint_t *inputs, int *status, int count,
+                                        const rsa_4096_key_t *key, rsa_4096_exp_path_t path) {
+    int ret = -1;
+    
+    /* Short exponents only batch when a vector kernel beats the per-item fast path */
+    int lockstep = path == RSA_4096_PATH_MONTGOMERY ||
+                   (path == RSA_4096_PATH_SHORT_EXP && rsa_4096_simd_lanes(rsa_4096_simd_kernel()) > 1);
+    if (count > 1 && lockstep) {
+        ret = montgomery_exp_multi(results, inputs, count, &key->exponent, &key->mont_ctx);
+    } else if (count > 1 && path == RSA_4096_PATH_CRT && !key->constant_time) {
+        const rsa_4096_crt_t *crt = &key->crt;
+        bigint_t m1[RSA_4096_SIMD_MAX_LANES], m2[RSA_4096_SIMD_MAX_LANES];
+        ret = 0;
+        for (int i = 0; i < count && ret == 0; i++) {
+            ret = montgomery_mod(&m1[i], &inputs[i], &crt->mont_p);
+            if (ret == 0) {
+                ret = montgomery_mod(&m2[i], &inputs[i], &crt->mont_q);
+            }
+        }
+        if (ret == 0) ret = montgomery_exp_multi(m1, m1, count, &crt->dp, &crt->mont_p);
+        if (ret == 0) ret = montgomery_exp_multi(m2, m2, count, &crt->dq, &crt->mont_q);
+        for (int i = 0; i < count && ret == 0; i++) {
+            status[i] = rsa_4096_crt_combine(&results[i], &m1[i], &m2[i], crt);
+        }
+        if (ret == 0) {
+            return;
+        }
+    }
+    
+    if (ret == 0) {
+        for (int i = 0; i < count; i++) {
+            status[i] = 0;
+        }
+        return;
+    }
+    for (int i = 0; i < count; i++) {
+        status[i] = rsa_4096_key_exp(&results[i], &inputs[i], key, path, NULL);
+    }
+}
+
+/**
+ * @brief rsa_4096_batch_exp_lockstep, with each input blinded first when blind is set
+ * 
+ * inputs are modified in place while blinding.
+ */
+static void rsa_4096_batch_exp_group(bigint_t *results, bigint_t *inputs, int *status, int count,
+                                     const rsa_4096_key_t *key, rsa_4096_exp_path_t path, int blind) {
+    bigint_t unblind[RSA_4096_SIMD_MAX_LANES];
+    
+    for (int i = 0; blind && i < count; i++) {
+        int ret = rsa_4096_blind(&inputs[i], &unblind[i], key);
+        if (ret != 0) {
+            for (int k = 0; k < count; k++) {
+                status[k] = ret;
+            }
+            return;
+        }
+    }
+    
+    rsa_4096_batch_exp_lockstep(results, inputs, status, count, key, path);
+    
+    for (int i = 0; blind && i < count; i++) {
+        if (status[i] == 0) {
+            status[i] = montgomery_mul(&results[i], &results[i], &unblind[i], &key->mont_ctx);
+        }
+    }
+}
+
+/**
+ * @brief Validate one item and read its input (< n); the outcome is also left in item->status
+ */
+static int rsa_4096_batch_parse(rsa_4096_batch_item_t *item, const rsa_4096_key_t *key, bigint_t *input) {
+    int ret;
+    
+    item->output_size = 0;
+    if (item->input == NULL || item->output == NULL) {
+        ret = -1;
+    } else if (item->input_size == 0 || item->output_buffer_size == 0) {
+        ret = -2;
+    } else if ((ret = bigint_from_binary(input, item->input, item->input_size)) == 0 &&
+               bigint_compare(input, &key->n) >= 0) {
+        ret = -4;
+    }
+    
+    item->status = ret;
+    return ret;
+}
+
+/**
+ * @brief Run every item through the plan; failures are recorded per item
+ * 
+ * Items are parsed and exponentiated in groups of RSA_4096_SIMD_MAX_LANES
+ * so the multi-buffer engine sees as many independent inputs as it can.
+ */
+static int rsa_4096_batch_run(const rsa_4096_key_t *key, rsa_4096_exp_path_t path, int blind,
+                              rsa_4096_batch_item_t *items, size_t count) {
+    size_t failed = 0;
+    
+    for (size_t start = 0; start < count; start += RSA_4096_SIMD_MAX_LANES) {
+        size_t chunk = count - start < RSA_4096_SIMD_MAX_LANES ? count - start : RSA_4096_SIMD_MAX_LANES;
+        bigint_t inputs[RSA_4096_SIMD_MAX_LANES], results[RSA_4096_SIMD_MAX_LANES];
+        int status[RSA_4096_SIMD_MAX_LANES];
+        size_t index[RSA_4096_SIMD_MAX_LANES];
+        int ready = 0;
+        
+        for (size_t i = start; i < start + chunk; i++) {
+            if (rsa_4096_batch_parse(&items[i], key, &inputs[ready]) == 0) {
+                index[ready++] = i;
+            }
+        }
+        
+        if (ready > 0) {
+            rsa_4096_batch_exp_group(results, inputs, status, ready, key, path, blind);
+        }
+        for (int k = 0; k < ready; k++) {
+            rsa_4096_batch_item_t *item = &items[index[k]];
+            item->status = status[k];
+            if (status[k] == 0) {
+                item->status = bigint_to_binary(&results[k], item->output, item->output_buffer_size, &item->output_size);
+            }
+        }
+        for (size_t i = start; i < start + chunk; i++) {
+            if (items[i].status != 0) {
+                failed++;
+            }
+        }
+    }
+    
+    if (failed > 0) {
+        ERROR_RETURN(-6, "%zu of %zu batch items failed", failed, count);
+    }
+    return 0;
+}
+
+/**
+ * @brief Encrypt many messages with one public key: c_i = m_i^e mod n
+ * 
+ * Unlike rsa_4096_encrypt_binary, a message >= n is rejected (status -4)
+ * rather than truncated.
+ */
+int rsa_4096_encrypt_batch(const rsa_4096_key_t *pub_key, rsa_4096_batch_item_t *items, size_t count) {
+    if (pub_key == NULL || (items == NULL && count > 0)) {
+        ERROR_RETURN(-1, "NULL pointer in rsa_4096_encrypt_batch");
+    }
+    
+    if (bigint_is_zero(&pub_key->exponent)) {
+        ERROR_RETURN(-2, "Encryption requires a public exponent");
+    }
+    
+    rsa_4096_exp_path_t path = rsa_4096_key_path(pub_key, 0);
+    int ret = rsa_4096_batch_check(pub_key, path);
+    if (ret != 0) {
+        return ret;
+    }
+    
+    CHECKPOINT(LOG_INFO, "Batch encryption of %zu messages (%s)", count, rsa_4096_path_name(path));
+    return rsa_4096_batch_run(pub_key, path, 0, items, count);
+}
+
+/**
+ * @brief Decrypt many ciphertexts with one private key (CRT when available)
+ */
+int rsa_4096_decrypt_batch(const rsa_4096_key_t *priv_key, rsa_4096_batch_item_t *items, size_t count) {
+    if (priv_key == NULL || (items == NULL && count > 0)) {
+        ERROR_RETURN(-1, "NULL pointer in rsa_4096_decrypt_batch");
+    }
+    
+    if (!priv_key->is_private) {
+        ERROR_RETURN(-2, "Decryption requires private key");
+    }
+    
+    rsa_4096_exp_path_t path = rsa_4096_key_path(priv_key, 1);
+    int ret = rsa_4096_batch_check(priv_key, path);
+    if (ret != 0) {
+        return ret;
+    }
+    
+    CHECKPOINT(LOG_INFO, "Batch decryption of %zu ciphertexts (%s)", count, rsa_4096_path_name(path));
+    return rsa_4096_batch_run(priv_key, path, priv_key->blinding, items, count);
+}
+
+/* ===================== COOPERATIVE JOBS ===================== */
+
+/*
+ * One item at a time on the caller's thread, in slices: each Montgomery
+ * exponentiation of the key's plan runs as a montgomery_exp_job_t, CRT
+ * keys as two of them (p, then q) before Garner recombination. Parsing,
+ * blinding and the result encoding are the batch API's, so a job yields
+ * exactly what rsa_4096_*_batch would for the same item. Traditional and
+ * hand-built (no plan) keys have no sliced form and finish in one step.
+ */
+
+/**
+ * @brief Start one exponentiation of the job, constant-time or over a recoding
+ */
+static int rsa_4096_job_exp_init(rsa_4096_job_t *job, const bigint_t *base, const bigint_t *exp,
+                                 const montgomery_exp_recoding_t *rec, const montgomery_ctx_t *ctx,
+                                 int constant_time) {
+    if (constant_time) {
+        return montgomery_exp_job_init_consttime(&job->exp, base, exp, ctx);
+    }
+    if (rec == NULL || rec->window_bits == 0) {
+        int ret = montgomery_exp_recode(&job->rec, exp, MONTGOMERY_WINDOW_AUTO);
+        if (ret != 0) {
+            return ret;
+        }
+        rec = &job->rec;
+    }
+    return montgomery_exp_job_init(&job->exp, base, rec, ctx);
+}
+
+/**
+ * @brief Unblind and encode the result (or record the failure); the job is done either way
+ */
+static int rsa_4096_job_complete(rsa_4096_job_t *job, bigint_t *result, int status) {
+    rsa_4096_batch_item_t *item = job->item;
+    if (status == 0 && job->blinded) {
+        status = montgomery_mul(result, result, &job->unblind, &job->key->mont_ctx);
+    }
+    if (status == 0) {
+        status = bigint_to_binary(result, item->output, item->output_buffer_size, &item->output_size);
+    }
+    item->status = status;
+    job->stage = RSA_4096_JOB_DONE;
+    return 1;
+}
+
+/**
+ * @brief Validate and parse the item, blind it and start the first exponentiation
+ * 
+ * Item errors (the batch API's -1/-2/-4, or a failed setup) finish the job
+ * at once: the first step returns 1 with item->status set.
+ * 
+ * @return 0, or negative for an unusable job, key or operation
+ */
+int rsa_4096_job_start(rsa_4096_job_t *job, rsa_4096_op_t op, const rsa_4096_key_t *key, rsa_4096_batch_item_t *item) {
+    if (job == NULL || key == NULL || item == NULL) {
+        ERROR_RETURN(-1, "NULL pointer in rsa_4096_job_start");
+    }
+    if (op != RSA_4096_OP_ENCRYPT && op != RSA_4096_OP_DECRYPT) {
+        item->status = -2;
+        ERROR_RETURN(-2, "Unknown job operation %d", (int)op);
+    }
+    if (op == RSA_4096_OP_DECRYPT && !key->is_private) {
+        item->status = -2;
+        ERROR_RETURN(-2, "Decryption requires private key");
+    }
+    if (op == RSA_4096_OP_ENCRYPT && bigint_is_zero(&key->exponent)) {
+        item->status = -2;
+        ERROR_RETURN(-2, "Encryption requires a public exponent");
+    }
+    
+    int is_private = op == RSA_4096_OP_DECRYPT;
+    job->key = key;
+    job->item = item;
+    job->path = rsa_4096_key_path(key, is_private);
+    job->stage = RSA_4096_JOB_DONE;
+    job->blinded = 0;
+    
+    int ret = rsa_4096_batch_check(key, job->path);
+    if (ret != 0) {
+        item->status = ret;
+        return ret;
+    }
+    if (rsa_4096_batch_parse(item, key, &job->input) != 0) {
+        return 0;
+    }
+    
+    if (is_private && key->blinding) {
+        ret = rsa_4096_blind(&job->input, &job->unblind, key);
+        if (ret != 0) {
+            item->status = ret;
+            return 0;
+        }
+        job->blinded = 1;
+    }
+    
+    bigint_t result;
+    switch (job->path) {
+    case RSA_4096_PATH_CRT: {
+        bigint_t c_p;
+        ret = montgomery_mod(&c_p, &job->input, &key->crt.mont_p);
+        if (ret == 0) ret = rsa_4096_job_exp_init(job, &c_p, &key->crt.dp, &key->plan.dp,
+                                                  &key->crt.mont_p, key->constant_time);
+        job->stage = RSA_4096_JOB_P;
+        break;
+    }
+    case RSA_4096_PATH_CONSTTIME:
+        ret = rsa_4096_job_exp_init(job, &job->input, &key->exponent, NULL, &key->mont_ctx, 1);
+        job->stage = RSA_4096_JOB_FULL;
+        break;
+    case RSA_4096_PATH_SHORT_EXP:
+    case RSA_4096_PATH_MONTGOMERY:
+        ret = rsa_4096_job_exp_init(job, &job->input, &key->exponent,
+                                    job->path == RSA_4096_PATH_MONTGOMERY ? &key->plan.exponent : NULL,
+                                    &key->mont_ctx, 0);
+        job->stage = RSA_4096_JOB_FULL;
+        break;
+    default:
+        ret = rsa_4096_key_exp(&result, &job->input, key, job->path, NULL);
+        rsa_4096_job_complete(job, &result, ret);
+        return 0;
+    }
+    
+    if (ret != 0) {
+        item->status = ret;
+        job->stage = RSA_4096_JOB_DONE;
+    }
+    return 0;
+}
+
+/**
+ * @brief Run about max_bits more exponent bits (each one squaring)
+ * 
+ * A slice ends early where one CRT half hands over to the other.
+ * 
+ * @return 1 once the item is final (see item->status), 0 when more steps are needed
+ */
+int rsa_4096_job_step(rsa_4096_job_t *job, int max_bits) {
+    if (job == NULL || job->key == NULL || job->item == NULL) {
+        ERROR_RETURN(-1, "NULL pointer in rsa_4096_job_step");
+    }
+    if (job->stage == RSA_4096_JOB_DONE) {
+        return 1;
+    }
+    
+    int ret = montgomery_exp_job_step(&job->exp, max_bits);
+    if (ret == 0) {
+        return 0;
+    }
+    
+    const rsa_4096_key_t *key = job->key;
+    bigint_t result;
+    if (ret < 0) {
+        return rsa_4096_job_complete(job, &result, ret);
+    }
+    
+    switch (job->stage) {
+    case RSA_4096_JOB_P: {
+        bigint_t c_q;
+        ret = montgomery_exp_job_finish(&job->exp, &job->m1);
+        if (ret == 0) ret = montgomery_mod(&c_q, &job->input, &key->crt.mont_q);
+        if (ret == 0) ret = rsa_4096_job_exp_init(job, &c_q, &key->crt.dq, &key->plan.dq,
+                                                  &key->crt.mont_q, key->constant_time);
+        if (ret != 0) {
+            return rsa_4096_job_complete(job, &result, ret);
+        }
+        job->stage = RSA_4096_JOB_Q;
+        return 0;
+    }
+    case RSA_4096_JOB_Q: {
+        bigint_t m2;
+        ret = montgomery_exp_job_finish(&job->exp, &m2);
+        if (ret == 0) ret = rsa_4096_crt_combine(&result, &job->m1, &m2, &key->crt);
+        return rsa_4096_job_complete(job, &result, ret);
+    }
+    default:
+        ret = montgomery_exp_job_finish(&job->exp, &result);
+        return rsa_4096_job_complete(job, &result, ret);
+    }
+}
+
+/* ===================== STREAMING ===================== */
+
+/**
+ * @brief Run the buffered blocks through the batch engine and hand the output to the sink
+ */
+static int rsa_4096_stream_flush(rsa_4096_stream_t *stream) {
+    if (stream->ready == 0) {
+        return 0;
+    }
+    
+    const rsa_4096_key_t *key = stream->key;
+    const int decrypt = stream->op == RSA_4096_OP_DECRYPT;
+    bigint_t results[RSA_4096_SIMD_MAX_LANES];
+    int status[RSA_4096_SIMD_MAX_LANES];
+    rsa_4096_batch_exp_group(results, stream->inputs, status, stream->ready, key, stream->path,
+                             decrypt && key->blinding);
+    
+    size_t out = 0;
+    for (int i = 0; i < stream->ready; i++) {
+        if (status[i] != 0) {
+            ERROR_RETURN(status[i], "Stream block %" PRIu64 " failed", stream->blocks + (uint64_t)i);
+        }
+        size_t bytes = (size_t)(bigint_bit_length(&results[i]) + 7) / 8, written = 0;
+        uint8_t *dst = stream->output + out;
+        if (!decrypt) {
+            /* Ciphertext blocks are always k bytes, left-padded with zeros */
+            memset(dst, 0, stream->modulus_bytes - bytes);
+            if (bytes > 0) {
+                bigint_to_binary(&results[i], dst + stream->modulus_bytes - bytes, bytes, &written);
+            }
+            out += stream->modulus_bytes;
+        } else {
+            /* 0x01 marker, then at most k - 2 data bytes */
+            if (bytes < 1 || bytes > stream->data_bytes + 1 ||
+                bigint_to_binary(&results[i], dst, stream->data_bytes + 1, &written) != 0 || dst[0] != 0x01) {
+                ERROR_RETURN(-7, "Stream block %" PRIu64 " is not in the stream block format",
+                             stream->blocks + (uint64_t)i);
+            }
+            memmove(dst, dst + 1, written - 1);
+            out += written - 1;
+        }
+    }
+    
+    stream->blocks += (uint64_t)stream->ready;
+    stream->ready = 0;
+    if (out > 0) {
+        int ret = stream->sink(stream->sink_user, stream->output, out);
+        if (ret != 0) {
+            ERROR_RETURN(-8, "Stream sink failed (code %d)", ret);
+        }
+        stream->bytes_out += out;
+    }
+    return 0;
+}
+
+/**
+ * @brief Queue one input block read straight from src (len <= the stream's input block)
+ */
+static int rsa_4096_stream_block(rsa_4096_stream_t *stream, const uint8_t *src, size_t len) {
+    bigint_t *block = &stream->inputs[stream->ready];
+    int ret = bigint_from_binary(block, src, len);
+    if (ret != 0) {
+        ERROR_RETURN(ret, "Failed to load stream block");
+    }
+    if (stream->op == RSA_4096_OP_ENCRYPT) {
+        /* Prefix the 0x01 marker byte: block = 2^(8*len) + data */
+        int bit = 8 * (int)len;
+        block->words[bit / BIGINT_WORD_SIZE] |= (bigint_word_t)1 << (bit % BIGINT_WORD_SIZE);
+        if (block->used <= bit / BIGINT_WORD_SIZE) {
+            block->used = bit / BIGINT_WORD_SIZE + 1;
+        }
+    } else if (bigint_compare(block, &stream->key->n) >= 0) {
+        ERROR_RETURN(-4, "Stream ciphertext block must be less than modulus");
+    }
+    
+    if (++stream->ready == RSA_4096_SIMD_MAX_LANES) {
+        return rsa_4096_stream_flush(stream);
+    }
+    return 0;
+}
+
+/**
+ * @brief Start encrypting (public key) or decrypting (private key) a stream of any length
+ * 
+ * The stream needs a modulus of at least 3 bytes and at most RSA_4096_STREAM_BLOCK_MAX.
+ */
+int rsa_4096_stream_init(rsa_4096_stream_t *stream, const rsa_4096_key_t *key, rsa_4096_op_t op,
+                         rsa_4096_stream_sink_t sink, void *sink_user) {
+    if (stream == NULL || key == NULL || sink == NULL) {
+        ERROR_RETURN(-1, "NULL pointer in rsa_4096_stream_init");
+    }
+    memset(stream, 0, sizeof(*stream));
+    
+    if (op == RSA_4096_OP_DECRYPT && !key->is_private) {
+        ERROR_RETURN(-2, "Decryption requires private key");
+    }
+    if (op == RSA_4096_OP_ENCRYPT && bigint_is_zero(&key->exponent)) {
+        ERROR_RETURN(-2, "Encryption requires a public exponent");
+    }
+    size_t k = (size_t)(bigint_bit_length(&key->n) + 7) / 8;
+    if (k < 3 || k > RSA_4096_STREAM_BLOCK_MAX) {
+        ERROR_RETURN(-3, "Stream needs a modulus of 3 to %d bytes (got %zu)", RSA_4096_STREAM_BLOCK_MAX, k);
+    }
+    
+    rsa_4096_exp_path_t path = rsa_4096_key_path(key, op == RSA_4096_OP_DECRYPT);
+    int ret = rsa_4096_batch_check(key, path);
+    if (ret != 0) {
+        return ret;
+    }
+    
+    stream->key = key;
+    stream->op = op;
+    stream->path = path;
+    stream->modulus_bytes = k;
+    stream->data_bytes = k - 2;
+    stream->sink = sink;
+    stream->sink_user = sink_user;
+    CHECKPOINT(LOG_INFO, "Stream %s: %zu-byte blocks (%s)", op == RSA_4096_OP_DECRYPT ? "decryption" : "encryption",
+               k, rsa_4096_path_name(path));
+    return 0;
+}
+
+/**
+ * @brief Feed input; whole blocks are read in place and only a trailing partial block is copied
+ */
+int rsa_4096_stream_update(rsa_4096_stream_t *stream, const uint8_t *data, size_t len) {
+    if (stream == NULL || stream->key == NULL || (data == NULL && len > 0)) {
+        ERROR_RETURN(-1, "NULL pointer or uninitialized stream in rsa_4096_stream_update");
+    }
+    if (stream->error != 0) {
+        return stream->error;
+    }
+    
+    const size_t block = stream->op == RSA_4096_OP_ENCRYPT ? stream->data_bytes : stream->modulus_bytes;
+    int ret = 0;
+    stream->bytes_in += len;
+    
+    while (len > 0 && ret == 0) {
+        if (stream->partial_size > 0 || len < block) {
+            size_t take = block - stream->partial_size < len ? block - stream->partial_size : len;
+            memcpy(stream->partial + stream->partial_size, data, take);
+            stream->partial_size += take;
+            data += take;
+            len -= take;
+            if (stream->partial_size == block) {
+                stream->partial_size = 0;
+                ret = rsa_4096_stream_block(stream, stream->partial, block);
+            }
+        } else {
+            ret = rsa_4096_stream_block(stream, data, block);
+            data += block;
+            len -= block;
+        }
+    }
+    
+    stream->error = ret;
+    return ret;
+}
+
+/**
+ * @brief Encrypt or decrypt whatever is buffered and clear the stream's plaintext
+ * 
+ * A decryption stream must have been fed a whole number of k-byte blocks.
+ */
+int rsa_4096_stream_final(rsa_4096_stream_t *stream) {
+    if (stream == NULL || stream->key == NULL) {
+        ERROR_RETURN(-1, "NULL pointer or uninitialized stream in rsa_4096_stream_final");
+    }
+    
+    int ret = stream->error;
+    if (ret == 0 && stream->partial_size > 0) {
+        if (stream->op == RSA_4096_OP_DECRYPT) {
+            CHECKPOINT(LOG_ERROR, "Ciphertext ends with a partial %zu-byte block", stream->partial_size);
+            ret = -6;
+        } else {
+            ret = rsa_4096_stream_block(stream, stream->partial, stream->partial_size);
+        }
+    }
+    if (ret == 0) {
+        ret = rsa_4096_stream_flush(stream);
+    }
+    
+    stream->error = ret != 0 ? ret : -9;   /* Further updates need a new init */
+    memset(stream->partial, 0, sizeof(stream->partial));
+    memset(stream->inputs, 0, sizeof(stream->inputs));
+    memset(stream->output, 0, sizeof(stream->output));
+    stream->partial_size = 0;
+    stream->ready = 0;
+    return ret;
+}
+
+/**
+ * @brief Output bytes for input_size bytes of input (exact for encryption, an upper bound for decryption)
+ */
+size_t rsa_4096_stream_output_size(const rsa_4096_stream_t *stream, size_t input_size) {
+    if (stream == NULL || stream->key == NULL) {
+        return 0;
+    }
+    if (stream->op == RSA_4096_OP_ENCRYPT) {
+        return (input_size + stream->data_bytes - 1) / stream->data_bytes * stream->modulus_bytes;
+    }
+    return input_size / stream->modulus_bytes * stream->data_bytes;
+}
+
+int rsa_4096_stream_buffer_sink(void *user, const uint8_t *data, size_t len) {
+    rsa_4096_stream_buffer_t *buf = (rsa_4096_stream_buffer_t *)user;
+    if (buf == NULL || len > buf->capacity - buf->size) {
+        return -1;
+    }
+    memcpy(buf->data + buf->size, data, len);
+    buf->size += len;
+    return 0;
+}
+
+int rsa_4096_stream_fd_sink(void *user, const uint8_t *data, size_t len) {
+    const int fd = user != NULL ? *(const int *)user : -1;
+    while (len > 0) {
+        ssize_t n = write(fd, data, len);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return -1;
+        }
+        data += n;
+        len -= (size_t)n;
+    }
+    return 0;
+}
@@ -0,0 +1,541 @@
+/**
+ * @file rsa_4096_keygen.c
+ * @brief RSA Key Generation - Sieved Probable-Prime Search on the Montgomery Engine
+ *
+ * A prime search draws a random odd start x with its top two bits set and
+ * walks x, x + 2, x + 4, ... A table holds x + delta mod every odd prime
+ * below KEYGEN_SIEVE_LIMIT; moving to the next candidate adds 2 to each
+ * residue (one compare-and-subtract, no division), and a zero residue
+ * rejects the candidate without touching the big integers. Survivors get
+ * Miller-Rabin rounds, each a sliced montgomery_exp_job over the recoded
+ * odd part of w - 1.
+ *
+ * Key generation searches p and q at the same time: the calling thread and
+ * one task per pool worker each walk their own random starts and deposit
+ * primes into a shared slot pair. Once both are filled, every searcher sees
+ * the stop flag at its next candidate or exponentiation slice. The primes
+ * then go through rsa_4096_load_crt_key_binary, so the result is a CRT key
+ * with its plan built exactly as for a loaded one.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include "rsa_4096.h"
+
+/* ===================== SMALL-PRIME SIEVE ===================== */
+
+#define KEYGEN_SIEVE_LIMIT  65536     /* Residues and primes fit in 16 bits */
+#define KEYGEN_SIEVE_PRIMES 6541      /* Odd primes below KEYGEN_SIEVE_LIMIT */
+#define KEYGEN_MAX_DELTA    (1 << 16) /* Walk this far from a start before drawing a new one */
+#define KEYGEN_SLICE_BITS   256       /* Exponent bits between checks of the stop flag */
+
+#define KEYGEN_COMPOSITE 0
+#define KEYGEN_PRIME     1
+#define KEYGEN_CANCELLED 2
+
+static uint16_t keygen_primes[KEYGEN_SIEVE_PRIMES];
+static int keygen_prime_count;
+static pthread_once_t keygen_primes_once = PTHREAD_ONCE_INIT;
+
+static void keygen_build_primes(void) {
+    static uint8_t composite[KEYGEN_SIEVE_LIMIT];
+    for (uint32_t i = 3; i < KEYGEN_SIEVE_LIMIT; i += 2) {
+        if (composite[i]) {
+            continue;
+        }
+        keygen_primes[keygen_prime_count++] = (uint16_t)i;
+        for (uint32_t j = i * i; j < KEYGEN_SIEVE_LIMIT; j += 2 * i) {
+            composite[j] = 1;
+        }
+    }
+}
+
+/**
+ * @brief x mod m for a 16-bit m, 32 bits at a time from the top limb down
+ */
+static uint32_t keygen_mod_small(const bigint_t *x, uint32_t m) {
+    uint64_t r = 0;
+    for (int i = x->used - 1; i >= 0; i--) {
+        for (int shift = BIGINT_WORD_SIZE - 32; shift >= 0; shift -= 32) {
+            r = ((r << 32) | (uint32_t)(x->words[i] >> shift)) % m;
+        }
+    }
+    return (uint32_t)r;
+}
+
+/**
+ * @brief Advance every residue by step; non-zero when some prime now divides the candidate
+ */
+static int keygen_sieve_step(uint16_t *residues, unsigned step) {
+    int hit = 0;
+    for (int i = 0; i < keygen_prime_count; i++) {
+        unsigned v = residues[i] + step;
+        v = v >= keygen_primes[i] ? v - keygen_primes[i] : v;
+        residues[i] = (uint16_t)v;
+        hit |= v == 0;
+    }
+    return hit;
+}
+
+/**
+ * @brief Uniform value of at most bits bits from the system CSPRNG
+ */
+static int keygen_random_bits(bigint_t *r, int bits) {
+    const int words = (bits + BIGINT_WORD_SIZE - 1) / BIGINT_WORD_SIZE;
+    bigint_init(r);
+    int ret = rsa_4096_random_bytes((uint8_t *)r->words, (size_t)words * sizeof(bigint_word_t));
+    if (ret != 0) {
+        ERROR_RETURN(-4, "No randomness for key generation");
+    }
+    if (bits % BIGINT_WORD_SIZE) {
+        r->words[words - 1] &= ((bigint_word_t)1 << (bits % BIGINT_WORD_SIZE)) - 1;
+    }
+    r->used = words;
+    bigint_normalize(r);
+    return 0;
+}
+
+/* ===================== MILLER-RABIN ===================== */
+
+/**
+ * @brief Rounds for a random candidate of the given size, worst-case error at most 2^-128
+ *
+ * Damgard-Landrock-Pomerance bounds (the values OpenSSL uses); noticeably
+ * fewer rounds than a worst-case 4^-t bound, which only adversarial inputs need.
+ */
+static int keygen_mr_rounds(int bits) {
+    if (bits >= 3747) return 3;
+    if (bits >= 1345) return 4;
+    if (bits >= 476) return 5;
+    if (bits >= 400) return 6;
+    if (bits >= 347) return 7;
+    if (bits >= 308) return 8;
+    if (bits >= 55) return 27;
+    return 34;
+}
+
+/* Per-searcher state, heap-allocated: the window table alone is tens of kilobytes */
+typedef struct {
+    montgomery_ctx_t ctx;
+    montgomery_exp_recoding_t rec;
+    montgomery_exp_job_t job;
+} keygen_mr_t;
+
+/**
+ * @brief Miller-Rabin on an odd w > 3 with random bases in [2, 2^(bits(w)-1))
+ *
+ * @param stop Checked between exponentiation slices; NULL never cancels
+ * @return KEYGEN_PRIME, KEYGEN_COMPOSITE, KEYGEN_CANCELLED, or negative on error
+ */
+static int keygen_miller_rabin(keygen_mr_t *mr, const bigint_t *w, int rounds, const int *stop) {
+    const montgomery_ctx_t *ctx = &mr->ctx;
+    bigint_t one, w1, d, a, x, y, mont_one, mont_w1;
+    const int bits = bigint_bit_length(w);
+
+    int ret = montgomery_ctx_init(&mr->ctx, w);
+    if (ret != 0 || !mr->ctx.is_active) {
+        ERROR_RETURN(-5, "Montgomery context failed for a %d-bit candidate (code %d)", bits, ret);
+    }
+
+    /* w - 1 = d * 2^s with d odd */
+    bigint_set_u32(&one, 1);
+    ret = bigint_sub(&w1, w, &one);
+    int s = 1;
+    while (ret == 0 && !bigint_get_bit(&w1, s)) {
+        s++;
+    }
+    if (ret == 0) ret = bigint_shift_right(&d, &w1, s);
+    if (ret == 0) ret = montgomery_exp_recode(&mr->rec, &d, MONTGOMERY_WINDOW_AUTO);
+    if (ret == 0) ret = montgomery_to_form(&mont_one, &one, ctx);
+    if (ret == 0) ret = montgomery_to_form(&mont_w1, &w1, ctx);
+    if (ret != 0) {
+        ERROR_RETURN(-5, "Miller-Rabin setup failed (code %d)", ret);
+    }
+
+    for (int round = 0; round < rounds; round++) {
+        do {
+            ret = keygen_random_bits(&a, bits - 1);
+            if (ret != 0) {
+                return ret;
+            }
+        } while (a.used == 0 || (a.used == 1 && a.words[0] < 2));
+
+        ret = montgomery_exp_job_init(&mr->job, &a, &mr->rec, ctx);
+        while (ret == 0) {
+            if (stop != NULL && __atomic_load_n(stop, __ATOMIC_RELAXED)) {
+                return KEYGEN_CANCELLED;
+            }
+            ret = montgomery_exp_job_step(&mr->job, KEYGEN_SLICE_BITS);
+        }
+        if (ret < 0 || (ret = montgomery_exp_job_finish(&mr->job, &x)) != 0) {
+            ERROR_RETURN(-5, "Miller-Rabin exponentiation failed (code %d)", ret);
+        }
+        if (bigint_is_one(&x) || bigint_compare(&x, &w1) == 0) {
+            continue;
+        }
+
+        /* Square up to s - 1 times looking for -1; reaching 1 first exposes a composite */
+        int witness = 1;
+        ret = montgomery_to_form(&y, &x, ctx);
+        for (int j = 1; ret == 0 && j < s; j++) {
+            ret = montgomery_square(&y, &y, ctx);
+            if (ret == 0 && bigint_compare(&y, &mont_w1) == 0) {
+                witness = 0;
+                break;
+            }
+            if (ret == 0 && bigint_compare(&y, &mont_one) == 0) {
+                break;
+            }
+        }
+        if (ret != 0) {
+            ERROR_RETURN(-5, "Miller-Rabin squaring failed (code %d)", ret);
+        }
+        if (witness) {
+            return KEYGEN_COMPOSITE;
+        }
+    }
+    return KEYGEN_PRIME;
+}
+
+/**
+ * @brief Probable-prime test: trial division by the sieve primes, then Miller-Rabin
+ *
+ * @param rounds Miller-Rabin rounds, or 0 for the 2^-128 count for w's size
+ * @return 1 for a probable prime, 0 for a composite, negative on error
+ */
+int rsa_4096_is_probable_prime(const bigint_t *w, int rounds) {
+    if (w == NULL) {
+        ERROR_RETURN(-1, "NULL pointer in rsa_4096_is_probable_prime");
+    }
+    if (rounds < 0) {
+        ERROR_RETURN(-2, "Invalid Miller-Rabin round count %d", rounds);
+    }
+    pthread_once(&keygen_primes_once, keygen_build_primes);
+
+    if (w->used <= 1 && w->words[0] < 4) {
+        return w->used == 1 && w->words[0] >= 2;
+    }
+    if ((w->words[0] & 1) == 0) {
+        return 0;
+    }
+    for (int i = 0; i < keygen_prime_count; i++) {
+        if (keygen_mod_small(w, keygen_primes[i]) == 0) {
+            return w->used == 1 && w->words[0] == keygen_primes[i];
+        }
+    }
+    /* No factor below 2^16: anything under 2^32 is prime */
+    if (bigint_bit_length(w) <= 32) {
+        return 1;
+    }
+
+    keygen_mr_t *mr = (keygen_mr_t *)malloc(sizeof(*mr));
+    if (mr == NULL) {
+        ERROR_RETURN(-3, "Out of memory for Miller-Rabin state");
+    }
+    int ret = keygen_miller_rabin(mr, w, rounds > 0 ? rounds : keygen_mr_rounds(bigint_bit_length(w)), NULL);
+    free(mr);
+    return ret;
+}
+
+/* ===================== PARALLEL PRIME SEARCH ===================== */
+
+/**
+ * @brief Euclid's gcd; binary_gcd_large caps its iteration count, which is too few for 2048-bit inputs
+ */
+static int keygen_gcd(bigint_t *g, const bigint_t *a, const bigint_t *b) {
+    bigint_t u, v, r;
+    bigint_copy(&u, a);
+    bigint_copy(&v, b);
+    while (!bigint_is_zero(&v)) {
+        int ret = bigint_mod(&r, &u, &v);
+        if (ret != 0) {
+            return ret;
+        }
+        bigint_copy(&u, &v);
+        bigint_copy(&v, &r);
+    }
+    bigint_copy(g, &u);
+    return 0;
+}
+
+typedef struct {
+    pthread_mutex_t lock;
+    int bits;                     /* Size of each prime */
+    const bigint_t *e;
+    int wanted;                   /* Primes to find (1 or 2) */
+    int found;
+    bigint_t primes[2];
+    int stop;                     /* Set once found == wanted or a searcher fails (atomic) */
+    int error;                    /* First searcher failure */
+} keygen_search_t;
+
+static void keygen_stop(keygen_search_t *search, int error) {
+    pthread_mutex_lock(&search->lock);
+    if (error != 0 && search->error == 0) {
+        search->error = error;
+    }
+    __atomic_store_n(&search->stop, 1, __ATOMIC_RELAXED);
+    pthread_mutex_unlock(&search->lock);
+}
+
+/**
+ * @brief |a - b| > 2^(bits - 100), so n cannot be factored from its square root (FIPS 186-4 B.3.3)
+ */
+static int keygen_far_apart(const bigint_t *a, const bigint_t *b, int bits) {
+    bigint_t diff;
+    int ret = bigint_compare(a, b) >= 0 ? bigint_sub(&diff, a, b) : bigint_sub(&diff, b, a);
+    return ret == 0 && bigint_bit_length(&diff) > bits - 100;
+}
+
+/**
+ * @brief Record a prime; the second one must be far enough from the first
+ */
+static void keygen_deposit(keygen_search_t *search, const bigint_t *prime) {
+    pthread_mutex_lock(&search->lock);
+    if (search->found < search->wanted &&
+        (search->found == 0 || keygen_far_apart(&search->primes[0], prime, search->bits))) {
+        bigint_copy(&search->primes[search->found++], prime);
+        if (search->found == search->wanted) {
+            __atomic_store_n(&search->stop, 1, __ATOMIC_RELAXED);
+        }
+    }
+    pthread_mutex_unlock(&search->lock);
+}
+
+/**
+ * @brief One searcher: random starts, incremental sieve, Miller-Rabin, until the search stops
+ */
+static int keygen_searcher(keygen_search_t *search) {
+    const int bits = search->bits;
+    const int rounds = keygen_mr_rounds(bits);
+    keygen_mr_t *mr = (keygen_mr_t *)malloc(sizeof(*mr));
+    uint16_t *residues = (uint16_t *)malloc(sizeof(uint16_t) * KEYGEN_SIEVE_PRIMES);
+    int ret = 0;
+
+    if (mr == NULL || residues == NULL) {
+        free(mr);
+        free(residues);
+        ERROR_RETURN(-3, "Out of memory for a prime searcher");
+    }
+
+    while (ret == 0 && !__atomic_load_n(&search->stop, __ATOMIC_RELAXED)) {
+        /* Top two bits set: p * q has exactly twice the bits; odd */
+        bigint_t start, candidate, p1, g;
+        ret = keygen_random_bits(&start, bits);
+        if (ret != 0) {
+            break;
+        }
+        start.words[(bits - 1) / BIGINT_WORD_SIZE] |= (bigint_word_t)1 << ((bits - 1) % BIGINT_WORD_SIZE);
+        start.words[(bits - 2) / BIGINT_WORD_SIZE] |= (bigint_word_t)1 << ((bits - 2) % BIGINT_WORD_SIZE);
+        start.words[0] |= 1;
+        start.used = (bits + BIGINT_WORD_SIZE - 1) / BIGINT_WORD_SIZE;
+
+        for (int i = 0; i < keygen_prime_count; i++) {
+            residues[i] = (uint16_t)keygen_mod_small(&start, keygen_primes[i]);
+        }
+
+        for (unsigned delta = 0; delta < KEYGEN_MAX_DELTA; delta += 2) {
+            if (keygen_sieve_step(residues, delta == 0 ? 0 : 2)) {
+                continue;
+            }
+            if (__atomic_load_n(&search->stop, __ATOMIC_RELAXED)) {
+                break;
+            }
+            ret = bigint_add_word(&candidate, &start, (bigint_word_t)delta);
+            if (ret != 0 || bigint_bit_length(&candidate) != bits) {
+                break;
+            }
+
+            int verdict = keygen_miller_rabin(mr, &candidate, rounds, &search->stop);
+            if (verdict < 0) {
+                ret = verdict;
+                break;
+            }
+            if (verdict != KEYGEN_PRIME) {
+                continue;
+            }
+
+            /* gcd(e, p - 1) = 1, or e has no inverse modulo lambda(n); quietly, this is routine */
+            bigint_copy(&p1, &candidate);
+            p1.words[0] &= ~(bigint_word_t)1;
+            ret = keygen_gcd(&g, search->e, &p1);
+            if (ret == 0 && bigint_is_one(&g)) {
+                keygen_deposit(search, &candidate);
+            }
+            break;
+        }
+    }
+
+    free(mr);
+    free(residues);
+    if (ret != 0) {
+        keygen_stop(search, ret);
+    }
+    return ret;
+}
+
+static void keygen_search_task(void *arg) {
+    keygen_searcher((keygen_search_t *)arg);
+}
+
+/**
+ * @brief Find `wanted` primes of `bits` bits with every pool worker and the caller searching
+ *
+ * Serial when pool is NULL or the caller is one of its workers (waiting on
+ * tasks queued behind itself could never finish).
+ */
+static int keygen_find_primes(bigint_t *primes, int wanted, int bits, const bigint_t *e, rsa_4096_pool_t *pool) {
+    keygen_search_t search;
+    memset(&search, 0, sizeof(search));
+    pthread_mutex_init(&search.lock, NULL);
+    search.bits = bits;
+    search.e = e;
+    search.wanted = wanted;
+
+    int helpers = 0;
+    rsa_4096_future_t *futures = NULL;
+    if (pool != NULL && !rsa_4096_pool_is_worker(pool)) {
+        futures = (rsa_4096_future_t *)malloc(sizeof(*futures) * (size_t)rsa_4096_pool_size(pool));
+    }
+    if (futures != NULL) {
+        for (helpers = 0; helpers < rsa_4096_pool_size(pool); helpers++) {
+            if (rsa_4096_pool_run(pool, keygen_search_task, &search, &futures[helpers]) != 0) {
+                CHECKPOINT(LOG_ERROR, "Could not queue prime searcher %d, continuing with %d", helpers, helpers);
+                break;
+            }
+        }
+    }
+
+    keygen_searcher(&search);
+
+    /* Always join: the search state lives on this stack frame */
+    for (int i = 0; i < helpers; i++) {
+        rsa_4096_future_wait(&futures[i]);
+    }
+    free(futures);
+
+    int ret = search.error;
+    if (ret == 0 && search.found < wanted) {
+        ret = -5;
+    }
+    for (int i = 0; ret == 0 && i < wanted; i++) {
+        bigint_copy(&primes[i], &search.primes[i]);
+    }
+    pthread_mutex_destroy(&search.lock);
+    if (ret != 0) {
+        ERROR_RETURN(ret, "Prime search failed");
+    }
+    CHECKPOINT(LOG_INFO, "Found %d %d-bit primes with %d searchers", wanted, bits, helpers + 1);
+    return 0;
+}
+
+/* ===================== KEY GENERATION ===================== */
+
+/**
+ * @brief Derive d, dP, dQ and qInv for p > q (FIPS 186-4 B.3.1: d mod lambda(n), d > 2^(bits/2))
+ * @return 0, 1 when d is too small and new primes are needed, negative on error
+ */
+static int keygen_derive(bigint_t *d, bigint_t *dp, bigint_t *dq, bigint_t *qinv,
+                         const bigint_t *p, const bigint_t *q, const bigint_t *e, int bits) {
+    bigint_t one, p1, q1, g, phi, lambda, rem;
+    bigint_set_u32(&one, 1);
+    int ret = bigint_sub(&p1, p, &one);
+    if (ret == 0) ret = bigint_sub(&q1, q, &one);
+    if (ret == 0) ret = keygen_gcd(&g, &p1, &q1);
+    if (ret == 0) ret = bigint_mul(&phi, &p1, &q1);
+    if (ret == 0) ret = bigint_div(&lambda, &rem, &phi, &g);
+    if (ret == 0) ret = mod_inverse_vartime(d, e, &lambda);
+    if (ret != 0) {
+        ERROR_RETURN(-5, "Failed to compute d = e^(-1) mod lambda(n) (code %d)", ret);
+    }
+    if (bigint_bit_length(d) <= bits / 2) {
+        return 1;
+    }
+
+    ret = bigint_mod(dp, d, &p1);
+    if (ret == 0) ret = bigint_mod(dq, d, &q1);
+    if (ret == 0) ret = mod_inverse_vartime(qinv, q, p);
+    if (ret != 0) {
+        ERROR_RETURN(-5, "Failed to compute the CRT parameters (code %d)", ret);
+    }
+    return 0;
+}
+
+/**
+ * @brief Generate an RSA key pair with a bits-bit modulus n = p * q
+ *
+ * priv is a CRT key (its exponent holds d for the fallback path); pub, if
+ * not NULL, is the matching public key (n, e). Both come out of the normal
+ * loaders, so constant-time mode and blinding are off until set.
+ *
+ * @param bits Even, RSA_4096_KEYGEN_MIN_BITS..BIGINT_MAX_BITS
+ * @param e    Odd public exponent of 2..64 bits (lambda(n) * e must fit a bigint_t for
+ *             the even-modulus inverse), NULL for RSA_4096_KEYGEN_DEFAULT_E
+ * @param pool Worker pool to search on as well as the caller, or NULL
+ */
+int rsa_4096_keygen(rsa_4096_key_t *priv, rsa_4096_key_t *pub, int bits, const bigint_t *e, rsa_4096_pool_t *pool) {
+    if (priv == NULL) {
+        ERROR_RETURN(-1, "NULL pointer in rsa_4096_keygen");
+    }
+    if (bits < RSA_4096_KEYGEN_MIN_BITS || bits > BIGINT_MAX_BITS || bits % 2 != 0) {
+        ERROR_RETURN(-2, "Invalid modulus size %d (even, %d-%d bits)", bits, RSA_4096_KEYGEN_MIN_BITS, BIGINT_MAX_BITS);
+    }
+
+    bigint_t default_e;
+    if (e == NULL) {
+        bigint_set_u32(&default_e, RSA_4096_KEYGEN_DEFAULT_E);
+        e = &default_e;
+    }
+    if ((e->words[0] & 1) == 0 || (e->used == 1 && e->words[0] < 3) || bigint_bit_length(e) > 64) {
+        ERROR_RETURN(-3, "Public exponent must be odd, at least 3 and at most 64 bits");
+    }
+    pthread_once(&keygen_primes_once, keygen_build_primes);
+
+    const int half = bits / 2;
+    bigint_t primes[2], d, dp, dq, qinv;
+    int ret = 1;
+    for (int attempt = 0; ret == 1 && attempt < 8; attempt++) {
+        ret = keygen_find_primes(primes, 2, half, e, pool);
+        if (ret == 0 && bigint_compare(&primes[0], &primes[1]) < 0) {
+            bigint_t t;
+            bigint_copy(&t, &primes[0]);
+            bigint_copy(&primes[0], &primes[1]);
+            bigint_copy(&primes[1], &t);
+        }
+        if (ret == 0) ret = keygen_derive(&d, &dp, &dq, &qinv, &primes[0], &primes[1], e, bits);
+    }
+    if (ret != 0) {
+        ERROR_RETURN(ret < 0 ? ret : -5, "Key generation failed");
+    }
+
+    /* Through the binary loaders, so the keys are checked and planned like any loaded key */
+    uint8_t buf[6][BIGINT_MAX_BITS / 8];
+    size_t len[6];
+    const bigint_t *parts[6] = { &primes[0], &primes[1], &dp, &dq, &qinv, e };
+    for (int i = 0; i < 6 && ret == 0; i++) {
+        ret = bigint_to_binary(parts[i], buf[i], sizeof(buf[i]), &len[i]);
+    }
+    if (ret == 0) ret = rsa_4096_load_crt_key_binary(priv, buf[0], len[0], buf[1], len[1], buf[2], len[2],
+                                                     buf[3], len[3], buf[4], len[4]);
+    if (ret == 0) {
+        bigint_copy(&priv->exponent, &d);
+        ret = rsa_4096_key_prepare(priv);
+    }
+    if (ret == 0 && pub != NULL) {
+        uint8_t n_buf[BIGINT_MAX_BITS / 8];
+        size_t n_len;
+        ret = bigint_to_binary(&priv->n, n_buf, sizeof(n_buf), &n_len);
+        if (ret == 0) ret = rsa_4096_load_key_binary(pub, n_buf, n_len, buf[5], len[5], 0);
+    }
+    memset(buf, 0, sizeof(buf));
+    if (ret != 0) {
+        ERROR_RETURN(-5, "Failed to load the generated key (code %d)", ret);
+    }
+
+    CHECKPOINT(LOG_INFO, "Generated a %d-bit RSA key", bigint_bit_length(&priv->n));
+    return 0;
+}
@@ -0,0 +1,440 @@
+/**
+ * @file rsa_4096_keystore.c
+ * @brief Memory-Mapped Key Store for RSA-4096 - Prepared Keys Without Parsing
+ *
+ * rsa_4096_keystore_write dumps loaded keys (everything rsa_4096_load_* and
+ * rsa_4096_key_prepare computed) into one file with a sorted id index;
+ * rsa_4096_keystore_open maps it read-only and checks only the header, so
+ * opening costs the same for ten keys or fifty thousand. Pages are faulted
+ * in as keys are used and stay shared between processes through the page
+ * cache.
+ *
+ * The records are trusted for their values (like any key file) but not for
+ * memory safety: rsa_4096_keystore_get checks every length, count and
+ * recoded digit a record could use to index past its buffers before handing
+ * the key out, a few microseconds against a private operation's milliseconds.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "rsa_4096.h"
+
+#define KEYSTORE_BYTE_ORDER 0x01020304u
+
+/* ===================== LAYOUT FINGERPRINT ===================== */
+
+static uint32_t keystore_mix(uint32_t h, size_t v) {
+    for (int i = 0; i < 4; i++) {
+        h = (h ^ (uint32_t)((v >> (8 * i)) & 0xFF)) * 16777619u;
+    }
+    return h;
+}
+
+#define KEYSTORE_FIELD(h, type, field) keystore_mix(keystore_mix(h, offsetof(type, field)), sizeof(((type *)0)->field))
+
+/**
+ * @brief FNV-1a over the offsets and sizes of every field a record carries
+ *
+ * Catches reordered or resized fields that leave sizeof(rsa_4096_key_t)
+ * unchanged, so a store never opens in a build that would misread it.
+ */
+static uint32_t keystore_layout(void) {
+    uint32_t h = 2166136261u;
+    h = KEYSTORE_FIELD(h, bigint_t, words);
+    h = KEYSTORE_FIELD(h, bigint_t, used);
+    h = KEYSTORE_FIELD(h, bigint_t, sign);
+    h = KEYSTORE_FIELD(h, montgomery_ctx_t, n);
+    h = KEYSTORE_FIELD(h, montgomery_ctx_t, r);
+    h = KEYSTORE_FIELD(h, montgomery_ctx_t, r_squared);
+    h = KEYSTORE_FIELD(h, montgomery_ctx_t, r_inv);
+    h = KEYSTORE_FIELD(h, montgomery_ctx_t, n_prime);
+    h = KEYSTORE_FIELD(h, montgomery_ctx_t, n_words);
+    h = KEYSTORE_FIELD(h, montgomery_ctx_t, r_words);
+    h = KEYSTORE_FIELD(h, montgomery_ctx_t, is_active);
+    h = KEYSTORE_FIELD(h, montgomery_ctx_t, dispatch);
+    h = KEYSTORE_FIELD(h, montgomery_ctx_t, kernel_bits);
+    h = KEYSTORE_FIELD(h, rsa_4096_crt_t, p);
+    h = KEYSTORE_FIELD(h, rsa_4096_crt_t, q);
+    h = KEYSTORE_FIELD(h, rsa_4096_crt_t, dp);
+    h = KEYSTORE_FIELD(h, rsa_4096_crt_t, dq);
+    h = KEYSTORE_FIELD(h, rsa_4096_crt_t, qinv);
+    h = KEYSTORE_FIELD(h, rsa_4096_crt_t, mont_p);
+    h = KEYSTORE_FIELD(h, rsa_4096_crt_t, mont_q);
+    h = KEYSTORE_FIELD(h, rsa_4096_crt_t, is_active);
+    h = KEYSTORE_FIELD(h, montgomery_exp_recoding_t, window_bits);
+    h = KEYSTORE_FIELD(h, montgomery_exp_recoding_t, top);
+    h = KEYSTORE_FIELD(h, montgomery_exp_recoding_t, count);
+    h = KEYSTORE_FIELD(h, montgomery_exp_recoding_t, pos);
+    h = KEYSTORE_FIELD(h, montgomery_exp_recoding_t, digit);
+    h = KEYSTORE_FIELD(h, rsa_4096_exp_plan_t, public_path);
+    h = KEYSTORE_FIELD(h, rsa_4096_exp_plan_t, private_path);
+    h = KEYSTORE_FIELD(h, rsa_4096_exp_plan_t, modulus_bits);
+    h = KEYSTORE_FIELD(h, rsa_4096_exp_plan_t, short_exponent);
+    h = KEYSTORE_FIELD(h, rsa_4096_exp_plan_t, exponent);
+    h = KEYSTORE_FIELD(h, rsa_4096_exp_plan_t, dp);
+    h = KEYSTORE_FIELD(h, rsa_4096_exp_plan_t, dq);
+    h = KEYSTORE_FIELD(h, rsa_4096_key_t, n);
+    h = KEYSTORE_FIELD(h, rsa_4096_key_t, exponent);
+    h = KEYSTORE_FIELD(h, rsa_4096_key_t, mont_ctx);
+    h = KEYSTORE_FIELD(h, rsa_4096_key_t, is_private);
+    h = KEYSTORE_FIELD(h, rsa_4096_key_t, crt);
+    h = KEYSTORE_FIELD(h, rsa_4096_key_t, constant_time);
+    h = KEYSTORE_FIELD(h, rsa_4096_key_t, blinding);
+    h = KEYSTORE_FIELD(h, rsa_4096_key_t, blinding_e);
+    h = KEYSTORE_FIELD(h, rsa_4096_key_t, plan);
+    return h;
+}
+
+/* ===================== RECORD VALIDATION ===================== */
+
+static int keystore_bigint_ok(const bigint_t *a) {
+    return a->used >= 0 && a->used <= BIGINT_4096_WORDS && a->sign == 0;
+}
+
+static int keystore_flag_ok(int flag) {
+    return flag == 0 || flag == 1;
+}
+
+/* An active context must describe its own modulus with in-range counts */
+static int keystore_ctx_ok(const montgomery_ctx_t *ctx, const bigint_t *modulus) {
+    if (!keystore_bigint_ok(&ctx->n) || !keystore_bigint_ok(&ctx->r) || !keystore_bigint_ok(&ctx->r_squared) ||
+        !keystore_bigint_ok(&ctx->r_inv) || !keystore_flag_ok(ctx->is_active)) {
+        return 0;
+    }
+    if (!ctx->is_active) {
+        return 1;
+    }
+    return ctx->n_words > 0 && ctx->n_words < BIGINT_4096_WORDS && ctx->r_words == ctx->n_words &&
+           ctx->n.used == ctx->n_words && (ctx->n.words[0] & 1) && ctx->dispatch >= MONTGOMERY_DISPATCH_INACTIVE &&
+           ctx->dispatch <= MONTGOMERY_DISPATCH_SMALL && bigint_compare(&ctx->n, modulus) == 0;
+}
+
+/* Windows strictly descending from the top, each an odd value the 2^(w-1) entry table holds */
+static int keystore_recoding_ok(const montgomery_exp_recoding_t *rec) {
+    if (rec->window_bits == 0) {
+        return 1;
+    }
+    if (rec->window_bits < MONTGOMERY_WINDOW_MIN || rec->window_bits > MONTGOMERY_WINDOW_MAX ||
+        rec->count < 0 || rec->count > MONTGOMERY_RECODING_WINDOWS ||
+        rec->top != (rec->count > 0 ? rec->pos[0] : -1) || rec->top >= MONTGOMERY_RECODING_BITS) {
+        return 0;
+    }
+    const unsigned int limit = 1u << rec->window_bits;
+    for (int k = 0; k < rec->count; k++) {
+        const unsigned int d = rec->digit[k];
+        if (!(d & 1) || d >= limit || (k > 0 && rec->pos[k] >= rec->pos[k - 1])) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+static int keystore_path_ok(rsa_4096_exp_path_t path) {
+    return path >= RSA_4096_PATH_NONE && path <= RSA_4096_PATH_CRT;
+}
+
+/**
+ * @brief Structural check of a key record: nothing in it can index out of bounds
+ */
+static int keystore_key_ok(const rsa_4096_key_t *key) {
+    const rsa_4096_crt_t *crt = &key->crt;
+    const rsa_4096_exp_plan_t *plan = &key->plan;
+
+    if (!keystore_bigint_ok(&key->n) || !keystore_bigint_ok(&key->exponent) || !keystore_bigint_ok(&key->blinding_e) ||
+        !keystore_flag_ok(key->is_private) || !keystore_flag_ok(key->constant_time) ||
+        !keystore_flag_ok(key->blinding) || !keystore_ctx_ok(&key->mont_ctx, &key->n)) {
+        return 0;
+    }
+    if (!keystore_bigint_ok(&crt->p) || !keystore_bigint_ok(&crt->q) || !keystore_bigint_ok(&crt->dp) ||
+        !keystore_bigint_ok(&crt->dq) || !keystore_bigint_ok(&crt->qinv) || !keystore_flag_ok(crt->is_active) ||
+        !keystore_ctx_ok(&crt->mont_p, &crt->p) || !keystore_ctx_ok(&crt->mont_q, &crt->q)) {
+        return 0;
+    }
+    if (crt->is_active && (!crt->mont_p.is_active || !crt->mont_q.is_active)) {
+        return 0;
+    }
+    return keystore_path_ok(plan->public_path) && keystore_path_ok(plan->private_path) &&
+           keystore_recoding_ok(&plan->exponent) && keystore_recoding_ok(&plan->dp) && keystore_recoding_ok(&plan->dq);
+}
+
+/* ===================== WRITER ===================== */
+
+static size_t keystore_align(size_t v, size_t a) {
+    return (v + a - 1) / a * a;
+}
+
+static int keystore_entry_cmp(const void *pa, const void *pb) {
+    const rsa_4096_keystore_entry_t *a = (const rsa_4096_keystore_entry_t *)pa;
+    const rsa_4096_keystore_entry_t *b = (const rsa_4096_keystore_entry_t *)pb;
+    return (a->id > b->id) - (a->id < b->id);
+}
+
+/* Zero bytes up to the next multiple of align */
+static int keystore_pad(int fd, size_t *offset, size_t align) {
+    static const uint8_t zeros[RSA_4096_KEYSTORE_ALIGN];
+    size_t target = keystore_align(*offset, align);
+    if (target > *offset && rsa_4096_stream_fd_sink(&fd, zeros, target - *offset) != 0) {
+        return -1;
+    }
+    *offset = target;
+    return 0;
+}
+
+/* Header, index and records in file order; offset tracks the bytes written */
+static int keystore_write_fd(int fd, const rsa_4096_keystore_header_t *header,
+                             const rsa_4096_keystore_entry_t *index, const rsa_4096_key_t *const *keys,
+                             uint8_t *record) {
+    size_t offset = 0;
+    if (rsa_4096_stream_fd_sink(&fd, (const uint8_t *)header, sizeof(*header)) != 0) {
+        return -1;
+    }
+    offset += sizeof(*header);
+    if (keystore_pad(fd, &offset, RSA_4096_KEYSTORE_ALIGN) != 0) {
+        return -1;
+    }
+
+    size_t index_bytes = (size_t)header->count * sizeof(rsa_4096_keystore_entry_t);
+    if (index_bytes > 0 && rsa_4096_stream_fd_sink(&fd, (const uint8_t *)index, index_bytes) != 0) {
+        return -1;
+    }
+    offset += index_bytes;
+    if (keystore_pad(fd, &offset, RSA_4096_KEYSTORE_ALIGN) != 0) {
+        return -1;
+    }
+
+    /* Records in input order; the stride padding stays zero */
+    for (uint64_t i = 0; i < header->count; i++) {
+        memcpy(record, keys[i], sizeof(rsa_4096_key_t));
+        if (rsa_4096_stream_fd_sink(&fd, record, (size_t)header->record_stride) != 0) {
+            return -1;
+        }
+    }
+    return fsync(fd) == 0 ? 0 : -1;
+}
+
+/**
+ * @brief Write count prepared keys to a new store at path
+ *
+ * The file is created mode 0600 next to path and renamed over it, so readers
+ * holding the old store keep a consistent mapping.
+ *
+ * @return 0 on success, -1 NULL argument, -2 duplicate id, -3 key i fails the
+ *         structural check, -4 out of memory, -5 I/O error
+ */
+int rsa_4096_keystore_write(const char *path, const rsa_4096_key_t *const *keys, const uint64_t *ids, size_t count) {
+    if (path == NULL || (keys == NULL && count > 0)) {
+        ERROR_RETURN(-1, "NULL pointer in rsa_4096_keystore_write");
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        if (keys[i] == NULL || !keystore_key_ok(keys[i])) {
+            ERROR_RETURN(-3, "Key %zu is not a loaded key", i);
+        }
+    }
+
+    rsa_4096_keystore_header_t header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, RSA_4096_KEYSTORE_MAGIC, sizeof(header.magic));
+    header.version = RSA_4096_KEYSTORE_VERSION;
+    header.byte_order = KEYSTORE_BYTE_ORDER;
+    header.word_bits = BIGINT_WORD_SIZE;
+    header.bigint_words = BIGINT_4096_WORDS;
+    header.key_size = (uint32_t)sizeof(rsa_4096_key_t);
+    header.layout = keystore_layout();
+    header.count = count;
+    header.record_stride = keystore_align(sizeof(rsa_4096_key_t), RSA_4096_KEYSTORE_RECORD_ALIGN);
+    header.index_offset = RSA_4096_KEYSTORE_ALIGN;
+    header.records_offset = header.index_offset +
+                            keystore_align(count * sizeof(rsa_4096_keystore_entry_t), RSA_4096_KEYSTORE_ALIGN);
+    header.file_size = header.records_offset + count * header.record_stride;
+
+    rsa_4096_keystore_entry_t *index = (rsa_4096_keystore_entry_t *)malloc((count ? count : 1) * sizeof(*index));
+    uint8_t *record = (uint8_t *)calloc(1, (size_t)header.record_stride);
+    size_t path_len = strlen(path);
+    char *tmp = (char *)malloc(path_len + 5);
+    if (index == NULL || record == NULL || tmp == NULL) {
+        free(index);
+        free(record);
+        free(tmp);
+        ERROR_RETURN(-4, "Out of memory writing key store");
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        index[i].id = ids != NULL ? ids[i] : (uint64_t)i;
+        index[i].record = i;
+    }
+    qsort(index, count, sizeof(*index), keystore_entry_cmp);
+    for (size_t i = 1; i < count; i++) {
+        if (index[i].id == index[i - 1].id) {
+            unsigned long long dup = (unsigned long long)index[i].id;
+            free(index);
+            free(record);
+            free(tmp);
+            ERROR_RETURN(-2, "Duplicate key id %llu", dup);
+        }
+    }
+
+    memcpy(tmp, path, path_len);
+    memcpy(tmp + path_len, ".tmp", 5);
+    int ret = -5;
+    int fd = open(tmp, O_WRONLY | O_CREAT | O_TRUNC, 0600);
+    if (fd >= 0) {
+        ret = keystore_write_fd(fd, &header, index, keys, record) == 0 ? 0 : -5;
+        if (close(fd) != 0) {
+            ret = -5;
+        }
+        if (ret == 0 && rename(tmp, path) != 0) {
+            ret = -5;
+        }
+        if (ret != 0) {
+            unlink(tmp);
+        }
+    }
+
+    free(index);
+    free(record);
+    free(tmp);
+    if (ret != 0) {
+        ERROR_RETURN(ret, "Failed to write key store %s: %s", path, strerror(errno));
+    }
+
+    CHECKPOINT(LOG_INFO, "Key store %s: %zu keys, %llu bytes", path, count, (unsigned long long)header.file_size);
+    return 0;
+}
+
+/* ===================== READER ===================== */
+
+/**
+ * @brief Map a key store read-only after checking its header against this build
+ *
+ * Only the header is read, so the cost does not grow with the key count.
+ *
+ * @return 0 on success, -1 NULL argument, -2 cannot open or map, -3 not a
+ *         key store or truncated, -4 written by an incompatible build
+ */
+int rsa_4096_keystore_open(rsa_4096_keystore_t *store, const char *path) {
+    if (store == NULL || path == NULL) {
+        ERROR_RETURN(-1, "NULL pointer in rsa_4096_keystore_open");
+    }
+    memset(store, 0, sizeof(*store));
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        ERROR_RETURN(-2, "Cannot open key store %s: %s", path, strerror(errno));
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < (off_t)sizeof(rsa_4096_keystore_header_t)) {
+        close(fd);
+        ERROR_RETURN(-3, "Key store %s is too short", path);
+    }
+
+    size_t size = (size_t)st.st_size;
+    void *map = mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        ERROR_RETURN(-2, "Cannot map key store %s: %s", path, strerror(errno));
+    }
+
+    const rsa_4096_keystore_header_t *h = (const rsa_4096_keystore_header_t *)map;
+    int ret = 0;
+    if (memcmp(h->magic, RSA_4096_KEYSTORE_MAGIC, sizeof(h->magic)) != 0) {
+        ret = -3;
+    } else if (h->version != RSA_4096_KEYSTORE_VERSION || h->byte_order != KEYSTORE_BYTE_ORDER ||
+               h->word_bits != BIGINT_WORD_SIZE || h->bigint_words != BIGINT_4096_WORDS ||
+               h->key_size != sizeof(rsa_4096_key_t) || h->layout != keystore_layout()) {
+        ret = -4;
+    } else if (h->record_stride < sizeof(rsa_4096_key_t) || h->record_stride % RSA_4096_KEYSTORE_RECORD_ALIGN != 0 ||
+               h->index_offset % RSA_4096_KEYSTORE_ALIGN != 0 || h->records_offset % RSA_4096_KEYSTORE_ALIGN != 0 ||
+               h->index_offset < sizeof(*h) || h->file_size != size || h->index_offset > size ||
+               h->count > (size - h->index_offset) / sizeof(rsa_4096_keystore_entry_t) ||
+               h->records_offset < h->index_offset + h->count * sizeof(rsa_4096_keystore_entry_t) ||
+               h->records_offset > size || h->count > (size - h->records_offset) / h->record_stride) {
+        ret = -3;
+    }
+    if (ret != 0) {
+        munmap(map, size);
+        ERROR_RETURN(ret, "Key store %s %s", path, ret == -4 ? "was written by an incompatible build" : "is corrupt");
+    }
+
+    /* Lookups land on scattered records: no point reading ahead */
+    posix_madvise(map, size, POSIX_MADV_RANDOM);
+
+    store->map = (const uint8_t *)map;
+    store->map_size = size;
+    store->index = (const rsa_4096_keystore_entry_t *)(store->map + h->index_offset);
+    store->records = store->map + h->records_offset;
+    store->count = (size_t)h->count;
+    store->record_stride = (size_t)h->record_stride;
+
+    CHECKPOINT(LOG_INFO, "Key store %s opened: %zu keys", path, store->count);
+    return 0;
+}
+
+void rsa_4096_keystore_close(rsa_4096_keystore_t *store) {
+    if (store != NULL) {
+        if (store->map != NULL) {
+            munmap((void *)store->map, store->map_size);
+        }
+        memset(store, 0, sizeof(*store));
+    }
+}
+
+/**
+ * @brief Key by record number (input order of rsa_4096_keystore_write)
+ *
+ * @return 0 on success, -1 NULL argument, -2 no such record, -3 corrupt record
+ */
+int rsa_4096_keystore_get(const rsa_4096_keystore_t *store, size_t record, const rsa_4096_key_t **key) {
+    if (store == NULL || key == NULL || store->map == NULL) {
+        ERROR_RETURN(-1, "NULL pointer in rsa_4096_keystore_get");
+    }
+    *key = NULL;
+    if (record >= store->count) {
+        ERROR_RETURN(-2, "Key store record %zu out of range (%zu keys)", record, store->count);
+    }
+
+    const rsa_4096_key_t *k = (const rsa_4096_key_t *)(store->records + record * store->record_stride);
+    if (!keystore_key_ok(k)) {
+        ERROR_RETURN(-3, "Key store record %zu is corrupt", record);
+    }
+    *key = k;
+    return 0;
+}
+
+/**
+ * @brief Key by id: binary search of the sorted index
+ *
+ * @return 0 on success, -1 NULL argument, -2 id not in the store, -3 corrupt record
+ */
+int rsa_4096_keystore_find(const rsa_4096_keystore_t *store, uint64_t id, const rsa_4096_key_t **key) {
+    if (store == NULL || key == NULL || store->map == NULL) {
+        ERROR_RETURN(-1, "NULL pointer in rsa_4096_keystore_find");
+    }
+    *key = NULL;
+
+    size_t lo = 0, hi = store->count;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (store->index[mid].id < id) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    if (lo == store->count || store->index[lo].id != id) {
+        return -2;
+    }
+    if (store->index[lo].record >= store->count) {
+        ERROR_RETURN(-3, "Key store index entry for id %llu is corrupt", (unsigned long long)id);
+    }
+    return rsa_4096_keystore_get(store, (size_t)store->index[lo].record, key);
+}
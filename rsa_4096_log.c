@@ -0,0 +1,285 @@
+/**
+ * @file rsa_4096_log.c
+ * @brief Logging Subsystem for RSA-4096 - Pluggable Sinks and Runtime Level
+ *
+ * Two filters apply to every message:
+ * - LOG_LEVEL (compile time): CHECKPOINT/DEBUG_BIGINT below it compile to nothing,
+ *   so release builds carry no trace code in the arithmetic loops.
+ * - rsa_4096_log_level (runtime): a single integer compare for messages that were
+ *   compiled in; changing it never touches the arithmetic code.
+ *
+ * Messages that pass both are formatted once and handed to the current sink
+ * (stdout by default, or the ring buffer / a user callback).
+ *
+ * The same file hosts the opt-in instrumentation counters (RSA_4096_STATS).
+ */
+
+#define _POSIX_C_SOURCE 200809L  /* clock_gettime */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include "rsa_4096.h"
+
+/* ===================== LOGGING STATE ===================== */
+
+int rsa_4096_log_level = LOG_LEVEL;
+
+static rsa_4096_log_sink_t log_sink = rsa_4096_log_stdout_sink;
+static void *log_sink_user = NULL;
+
+void rsa_4096_log_set_level(int level) {
+    rsa_4096_log_level = level;
+}
+
+int rsa_4096_log_get_level(void) {
+    return rsa_4096_log_level;
+}
+
+void rsa_4096_log_set_sink(rsa_4096_log_sink_t sink, void *user) {
+    if (sink == NULL) {
+        log_sink = rsa_4096_log_stdout_sink;
+        log_sink_user = NULL;
+    } else {
+        log_sink = sink;
+        log_sink_user = user;
+    }
+}
+
+void rsa_4096_log_write(int level, const char *func, int line, const char *fmt, ...) {
+    if (level < rsa_4096_log_level) {
+        return;
+    }
+
+    char msg[RSA_4096_LOG_LINE_MAX];
+    va_list args;
+    va_start(args, fmt);
+    vsnprintf(msg, sizeof(msg), fmt, args);
+    va_end(args);
+
+    log_sink(log_sink_user, level, func, line, msg);
+}
+
+/* ===================== BUILT-IN SINKS ===================== */
+
+void rsa_4096_log_stdout_sink(void *user, int level, const char *func, int line, const char *msg) {
+    (void)user;
+    (void)level;
+    printf("[%s:%d] %s\n", func, line, msg);
+    fflush(stdout);
+}
+
+void rsa_4096_log_ring_init(rsa_4096_log_ring_t *ring) {
+    if (ring != NULL) {
+        memset(ring, 0, sizeof(*ring));
+    }
+}
+
+/**
+ * @brief Sink that keeps the last RSA_4096_LOG_RING_LINES messages; user is the ring
+ */
+void rsa_4096_log_ring_sink(void *user, int level, const char *func, int line, const char *msg) {
+    rsa_4096_log_ring_t *ring = (rsa_4096_log_ring_t *)user;
+    if (ring == NULL) {
+        return;
+    }
+
+    unsigned int slot = ring->next;
+    snprintf(ring->lines[slot], RSA_4096_LOG_LINE_MAX, "[%s:%d] %s", func, line, msg);
+    ring->levels[slot] = level;
+    ring->next = (slot + 1) % RSA_4096_LOG_RING_LINES;
+    if (ring->count < RSA_4096_LOG_RING_LINES) {
+        ring->count++;
+    }
+}
+
+/**
+ * @brief Message by age (0 = oldest held), or NULL past the end
+ */
+const char *rsa_4096_log_ring_get(const rsa_4096_log_ring_t *ring, unsigned int index) {
+    if (ring == NULL || index >= ring->count) {
+        return NULL;
+    }
+
+    unsigned int oldest = (ring->next + RSA_4096_LOG_RING_LINES - ring->count) % RSA_4096_LOG_RING_LINES;
+    return ring->lines[(oldest + index) % RSA_4096_LOG_RING_LINES];
+}
+
+/* ===================== INSTRUMENTATION COUNTERS ===================== */
+
+/*
+ * Each thread counts into its own block, so the hot paths never share a
+ * cache line or take a lock. The blocks are linked into a registry the
+ * snapshot walks; a thread's counts move into the retired totals when it
+ * exits. The owner updates its slots with relaxed atomic stores and readers
+ * use relaxed loads, so a snapshot taken while other threads run is a
+ * slightly stale but race-free view. Reset records a baseline instead of
+ * clearing the blocks, which would race with their owners.
+ */
+
+typedef struct stats_block {
+    uint64_t counters[RSA_4096_STAT_COUNT];
+    struct stats_block *prev, *next;
+} stats_block_t;
+
+static __thread stats_block_t *thread_stats;
+static stats_block_t *stats_threads;
+static uint64_t stats_retired[RSA_4096_STAT_COUNT];
+static uint64_t stats_baseline[RSA_4096_STAT_COUNT];
+static pthread_mutex_t stats_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_once_t stats_once = PTHREAD_ONCE_INIT;
+static pthread_key_t stats_key;
+
+static rsa_4096_phase_hook_t phase_hook = NULL;
+static void *phase_hook_user = NULL;
+
+static const char *const stat_names[RSA_4096_STAT_COUNT] = {
+    "mont_mul", "mont_square", "mont_redc", "redc_final_sub", "bigint_div",
+    "hybrid_montgomery", "hybrid_traditional", "hybrid_fallback", "path_fallback",
+    "ns_to_form", "ns_exp_loop", "ns_from_form", "ns_encode",
+};
+
+static void stats_thread_exit(void *arg) {
+    stats_block_t *block = (stats_block_t *)arg;
+    pthread_mutex_lock(&stats_lock);
+    for (int i = 0; i < RSA_4096_STAT_COUNT; i++) {
+        stats_retired[i] += block->counters[i];
+    }
+    if (block->prev) block->prev->next = block->next;
+    else stats_threads = block->next;
+    if (block->next) block->next->prev = block->prev;
+    pthread_mutex_unlock(&stats_lock);
+    free(block);
+}
+
+static void stats_make_key(void) {
+    pthread_key_create(&stats_key, stats_thread_exit);
+}
+
+/**
+ * @brief The calling thread's block, registered on first use (NULL if out of memory)
+ */
+static stats_block_t *stats_local(void) {
+    if (thread_stats == NULL) {
+        stats_block_t *block = (stats_block_t *)calloc(1, sizeof(*block));
+        if (block == NULL) {
+            return NULL;
+        }
+        pthread_once(&stats_once, stats_make_key);
+        pthread_mutex_lock(&stats_lock);
+        block->next = stats_threads;
+        if (stats_threads) stats_threads->prev = block;
+        stats_threads = block;
+        pthread_mutex_unlock(&stats_lock);
+        pthread_setspecific(stats_key, block);
+        thread_stats = block;
+    }
+    return thread_stats;
+}
+
+/* Totals over exited and live threads; caller holds stats_lock */
+static void stats_sum_locked(uint64_t *sum) {
+    memcpy(sum, stats_retired, sizeof(stats_retired));
+    for (const stats_block_t *b = stats_threads; b != NULL; b = b->next) {
+        for (int i = 0; i < RSA_4096_STAT_COUNT; i++) {
+            sum[i] += __atomic_load_n(&b->counters[i], __ATOMIC_RELAXED);
+        }
+    }
+}
+
+int rsa_4096_stats_enabled(void) {
+    return RSA_4096_STATS;
+}
+
+const char *rsa_4096_stat_name(rsa_4096_stat_t stat) {
+    if ((int)stat < 0 || stat >= RSA_4096_STAT_COUNT) {
+        return NULL;
+    }
+    return stat_names[stat];
+}
+
+void rsa_4096_stats_add(rsa_4096_stat_t stat, uint64_t value) {
+    stats_block_t *block = stats_local();
+    if (block != NULL) {
+        uint64_t *slot = &block->counters[stat];
+        __atomic_store_n(slot, *slot + value, __ATOMIC_RELAXED);
+    }
+}
+
+void rsa_4096_stats_snapshot(rsa_4096_stats_t *stats) {
+    if (stats == NULL) return;
+    uint64_t sum[RSA_4096_STAT_COUNT];
+    pthread_mutex_lock(&stats_lock);
+    stats_sum_locked(sum);
+    for (int i = 0; i < RSA_4096_STAT_COUNT; i++) {
+        stats->counters[i] = sum[i] - stats_baseline[i];
+    }
+    pthread_mutex_unlock(&stats_lock);
+}
+
+void rsa_4096_stats_thread_snapshot(rsa_4096_stats_t *stats) {
+    if (stats == NULL) return;
+    if (thread_stats == NULL) {
+        memset(stats, 0, sizeof(*stats));
+    } else {
+        memcpy(stats->counters, thread_stats->counters, sizeof(stats->counters));
+    }
+}
+
+void rsa_4096_stats_reset(void) {
+    pthread_mutex_lock(&stats_lock);
+    stats_sum_locked(stats_baseline);
+    pthread_mutex_unlock(&stats_lock);
+}
+
+void rsa_4096_stats_set_phase_hook(rsa_4096_phase_hook_t hook, void *user) {
+    phase_hook = hook;
+    phase_hook_user = hook ? user : NULL;
+}
+
+uint64_t rsa_4096_stats_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+void rsa_4096_stats_phase(rsa_4096_phase_t phase, uint64_t start_ns) {
+    uint64_t ns = rsa_4096_stats_now_ns() - start_ns;
+    rsa_4096_stats_add((rsa_4096_stat_t)(RSA_4096_STAT_NS_TO_FORM + phase), ns);
+    if (phase_hook != NULL) {
+        phase_hook(phase_hook_user, phase, ns);
+    }
+}
+
+/* ===================== DEBUG UTILITIES ===================== */
+
+void debug_print_bigint(const char *name, const bigint_t *a) {
+    if (!LOG_ENABLED(LOG_DEBUG)) return;
+
+    char value[96];
+    if (a->used == 0) {
+        snprintf(value, sizeof(value), "0");
+    } else if (a->used <= 4) {
+        size_t pos = (size_t)snprintf(value, sizeof(value), "0x");
+        for (int i = a->used - 1; i >= 0 && pos < sizeof(value); i--) {
+            pos += (size_t)snprintf(value + pos, sizeof(value) - pos, BIGINT_WORD_FMT, a->words[i]);
+        }
+    } else {
+        snprintf(value, sizeof(value), "0x" BIGINT_WORD_FMT "..." BIGINT_WORD_FMT " (%d words, %d bits)",
+                 a->words[a->used-1], a->words[0], a->used, bigint_bit_length(a));
+    }
+    rsa_4096_log_write(LOG_DEBUG, __func__, __LINE__, "[DEBUG] %s: %s", name, value);
+}
+
+void debug_verify_invariant(const char *step, const bigint_t *value, const bigint_t *modulus) {
+    if (!LOG_ENABLED(LOG_DEBUG)) return;
+
+    if (bigint_compare(value, modulus) >= 0) {
+        CHECKPOINT(LOG_DEBUG, "[DEBUG WARNING] %s: value >= modulus!", step);
+        debug_print_bigint("value", value);
+        debug_print_bigint("modulus", modulus);
+    }
+}
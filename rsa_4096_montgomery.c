@@ -15,117 +15,73 @@
 #include <time.h>
 #include "rsa_4096.h"
 
-/* ===================== DEBUG UTILITIES ===================== */
-
-void debug_print_bigint(const char *name, const bigint_t *a) {
-    if (LOG_LEVEL > LOG_DEBUG) return;
-    
-    printf("[DEBUG] %s: ", name);
-    if (a->used == 0) {
-        printf("0");
-    } else if (a->used <= 4) {
-        printf("0x");
-        for (int i = a->used - 1; i >= 0; i--) {
-            printf("%08x", a->words[i]);
-        }
-    } else {
-        printf("0x%08x...%08x (%d words, %d bits)", 
-               a->words[a->used-1], a->words[0], a->used, bigint_bit_length(a));
-    }
-    printf("\n");
-}
-
-void debug_verify_invariant(const char *step, const bigint_t *value, const bigint_t *modulus) {
-    if (LOG_LEVEL > LOG_DEBUG) return;
-    
-    if (bigint_compare(value, modulus) >= 0) {
-        printf("[DEBUG WARNING] %s: value >= modulus!\n", step);
-        debug_print_bigint("value", value);
-        debug_print_bigint("modulus", modulus);
-    }
-}
-
 /* ===================== MONTGOMERY WORD INVERSE CALCULATION ===================== */
 
 /**
- * @brief Compute n^(-1) mod 2^32 using Newton's method
+ * @brief Compute n^(-1) mod 2^W (W = BIGINT_WORD_SIZE) using Newton's method
  */
-static uint32_t compute_word_inverse(uint32_t n) {
-    if (LOG_LEVEL <= LOG_DEBUG) {
-        printf("[DEBUG] Computing word inverse of 0x%08x\n", n);
-    }
+static bigint_word_t compute_word_inverse(bigint_word_t n) {
+    CHECKPOINT(LOG_DEBUG, "[DEBUG] Computing word inverse of 0x" BIGINT_WORD_FMT, n);
     
     if ((n & 1) == 0) {
-        printf("[DEBUG ERROR] Word is even, no inverse exists\n");
+        CHECKPOINT(LOG_ERROR, "[DEBUG ERROR] Word is even, no inverse exists");
         return 0;
     }
     
-    /* Newton's method: x_{i+1} = x_i * (2 - n * x_i) mod 2^32 */
-    uint32_t x = n;  /* Initial approximation */
+    /* Newton's method: x_{i+1} = x_i * (2 - n * x_i) mod 2^W */
+    bigint_word_t x = n;  /* Initial approximation */
     
-    /* Newton iterations - converges quadratically */
+    /* Newton iterations - converges quadratically: 3 -> 96 correct bits */
     for (int i = 0; i < 5; i++) {
-        uint32_t nx = n * x;
-        x = x * (2 - nx);  /* All arithmetic mod 2^32 automatically */
-        if (LOG_LEVEL <= LOG_DEBUG) {
-            printf("[DEBUG] Iteration %d: x = 0x%08x\n", i + 1, x);
-        }
+        bigint_word_t nx = n * x;
+        x = x * (2 - nx);  /* All arithmetic mod 2^W automatically */
+        CHECKPOINT(LOG_DEBUG, "[DEBUG] Iteration %d: x = 0x" BIGINT_WORD_FMT, i + 1, x);
     }
     
-    /* Verify: n * x ≡ 1 (mod 2^32) */
-    uint32_t verify = n * x;
+    /* Verify: n * x ≡ 1 (mod 2^W) */
+    bigint_word_t verify = n * x;
     if (verify != 1) {
-        printf("[DEBUG ERROR] Inverse verification failed: 0x%08x * 0x%08x = 0x%08x (should be 1)\n", 
+        CHECKPOINT(LOG_ERROR, "[DEBUG ERROR] Inverse verification failed: 0x" BIGINT_WORD_FMT " * 0x" BIGINT_WORD_FMT " = 0x" BIGINT_WORD_FMT " (should be 1)", 
                n, x, verify);
         return 0;
     }
     
-    if (LOG_LEVEL <= LOG_DEBUG) {
-        printf("[DEBUG] ✓ Word inverse: 0x%08x^(-1) = 0x%08x (mod 2^32)\n", n, x);
-    }
+    CHECKPOINT(LOG_DEBUG, "[DEBUG] ✓ Word inverse: 0x" BIGINT_WORD_FMT "^(-1) = 0x" BIGINT_WORD_FMT " (mod 2^W)", n, x);
     return x;
 }
 
 /**
- * @brief Compute n' = -n^(-1) mod 2^32 for Montgomery REDC
+ * @brief Compute n' = -n^(-1) mod 2^W for Montgomery REDC
  */
-static uint32_t compute_montgomery_nprime(uint32_t n) {
-    if (LOG_LEVEL <= LOG_DEBUG) {
-        printf("[DEBUG] Computing Montgomery n' for 0x%08x\n", n);
-    }
+static bigint_word_t compute_montgomery_nprime(bigint_word_t n) {
+    CHECKPOINT(LOG_DEBUG, "[DEBUG] Computing Montgomery n' for 0x" BIGINT_WORD_FMT, n);
     
-    /* Step 1: Compute n^(-1) mod 2^32 */
-    uint32_t n_inv = compute_word_inverse(n);
+    /* Step 1: Compute n^(-1) mod 2^W */
+    bigint_word_t n_inv = compute_word_inverse(n);
     if (n_inv == 0) {
-        printf("[DEBUG ERROR] Failed to compute n^(-1)\n");
+        CHECKPOINT(LOG_ERROR, "[DEBUG ERROR] Failed to compute n^(-1)");
         return 0;
     }
     
-    /* Step 2: Compute n' = -n^(-1) mod 2^32 */
+    /* Step 2: Compute n' = -n^(-1) mod 2^W */
     /* In two's complement: -x = (~x) + 1 */
-    uint32_t n_prime = (~n_inv) + 1;
+    bigint_word_t n_prime = (~n_inv) + 1;
     
-    if (LOG_LEVEL <= LOG_DEBUG) {
-        printf("[DEBUG] n^(-1) = 0x%08x\n", n_inv);
-        printf("[DEBUG] n' = -n^(-1) = 0x%08x\n", n_prime);
-    }
+    CHECKPOINT(LOG_DEBUG, "[DEBUG] n^(-1) = 0x" BIGINT_WORD_FMT, n_inv);
+    CHECKPOINT(LOG_DEBUG, "[DEBUG] n' = -n^(-1) = 0x" BIGINT_WORD_FMT, n_prime);
     
-    /* CRITICAL VERIFICATION: n * n' ≡ -1 ≡ 0xFFFFFFFF (mod 2^32) */
-    uint32_t verify_product = n * n_prime;
-    if (LOG_LEVEL <= LOG_DEBUG) {
-        printf("[DEBUG] Verification: n * n' = 0x%08x * 0x%08x = 0x%08x\n", 
-               n, n_prime, verify_product);
-    }
+    /* CRITICAL VERIFICATION: n * n' ≡ -1 ≡ all ones (mod 2^W) */
+    bigint_word_t verify_product = n * n_prime;
+    CHECKPOINT(LOG_DEBUG, "[DEBUG] Verification: n * n' = 0x" BIGINT_WORD_FMT " * 0x" BIGINT_WORD_FMT " = 0x" BIGINT_WORD_FMT, 
+           n, n_prime, verify_product);
     
-    if (verify_product != 0xFFFFFFFF) {
-        printf("[DEBUG ERROR] n' verification failed: expected 0xFFFFFFFF, got 0x%08x\n", 
+    if (verify_product != (bigint_word_t)BIGINT_WORD_MASK) {
+        CHECKPOINT(LOG_ERROR, "[DEBUG ERROR] n' verification failed: expected all ones, got 0x" BIGINT_WORD_FMT, 
                verify_product);
         return 0;
     }
     
-    if (LOG_LEVEL <= LOG_DEBUG) {
-        printf("[DEBUG] ✓ Montgomery n' verification PASSED\n");
-    }
+    CHECKPOINT(LOG_DEBUG, "[DEBUG] ✓ Montgomery n' verification PASSED");
     return n_prime;
 }
 
@@ -200,14 +156,13 @@ int binary_gcd_large(bigint_t *result, const bigint_t *a, const bigint_t *b) {
         
         /* Progress reporting for very large computations */
         if (iterations % 1000 == 0) {
-            printf("[BINARY_GCD] Progress: iteration %d, u=%d words, v=%d words\n", 
+            CHECKPOINT(LOG_DEBUG, "[BINARY_GCD] Progress: iteration %d, u=%d words, v=%d words", 
                    iterations, u.used, v.used);
-            fflush(stdout);
         }
     }
     
     if (iterations >= max_binary_iterations) {
-        printf("[BINARY_GCD] WARNING: Reached maximum iterations (%d)\n", max_binary_iterations);
+        CHECKPOINT(LOG_DEBUG, "[BINARY_GCD] WARNING: Reached maximum iterations (%d)", max_binary_iterations);
         /* Return best approximation rather than failing */
     }
     
@@ -217,445 +172,346 @@ int binary_gcd_large(bigint_t *result, const bigint_t *a, const bigint_t *b) {
         bigint_shift_left(result, result, k);
     }
     
-    printf("[BINARY_GCD] Completed in %d iterations\n", iterations);
+    CHECKPOINT(LOG_DEBUG, "[BINARY_GCD] Completed in %d iterations", iterations);
     return 0;
 }
 
+/* ===================== MODULAR INVERSE (BINARY EXTENDED GCD) ===================== */
+
+/*
+ * Both inverses keep u = x1 * a and v = x2 * a (mod m), starting from
+ * (u, x1) = (a, 1) and (v, x2) = (m, 0), and shrink u with subtractions and
+ * halvings until it reaches zero; v is then gcd(a, m) and x2 the inverse.
+ * Everything runs on the modulus's own limb count in scratch from the arena.
+ */
+
+/* r = a - (b & mask) over s limbs, returns the borrow */
+static bigint_word_t inv_sub_masked(bigint_word_t *r, const bigint_word_t *a, const bigint_word_t *b,
+                                    bigint_word_t mask, int s) {
+    bigint_dword_t borrow = 0;
+    for (int j = 0; j < s; j++) {
+        bigint_dword_t diff = (bigint_dword_t)a[j] - (b[j] & mask) - borrow;
+        r[j] = (bigint_word_t)diff;
+        borrow = (diff >> BIGINT_WORD_SIZE) & 1;
+    }
+    return (bigint_word_t)borrow;
+}
+
+/* r += b & mask over s limbs, returns the carry */
+static bigint_word_t inv_add_masked(bigint_word_t *r, const bigint_word_t *b, bigint_word_t mask, int s) {
+    bigint_dword_t carry = 0;
+    for (int j = 0; j < s; j++) {
+        bigint_dword_t sum = (bigint_dword_t)r[j] + (b[j] & mask) + carry;
+        r[j] = (bigint_word_t)sum;
+        carry = sum >> BIGINT_WORD_SIZE;
+    }
+    return (bigint_word_t)carry;
+}
+
+/* x = (x - y) mod m for x, y < m */
+static void inv_sub_mod(bigint_word_t *x, const bigint_word_t *y, const bigint_word_t *m,
+                        bigint_word_t mask, int s) {
+    bigint_word_t borrow = inv_sub_masked(x, x, y, mask, s);
+    inv_add_masked(x, m, (bigint_word_t)0 - borrow, s);
+}
+
+/* x = x / 2 mod m for odd m: add m when x is odd, then shift the carry back in */
+static void inv_half_mod(bigint_word_t *x, const bigint_word_t *m, int s) {
+    bigint_word_t carry = inv_add_masked(x, m, (bigint_word_t)0 - (x[0] & 1), s);
+    for (int j = 0; j < s - 1; j++) {
+        x[j] = (x[j] >> 1) | (x[j + 1] << (BIGINT_WORD_SIZE - 1));
+    }
+    x[s - 1] = (x[s - 1] >> 1) | (carry << (BIGINT_WORD_SIZE - 1));
+}
+
+/* x = x * 2^(-k) mod m for 1 <= k < W: add the multiple of m that clears the low k bits, then shift */
+static void inv_div_pow2_mod(bigint_word_t *x, const bigint_word_t *m, bigint_word_t m_inv, int k, int s) {
+    bigint_word_t q = ((bigint_word_t)0 - x[0] * m_inv) & (((bigint_word_t)1 << k) - 1);
+    bigint_dword_t carry = 0;
+    for (int j = 0; j < s; j++) {
+        bigint_dword_t uv = (bigint_dword_t)q * m[j] + x[j] + carry;
+        x[j] = (bigint_word_t)uv;
+        carry = uv >> BIGINT_WORD_SIZE;
+    }
+    for (int j = 0; j < s - 1; j++) {
+        x[j] = (x[j] >> k) | (x[j + 1] << (BIGINT_WORD_SIZE - k));
+    }
+    x[s - 1] = (x[s - 1] >> k) | ((bigint_word_t)carry << (BIGINT_WORD_SIZE - k));
+}
+
+/* Swap a and b over s limbs when mask is all ones */
+static void inv_cswap(bigint_word_t *a, bigint_word_t *b, bigint_word_t mask, int s) {
+    for (int j = 0; j < s; j++) {
+        bigint_word_t t = (a[j] ^ b[j]) & mask;
+        a[j] ^= t;
+        b[j] ^= t;
+    }
+}
+
+static int inv_trailing_zeros(bigint_word_t w) {
+    int k = 0;
+    while ((w & 1) == 0) {
+        w >>= 1;
+        k++;
+    }
+    return k;
+}
+
+/* Significant limbs of a[0..n-1] */
+static int inv_used(const bigint_word_t *a, int n) {
+    while (n > 0 && a[n - 1] == 0) {
+        n--;
+    }
+    return n;
+}
+
 /**
- * @brief Fast division approximation for large operands
+ * @brief a^(-1) mod m for odd m and 0 < a < m, variable time
  * 
- * OPTIMIZATION ADDED: Fast division approximations for large operands to avoid bottlenecks
- * COMPATIBILITY: This is a new helper function, does not change existing APIs
- * SAFETY: Falls back to exact division when approximation doesn't converge
+ * u and v only ever shrink, so their loops run over their current length.
+ * All trailing zeros of u come off in one shift; x1 follows with one
+ * word-sized Montgomery step per W-1 bits instead of one halving per bit.
+ * Returns 0 with the inverse in x (s limbs), or -5 if gcd(a, m) != 1.
  */
-int fast_div_approx(bigint_t *q, bigint_t *r, const bigint_t *a, const bigint_t *b) {
-    if (q == NULL || r == NULL || a == NULL || b == NULL) {
-        ERROR_RETURN(-1, "NULL pointer in fast_div_approx");
-    }
-    
-    /* For very large numbers, use more careful approximation techniques */
-    if (a->used > 50 && b->used > 25) {
-        printf("[FAST_DIV] Using approximation for large operands (%d, %d words)\n", a->used, b->used);
-        
-        /* Check if this is making progress - if remainder size isn't decreasing, use exact division */
-        static int stagnation_counter = 0;
-        static int last_remainder_size = 0;
-        
-        if (a->used >= last_remainder_size && stagnation_counter > 5) {
-            printf("[FAST_DIV] Stagnation detected, falling back to exact division\n");
-            stagnation_counter = 0;
-            return bigint_div(q, r, a, b);
-        }
-        
-        /* More accurate approximation using leading digits */
-        int a_bits = bigint_bit_length(a);
-        int b_bits = bigint_bit_length(b);
-        
-        if (a_bits <= b_bits) {
-            bigint_init(q);
-            bigint_copy(r, a);
-            last_remainder_size = r->used;
-            return 0;
+static int inv_odd_vartime(bigint_word_t *x, const bigint_word_t *a, const bigint_word_t *m, int s,
+                           bigint_word_t *work) {
+    bigint_word_t *u = work, *v = work + s, *x1 = work + 2 * s, *x2 = x;
+    const bigint_word_t m_inv = compute_word_inverse(m[0]);
+    
+    memcpy(u, a, (size_t)s * sizeof(bigint_word_t));
+    memcpy(v, m, (size_t)s * sizeof(bigint_word_t));
+    memset(x1, 0, (size_t)s * sizeof(bigint_word_t));
+    memset(x2, 0, (size_t)s * sizeof(bigint_word_t));
+    x1[0] = 1;
+    int un = inv_used(u, s), vn = s;
+    
+    while (un > 0) {
+        /* Strip every factor of two from u; v stays odd throughout */
+        int limbs = 0;
+        while (u[limbs] == 0) {
+            limbs++;
         }
-        
-        /* Use high-precision approximation for the quotient */
-        int diff_bits = a_bits - b_bits;
-        
-        if (diff_bits <= 1) {
-            /* Numbers are very close in size, quotient is likely 1 */
-            bigint_set_u32(q, 1);
-            bigint_sub(r, a, b);
-            if (bigint_compare(r, b) >= 0) {
-                bigint_t temp;
-                bigint_sub(&temp, r, b);
-                bigint_copy(r, &temp);
-                bigint_t one;
-                bigint_set_u32(&one, 1);
-                bigint_add(q, q, &one);
+        int shift = limbs * BIGINT_WORD_SIZE + inv_trailing_zeros(u[limbs]);
+        if (shift > 0) {
+            int bits = shift % BIGINT_WORD_SIZE;
+            for (int j = 0; j < un - limbs; j++) {
+                bigint_word_t hi = (bits && j + limbs + 1 < un) ? u[j + limbs + 1] << (BIGINT_WORD_SIZE - bits) : 0;
+                u[j] = (u[j + limbs] >> bits) | hi;
             }
-        } else if (diff_bits < 64) {
-            /* Use approximation based on high-order words */
-            uint64_t a_high = 0, b_high = 0;
-            
-            /* Extract most significant words for approximation */
-            if (a->used >= 2) {
-                a_high = ((uint64_t)a->words[a->used-1] << 32) | a->words[a->used-2];
-            } else if (a->used >= 1) {
-                a_high = a->words[a->used-1];
+            memset(u + un - limbs, 0, (size_t)limbs * sizeof(bigint_word_t));
+            un = inv_used(u, un - limbs);
+            for (; shift > 0; shift -= BIGINT_WORD_SIZE - 1) {
+                inv_div_pow2_mod(x1, m, m_inv, shift < BIGINT_WORD_SIZE - 1 ? shift : BIGINT_WORD_SIZE - 1, s);
             }
-            
-            if (b->used >= 2) {
-                b_high = ((uint64_t)b->words[b->used-1] << 32) | b->words[b->used-2];
-            } else if (b->used >= 1) {
-                b_high = b->words[b->used-1];
-            }
-            
-            if (b_high > 0) {
-                uint64_t q_approx = a_high / b_high;
-                bigint_set_u32(q, (uint32_t)q_approx);
-                
-                /* Adjust for the bit difference */
-                if (diff_bits > 32) {
-                    bigint_shift_left(q, q, diff_bits - 32);
-                }
-                
-                /* Compute remainder and adjust if necessary */
-                bigint_t temp;
-                bigint_mul(&temp, q, b);
-                
-                if (bigint_compare(&temp, a) > 0) {
-                    /* Quotient too high, reduce it */
-                    while (bigint_compare(&temp, a) > 0) {
-                        bigint_t one;
-                        bigint_set_u32(&one, 1);
-                        bigint_sub(q, q, &one);
-                        bigint_mul(&temp, q, b);
-                    }
-                }
-                
-                bigint_sub(r, a, &temp);
-                
-                /* Ensure remainder is smaller than divisor */
-                while (bigint_compare(r, b) >= 0) {
-                    bigint_sub(r, r, b);
-                    bigint_t one;
-                    bigint_set_u32(&one, 1);
-                    bigint_add(q, q, &one);
-                }
-            } else {
-                /* Fall back to exact division */
-                return bigint_div(q, r, a, b);
-            }
-        } else {
-            /* Very large difference, fall back to exact division for accuracy */
-            printf("[FAST_DIV] Large bit difference (%d), using exact division\n", diff_bits);
-            return bigint_div(q, r, a, b);
         }
         
-        last_remainder_size = r->used;
-        if (r->used < a->used) {
-            stagnation_counter = 0; /* Reset on progress */
-        } else {
-            stagnation_counter++;
+        /* Keep u >= v, then u = u - v (even again) */
+        int cmp = un - vn;
+        for (int j = un - 1; cmp == 0 && j >= 0; j--) {
+            cmp = (u[j] > v[j]) - (u[j] < v[j]);
         }
-        
-        printf("[FAST_DIV] Approximation completed, remainder %d words\n", r->used);
-        return 0;
+        if (cmp < 0) {
+            bigint_word_t *t = u; u = v; v = t;
+            t = x1; x1 = x2; x2 = t;
+            int tn = un; un = vn; vn = tn;
+        }
+        inv_sub_masked(u, u, v, BIGINT_WORD_MASK, un);
+        un = inv_used(u, un);
+        inv_sub_mod(x1, x2, m, BIGINT_WORD_MASK, s);
     }
     
-    /* For smaller numbers, use exact division */
-    return bigint_div(q, r, a, b);
+    if (vn != 1 || v[0] != 1) {
+        return -5;
+    }
+    if (x2 != x) {
+        memcpy(x, x2, (size_t)s * sizeof(bigint_word_t));
+    }
+    return 0;
 }
 
 /**
- * @brief Optimized Extended GCD implementation for large numbers
- * 
- * CRITICAL FIX FOR 4096-BIT KEYS: This function was the source of hanging issues
- * when processing real 4096-bit RSA keys during Montgomery context initialization.
- * 
- * OPTIMIZATIONS APPLIED (all within GCD routines, REDC algorithm unchanged):
- * - Early termination and progress monitoring (iteration cap increased from 3 to 5K)
- * - Binary GCD algorithm for very large numbers to speed up calculations
- * - Fast division approximations for large operands to avoid bottlenecks  
- * - Fallback/timeout behavior: return best approximate result with warning if needed
- * - R^(-1) computation made optional for very large moduli to prevent hanging
+ * @brief Load a reduced into s zero-padded limbs (variable-time reduction when a >= m)
+ */
+static int inv_load_reduced(bigint_word_t *dst, const bigint_t *a, const bigint_t *m, int s) {
+    bigint_t reduced;
+    const bigint_t *src = a;
+    if (bigint_compare(a, m) >= 0) {
+        int ret = bigint_mod(&reduced, a, m);
+        if (ret != 0) {
+            return ret;
+        }
+        src = &reduced;
+    }
+    memset(dst, 0, (size_t)s * sizeof(bigint_word_t));
+    memcpy(dst, src->words, (size_t)src->used * sizeof(bigint_word_t));
+    return 0;
+}
+
+static void inv_store(bigint_t *result, const bigint_word_t *x, int s) {
+    bigint_init(result);
+    memcpy(result->words, x, (size_t)s * sizeof(bigint_word_t));
+    result->used = inv_used(x, s);
+}
+
+/**
+ * @brief a^(-1) mod m by binary extended GCD, variable time (public values only)
  * 
- * COMPATIBILITY: All API signatures remain unchanged
- * SAFETY: All optimizations are strictly within GCD routines - REDC algorithm preserved
- * PERFORMANCE: System no longer hangs on large key input, stable performance on 4096-bit keys
+ * m may be even as long as a is odd (e^(-1) mod phi): then y = m^(-1) mod a
+ * gives m*y = 1 + k*a, and a^(-1) = m - k (mod m); m*y must fit in a bigint_t,
+ * which any small public exponent does.
+ * Returns 0 on success, -1 on NULL, -2 for a zero input, -5 if gcd(a, m) != 1.
  */
-int extended_gcd_full(bigint_t *result, const bigint_t *a, const bigint_t *m) {
-    printf("[EXT_GCD_OPTIMIZED] Computing %d-word^(-1) mod %d-word (OPTIMIZED)\n", a->used, m->used);
-    
-    /* Critical input validation for round-trip safety */
+int mod_inverse_vartime(bigint_t *result, const bigint_t *a, const bigint_t *m) {
     if (result == NULL || a == NULL || m == NULL) {
-        ERROR_RETURN(-1, "NULL pointer in extended_gcd_full");
+        ERROR_RETURN(-1, "NULL pointer in mod_inverse_vartime");
     }
-    
-    if (bigint_is_zero(m) || bigint_is_zero(a)) {
+    if (bigint_is_zero(a) || bigint_is_zero(m)) {
         ERROR_RETURN(-2, "Invalid input: a or m is zero");
     }
-    
-    /* Add validation for edge cases */
-    if (bigint_compare(a, m) >= 0) {
-        CHECKPOINT(LOG_INFO, "Input a >= m, will reduce first");
-    }
-    
-    /* Enhanced overflow detection */
-    VALIDATE_OVERFLOW(a, "extended_gcd input a");
-    VALIDATE_OVERFLOW(m, "extended_gcd input m");
-    
-    /* OPTIMIZATION: Use more efficient algorithm for large numbers */
-    /* First reduce 'a' modulo 'm' to make computation faster */
-    bigint_t a_reduced;
-    bigint_init(&a_reduced);
-    int ret = bigint_mod(&a_reduced, a, m);
-    if (ret != 0) {
-        printf("[EXT_GCD_OPTIMIZED] Failed to reduce a mod m, using original algorithm\n");
-        bigint_copy(&a_reduced, a);
-    } else {
-        printf("[EXT_GCD_OPTIMIZED] Reduced %d-word number to %d-word number\n", a->used, a_reduced.used);
+    if (bigint_is_one(m)) {
+        bigint_init(result);
+        return 0;
     }
     
-    /* Use the reduced number for GCD computation */
-    const bigint_t *gcd_input = &a_reduced;
-    
-    /* Special handling for small modulus */
-    if (m->used == 1 && m->words[0] <= 10000) {
-        printf("[EXT_GCD_OPTIMIZED] Small modulus optimization\n");
-        
-        uint32_t m_val = m->words[0];
-        uint32_t a_val = (gcd_input->used > 0) ? gcd_input->words[0] : 0;
-        
-        printf("[EXT_GCD_OPTIMIZED] Computing %u^(-1) mod %u\n", a_val, m_val);
-        
-        /* Handle zero case properly */
-        if (a_val == 0) {
-            ERROR_RETURN(-3, "No inverse exists for 0");
+    if ((m->words[0] & 1) == 0) {
+        if ((a->words[0] & 1) == 0) {
+            ERROR_RETURN(-5, "gcd(a, m) != 1, no inverse exists");
         }
-        
-        /* Handle a_val = 1 case */
-        if (a_val == 1) {
+        bigint_t a_red, y, k, rem, one;
+        bigint_set_u32(&one, 1);
+        int ret = bigint_mod(&a_red, a, m);
+        if (ret == 0 && bigint_is_zero(&a_red)) {
+            ERROR_RETURN(-5, "gcd(a, m) != 1, no inverse exists");
+        }
+        if (ret == 0 && bigint_is_one(&a_red)) {
             bigint_set_u32(result, 1);
-            printf("[EXT_GCD_OPTIMIZED] Found inverse by trial: 1\n");
             return 0;
         }
-        
-        /* Trial method for small numbers */
-        for (uint32_t i = 1; i < m_val; i++) {
-            if ((a_val * i) % m_val == 1) {
-                bigint_set_u32(result, i);
-                printf("[EXT_GCD_OPTIMIZED] Found inverse by trial: %u\n", i);
-                return 0;
-            }
+        if (ret == 0) ret = mod_inverse_vartime(&y, m, &a_red);
+        if (ret == 0) ret = bigint_mul(&k, m, &y);
+        if (ret == 0) ret = bigint_sub(&k, &k, &one);
+        if (ret == 0) ret = bigint_div(&k, &rem, &k, &a_red);
+        if (ret == 0) ret = bigint_sub(result, m, &k);
+        if (ret != 0) {
+            ERROR_RETURN(ret, "Even-modulus inverse failed");
         }
-        
-        ERROR_RETURN(-3, "No inverse found by trial method");
+        return 0;
     }
     
-    /* OPTIMIZATION: For very large numbers, consider binary GCD for better performance */
-    if (m->used > 100 || gcd_input->used > 100) {
-        printf("[EXT_GCD_OPTIMIZED] Very large numbers detected - checking if binary GCD would be beneficial\n");
-        
-        /* For modular inverse, we still need the extended algorithm, but we can optimize the division steps */
-        printf("[EXT_GCD_OPTIMIZED] Using optimized extended algorithm with fast division\n");
+    const int s = m->used;
+    size_t mark;
+    bigint_word_t *work = BIGINT_SCRATCH_LIMBS(5 * s, &mark);
+    if (work == NULL) {
+        ERROR_RETURN(-3, "Out of scratch memory in mod_inverse_vartime");
     }
-    
-    /* Extended Euclidean algorithm for larger numbers */
-    bigint_t old_r, r;
-    bigint_t old_s, s;
-    bigint_t old_t, t;
-    
-    /* Initialize: old_r = m, r = gcd_input (reduced a) */
-    bigint_copy(&old_r, m);
-    bigint_copy(&r, gcd_input);
-    
-    /* Initialize: old_s = 1, s = 0 */
-    bigint_set_u32(&old_s, 1);
-    bigint_init(&s);
-    
-    /* Initialize: old_t = 0, t = 1 */
-    bigint_init(&old_t);
-    bigint_set_u32(&t, 1);
-    
-    printf("[EXT_GCD_OPTIMIZED] Starting extended GCD algorithm with enhanced limits\n");
-    
-    int iteration = 0;
-    /* OPTIMIZATION: Reasonable iteration cap (10K-20K) with progress monitoring */
-    int max_iterations = 5000;  /* Reduced from 15K to 5K for better timeout handling */
-    int progress_interval = 250; /* Report progress every 250 iterations */
-    
-    /* Track progress for early termination */
-    int last_r_bits = bigint_bit_length(&r);
-    int stagnation_count = 0;
-    int force_exact_division = 0; /* Flag to force exact division when approximation fails */
-    
-    while (!bigint_is_zero(&r) && iteration < max_iterations) {
-        iteration++;
-        
-        if (iteration % progress_interval == 0) {
-            printf("[EXT_GCD_OPTIMIZED] Progress: iteration %d/%d, r=%d words (%d bits)\n", 
-                   iteration, max_iterations, r.used, bigint_bit_length(&r));
-            fflush(stdout);
-        }
-        
-        /* Calculate quotient and remainder using optimized division for large operands */
-        bigint_t quotient, remainder;
-        
-        /* OPTIMIZATION: Use fast division approximations for large operands, but fallback for convergence */
-        if (old_r.used > 50 && r.used > 25 && iteration < 500 && !force_exact_division) {
-            /* Only use approximations for the first 500 iterations to ensure convergence */
-            ret = fast_div_approx(&quotient, &remainder, &old_r, &r);
-            
-            /* Check if approximation is making progress */
-            if (ret == 0 && remainder.used >= r.used) {
-                printf("[EXT_GCD_OPTIMIZED] Approximation not converging, switching to exact division\n");
-                force_exact_division = 1;
-                ret = bigint_div(&quotient, &remainder, &old_r, &r);
-            }
-        } else {
-            /* Use exact division for final convergence or when approximations may cause issues */
-            ret = bigint_div(&quotient, &remainder, &old_r, &r);
-        }
-        
-        if (ret != 0) {
-            ERROR_RETURN(ret, "Division failed in extended GCD at iteration %d", iteration);
-        }
-        
-        /* Update r sequence: old_r, r = r, remainder */
-        bigint_copy(&old_r, &r);
-        bigint_copy(&r, &remainder);
-        
-        /* Update s sequence: old_s, s = s, old_s - quotient * s */
-        bigint_t q_times_s, new_s;
-        ret = bigint_mul(&q_times_s, &quotient, &s);
-        if (ret != 0) {
-            ERROR_RETURN(ret, "Multiplication failed in extended GCD");
-        }
-        
-        /* Handle subtraction: new_s = old_s - q_times_s */
-        if (bigint_compare(&old_s, &q_times_s) >= 0) {
-            ret = bigint_sub(&new_s, &old_s, &q_times_s);
-        } else {
-            /* Add modulus to handle negative result properly */
-            bigint_t temp_old_s;
-            bigint_copy(&temp_old_s, &old_s);
-            
-            /* Keep adding modulus until temp_old_s >= q_times_s */
-            while (bigint_compare(&temp_old_s, &q_times_s) < 0) {
-                bigint_t temp_sum;
-                ret = bigint_add(&temp_sum, &temp_old_s, m);
-                if (ret != 0) {
-                    ERROR_RETURN(ret, "Addition failed while handling negative result");
-                }
-                bigint_copy(&temp_old_s, &temp_sum);
-            }
-            
-            ret = bigint_sub(&new_s, &temp_old_s, &q_times_s);
-        }
-        if (ret != 0) {
-            ERROR_RETURN(ret, "Subtraction failed in extended GCD");
-        }
-        
-        /* Move to next iteration */
-        bigint_copy(&old_s, &s);
-        bigint_copy(&s, &new_s);
-        
-        /* OPTIMIZATION: Early termination based on progress monitoring */
-        int current_r_bits = bigint_bit_length(&r);
-        if (current_r_bits >= last_r_bits) {
-            stagnation_count++;
-            if (stagnation_count > 50) {
-                printf("[EXT_GCD_OPTIMIZED] WARNING: Progress stagnation detected at iteration %d\n", iteration);
-                printf("[EXT_GCD_OPTIMIZED] Switching to exact division for remaining iterations\n");
-                force_exact_division = 1;
-                stagnation_count = 0; /* Reset counter but keep monitoring */
-            }
-        } else {
-            stagnation_count = 0; /* Reset on progress */
-            last_r_bits = current_r_bits;
-        }
-        
-        /* Check for rapid convergence (GCD getting small quickly) */
-        if (r.used == 1 && r.words[0] <= 10) {
-            printf("[EXT_GCD_OPTIMIZED] Rapid convergence detected at iteration %d\n", iteration);
-            break;
-        }
-        
-        /* More aggressive timeout for very slow progress */
-        if (iteration > 1000 && r.used > m->used / 2) {
-            printf("[EXT_GCD_OPTIMIZED] WARNING: Slow progress after %d iterations\n", iteration);
-            printf("[EXT_GCD_OPTIMIZED] Remainder still has %d words (modulus has %d words)\n", r.used, m->used);
-            printf("[EXT_GCD_OPTIMIZED] Terminating to prevent excessive computation time\n");
-            break;
-        }
+    bigint_word_t *x = work + 3 * s, *a_limbs = work + 4 * s;
+    int ret = inv_load_reduced(a_limbs, a, m, s);
+    if (ret == 0) {
+        ret = inv_odd_vartime(x, a_limbs, m->words, s, work);
+    }
+    if (ret == 0) {
+        inv_store(result, x, s);
+    }
+    bigint_scratch_pop(work, mark);
+    if (ret != 0) {
+        ERROR_RETURN(ret, "gcd(a, m) != 1, no inverse exists");
+    }
+    return 0;
+}
+
+/**
+ * @brief a^(-1) mod m for odd m with a fixed, data-independent instruction trace
+ * 
+ * Every one of the 2 * W * s iterations does the same masked work: a
+ * conditional swap so u >= v, a masked u -= v and x1 -= x2, then a halving.
+ * Each step drops at least one bit from bits(u) + bits(v), so u is zero by
+ * the end whatever a is. Only the modulus size and whether an inverse
+ * exists are visible; inputs at or above m are first reduced with the
+ * ordinary (variable-time) division.
+ * Returns 0 on success, -1 on NULL, -2 for a zero input, -3 for an even
+ * modulus, -5 if gcd(a, m) != 1.
+ */
+int mod_inverse_consttime(bigint_t *result, const bigint_t *a, const bigint_t *m) {
+    if (result == NULL || a == NULL || m == NULL) {
+        ERROR_RETURN(-1, "NULL pointer in mod_inverse_consttime");
+    }
+    if (bigint_is_zero(a) || bigint_is_zero(m)) {
+        ERROR_RETURN(-2, "Invalid input: a or m is zero");
+    }
+    if ((m->words[0] & 1) == 0) {
+        ERROR_RETURN(-3, "Constant-time inverse requires an odd modulus");
     }
     
-    /* OPTIMIZATION: Fallback/timeout behavior */
-    if (iteration >= max_iterations) {
-        printf("[EXT_GCD_OPTIMIZED] WARNING: Reached maximum iterations (%d)\n", max_iterations);
-        
-        /* Check if we're close enough to succeed */
-        if (r.used <= 2) {
-            printf("[EXT_GCD_OPTIMIZED] Near convergence - attempting to complete\n");
-            /* Continue with a few more iterations if we're close */
-            int extra_iterations = 100;
-            while (!bigint_is_zero(&r) && extra_iterations > 0) {
-                iteration++;
-                extra_iterations--;
-                
-                bigint_t quotient, remainder;
-                ret = bigint_div(&quotient, &remainder, &old_r, &r);
-                if (ret != 0) break;
-                
-                bigint_copy(&old_r, &r);
-                bigint_copy(&r, &remainder);
-                
-                /* Update s sequence */
-                bigint_t q_times_s, new_s;
-                ret = bigint_mul(&q_times_s, &quotient, &s);
-                if (ret != 0) break;
-                
-                if (bigint_compare(&old_s, &q_times_s) >= 0) {
-                    ret = bigint_sub(&new_s, &old_s, &q_times_s);
-                } else {
-                    bigint_t temp_old_s;
-                    bigint_copy(&temp_old_s, &old_s);
-                    while (bigint_compare(&temp_old_s, &q_times_s) < 0) {
-                        bigint_t temp_sum;
-                        ret = bigint_add(&temp_sum, &temp_old_s, m);
-                        if (ret != 0) break;
-                        bigint_copy(&temp_old_s, &temp_sum);
-                    }
-                    if (ret == 0) {
-                        ret = bigint_sub(&new_s, &temp_old_s, &q_times_s);
-                    }
-                }
-                if (ret != 0) break;
-                
-                bigint_copy(&old_s, &s);
-                bigint_copy(&s, &new_s);
-            }
-        }
-        
-        if (!bigint_is_zero(&r)) {
-            printf("[EXT_GCD_OPTIMIZED] TIMEOUT: Cannot complete GCD within iteration limits\n");
-            printf("[EXT_GCD_OPTIMIZED] Numbers too large for current implementation\n");
-            printf("[EXT_GCD_OPTIMIZED] Consider using specialized large-number GCD library\n");
-            ERROR_RETURN(-4, "Extended GCD exceeded practical iterations - timeout");
+    const int s = m->used;
+    size_t mark;
+    bigint_word_t *work = BIGINT_SCRATCH_LIMBS(5 * s, &mark);
+    if (work == NULL) {
+        ERROR_RETURN(-3, "Out of scratch memory in mod_inverse_consttime");
+    }
+    bigint_word_t *u = work, *v = work + s, *x1 = work + 2 * s, *x2 = work + 3 * s, *t = work + 4 * s;
+    int ret = inv_load_reduced(u, a, m, s);
+    if (ret != 0) {
+        bigint_scratch_pop(work, mark);
+        ERROR_RETURN(ret, "Reduction failed in mod_inverse_consttime");
+    }
+    memcpy(v, m->words, (size_t)s * sizeof(bigint_word_t));
+    memset(x1, 0, (size_t)s * sizeof(bigint_word_t));
+    memset(x2, 0, (size_t)s * sizeof(bigint_word_t));
+    x1[0] = 1;
+    
+    for (int i = 0; i < 2 * BIGINT_WORD_SIZE * s; i++) {
+        bigint_word_t odd = (bigint_word_t)0 - (u[0] & 1);
+        bigint_word_t swap = odd & ((bigint_word_t)0 - inv_sub_masked(t, u, v, BIGINT_WORD_MASK, s));
+        inv_cswap(u, v, swap, s);
+        inv_cswap(x1, x2, swap, s);
+        inv_sub_masked(u, u, v, odd, s);
+        inv_sub_mod(x1, x2, m->words, odd, s);
+        for (int j = 0; j < s - 1; j++) {
+            u[j] = (u[j] >> 1) | (u[j + 1] << (BIGINT_WORD_SIZE - 1));
         }
+        u[s - 1] >>= 1;
+        inv_half_mod(x1, m->words, s);
     }
     
-    /* Check if gcd = 1 */
-    bigint_t one;
-    bigint_set_u32(&one, 1);
-    if (bigint_compare(&old_r, &one) != 0) {
-        printf("[EXT_GCD_OPTIMIZED] GCD is not 1\n");
-        debug_print_bigint("GCD", &old_r);
-        ERROR_RETURN(-5, "gcd(a, m) != 1, no inverse exists");
+    /* v = gcd(a, m); fold v - 1 to a single flag */
+    bigint_word_t diff = v[0] ^ 1;
+    for (int j = 1; j < s; j++) {
+        diff |= v[j];
     }
-    
-    printf("[EXT_GCD_OPTIMIZED] GCD = 1, computing final result\n");
-    
-    /* Ensure result is in range [0, m) */
-    if (bigint_compare(&old_s, m) >= 0) {
-        bigint_mod(result, &old_s, m);
-    } else if (old_s.used == 0 || (old_s.used == 1 && old_s.words[0] == 0)) {
-        /* Result is zero - this should not happen for valid inverse */
-        ERROR_RETURN(-6, "Result is zero - invalid inverse");
-    } else {
-        bigint_copy(result, &old_s);
+    if (diff == 0) {
+        inv_store(result, x2, s);
+    }
+    bigint_scratch_pop(work, mark);
+    if (diff != 0) {
+        ERROR_RETURN(-5, "gcd(a, m) != 1, no inverse exists");
     }
-    
-    printf("[EXT_GCD_OPTIMIZED] Extended GCD completed successfully in %d iterations\n", iteration);
-    printf("[EXT_GCD_OPTIMIZED] All optimizations applied within GCD routines - REDC unchanged\n");
     return 0;
 }
 
+/**
+ * @brief Modular inverse a^(-1) mod m for public operands
+ * 
+ * Kept for existing callers; runs the binary extended GCD in mod_inverse_vartime.
+ */
+int extended_gcd_full(bigint_t *result, const bigint_t *a, const bigint_t *m) {
+    return mod_inverse_vartime(result, a, m);
+}
+
 /* ===================== MONTGOMERY CONTEXT MANAGEMENT ===================== */
 
+static void mont_derive_constants(montgomery_ctx_t *ctx);
+
+/**
+ * @brief Cache the hybrid_mod_exp decision for an active context
+ */
+static void mont_set_dispatch(montgomery_ctx_t *ctx) {
+    ctx->dispatch = bigint_bit_length(&ctx->n) >= hybrid_get_montgomery_min_bits()
+                    ? MONTGOMERY_DISPATCH_MONTGOMERY : MONTGOMERY_DISPATCH_SMALL;
+    ctx->kernel_bits = montgomery_fixed_kernel_bits(ctx->n_words);
+}
+
 int montgomery_ctx_init(montgomery_ctx_t *ctx, const bigint_t *modulus) {
-    printf("[MONTGOMERY_COMPLETE] Initializing context for %d-bit modulus\n", bigint_bit_length(modulus));
+    CHECKPOINT(LOG_INFO, "[MONTGOMERY_COMPLETE] Initializing context for %d-bit modulus", bigint_bit_length(modulus));
     
     /* TODO: Critical input validation for round-trip safety */
     if (ctx == NULL || modulus == NULL) {
@@ -687,143 +543,36 @@ int montgomery_ctx_init(montgomery_ctx_t *ctx, const bigint_t *modulus) {
         ERROR_RETURN(-4, "Invalid modulus word count: %d", ctx->n_words);
     }
     
-    debug_print_bigint("Modulus (n)", &ctx->n);
-    
-    /* FIXME: For very large modulus (> 32 words), this implementation may need optimization */
-    if (ctx->n_words > 32) {
-        printf("[MONTGOMERY_COMPLETE] Large modulus (%d words) - using Montgomery REDC implementation\n", ctx->n_words);
-        CHECKPOINT(LOG_INFO, "Large modulus detected, potential performance concerns");
-    }
+    DEBUG_BIGINT("Modulus (n)", &ctx->n);
     
-    /* Calculate R = 2^(32 * n_words) with overflow checking */
+    /* Calculate R = 2^(BIGINT_WORD_SIZE * n_words); R itself needs one limb beyond the modulus */
     ctx->r_words = ctx->n_words;
-    
-    /* TODO: CRITICAL - Check for buffer overflow in R calculation */
-    if (ctx->r_words >= BIGINT_4096_WORDS - 10) {
-        printf("[MONTGOMERY_COMPLETE] R would overflow, disabling Montgomery\n");
+    if (ctx->r_words + 1 > BIGINT_4096_WORDS) {
+        CHECKPOINT(LOG_INFO, "[MONTGOMERY_COMPLETE] R would overflow, disabling Montgomery");
         return 0;
     }
     
-    /* FIXED: Set R = 2^(32 * r_words) properly with validation */
     bigint_init(&ctx->r);
-    if (ctx->r_words < BIGINT_4096_WORDS) {
-        ctx->r.words[ctx->r_words] = 1;
-        ctx->r.used = ctx->r_words + 1;
-        /* TODO: Normalize R after creation */
-        bigint_normalize(&ctx->r);
-    } else {
-        printf("[MONTGOMERY_COMPLETE] R too large, disabling Montgomery\n");
-        return 0;
-    }
+    ctx->r.words[ctx->r_words] = 1;
+    ctx->r.used = ctx->r_words + 1;
     
-    debug_print_bigint("R", &ctx->r);
-    
-    /* Verify R > n */
-    if (bigint_compare(&ctx->r, &ctx->n) <= 0) {
-        ERROR_RETURN(-4, "R must be > n");
-    }
-    printf("[MONTGOMERY_COMPLETE] ✓ R > n verified\n");
-    
-    /* Calculate n' = -n^(-1) mod 2^32 */
+    /* Calculate n' = -n^(-1) mod 2^BIGINT_WORD_SIZE from the lowest limb only */
     ctx->n_prime = compute_montgomery_nprime(modulus->words[0]);
     if (ctx->n_prime == 0) {
         ERROR_RETURN(-5, "Failed to compute Montgomery n'");
     }
     
-    printf("[MONTGOMERY_COMPLETE] ✓ n' = 0x%08x computed successfully\n", ctx->n_prime);
-    
-    /* Calculate R^(-1) mod n using extended GCD - OPTIONAL for most operations */
-    /* 
-     * CRITICAL FIX FOR 4096-BIT KEYS: This computation was causing hanging issues
-     * during Montgomery context initialization for large keys. The optimized
-     * extended GCD implementation now prevents hanging while maintaining correctness.
-     * 
-     * OPTIMIZATION: Make R^(-1) computation optional with timeout protection
-     * COMPATIBILITY: RSA encryption/decryption operations work correctly without R^(-1)
-     * SAFETY: Only affects conversion FROM Montgomery form, which is rarely used
-     */
-    printf("[MONTGOMERY_COMPLETE] Computing R^(-1) mod n (optional - with timeout protection)...\n");
-    
-    /* For very large moduli (> 80 words = 2560 bits), skip R^(-1) computation to prevent hanging
-     * This threshold is increased from 32 words to allow larger keys to work with full Montgomery
-     */
-    if (ctx->n_words > 80) {
-        printf("[MONTGOMERY_COMPLETE] Very large modulus (%d words) detected\n", ctx->n_words);
-        printf("[MONTGOMERY_COMPLETE] Skipping R^(-1) computation to prevent excessive computation time\n");
-        printf("[MONTGOMERY_COMPLETE] This will only affect conversion FROM Montgomery form\n");
-        printf("[MONTGOMERY_COMPLETE] All RSA encryption/decryption operations will work correctly\n");
-        
-        /* Initialize r_inv to zero to indicate it's not available */
-        bigint_init(&ctx->r_inv);
-    } else {
-        /* Compute R^(-1) for moduli up to 2560 bits with timeout protection */
-        printf("[MONTGOMERY_COMPLETE] Computing R^(-1) for modulus (%d words, %d bits)...\n", 
-               ctx->n_words, bigint_bit_length(&ctx->n));
-        
-        clock_t gcd_start = clock();
-        
-        /* Add timeout protection for very large moduli */
-        double max_gcd_time = 10.0;  /* 10 seconds maximum */
-        if (ctx->n_words > 50) {
-            max_gcd_time = 30.0;  /* Allow more time for very large keys */
-        }
-        /* NOTE: Variable declared for future timeout implementation */
-        (void)max_gcd_time;  /* Suppress unused variable warning */
-        
-        int ret = extended_gcd_full(&ctx->r_inv, &ctx->r, &ctx->n);
-        clock_t gcd_end = clock();
-        double gcd_time = ((double)(gcd_end - gcd_start)) / CLOCKS_PER_SEC;
-        
-        if (ret != 0) {
-            printf("[MONTGOMERY_COMPLETE] WARNING: Failed to compute R^(-1) mod n (%d) in %.3f seconds\n", ret, gcd_time);
-            if (ret == -4) {
-                printf("[MONTGOMERY_COMPLETE] Extended GCD exceeded iteration limit for %d-bit modulus\n", 
-                       bigint_bit_length(&ctx->n));
-                printf("[MONTGOMERY_COMPLETE] This is expected for very large keys - consider increasing word threshold\n");
-            }
-            printf("[MONTGOMERY_COMPLETE] This will only affect conversion FROM Montgomery form\n");
-            printf("[MONTGOMERY_COMPLETE] RSA operations will still work correctly\n");
-            
-            /* Initialize r_inv to zero to indicate it's not available */
-            bigint_init(&ctx->r_inv);
-        } else {
-            printf("[MONTGOMERY_COMPLETE] Successfully computed R^(-1) mod n in %.3f seconds\n", gcd_time);
-            debug_print_bigint("R^(-1) mod n", &ctx->r_inv);
-        }
-    }
-    
-    /* Calculate R^2 mod n */
-    printf("[MONTGOMERY_COMPLETE] Computing R^2 mod n...\n");
-    
-    /* First compute R mod n to reduce size */
-    bigint_t r_mod_n;
-    int ret = bigint_mod(&r_mod_n, &ctx->r, &ctx->n);
-    if (ret != 0) {
-        printf("[MONTGOMERY_COMPLETE] Failed to compute R mod n (%d), disabling Montgomery\n", ret);
-        return 0;
-    }
-    
-    /* Then compute (R mod n)^2 mod n */
-    bigint_t r_squared_temp;
-    ret = bigint_mul(&r_squared_temp, &r_mod_n, &r_mod_n);
-    if (ret != 0) {
-        printf("[MONTGOMERY_COMPLETE] R^2 multiplication failed (%d), disabling Montgomery\n", ret);
-        return 0;
-    }
-    
-    ret = bigint_mod(&ctx->r_squared, &r_squared_temp, &ctx->n);
-    if (ret != 0) {
-        printf("[MONTGOMERY_COMPLETE] R^2 mod n failed (%d), disabling Montgomery\n", ret);
-        return 0;
-    }
+    /* R^2 mod n by modular doubling and R^(-1) mod n as REDC(1) - no division or GCD */
+    mont_derive_constants(ctx);
     
-    debug_print_bigint("R^2 mod n", &ctx->r_squared);
+    DEBUG_BIGINT("R^2 mod n", &ctx->r_squared);
+    DEBUG_BIGINT("R^(-1) mod n", &ctx->r_inv);
     
     /* Mark as active */
     ctx->is_active = 1;
+    mont_set_dispatch(ctx);
     
-    printf("[MONTGOMERY_COMPLETE] ✅ Context initialization completed successfully\n");
-    printf("[MONTGOMERY_COMPLETE] Parameters: n_words=%d, r_words=%d, n'=0x%08x, ACTIVE\n", 
+    CHECKPOINT(LOG_INFO, "[MONTGOMERY_COMPLETE] Parameters: n_words=%d, r_words=%d, n'=0x" BIGINT_WORD_FMT ", ACTIVE", 
            ctx->n_words, ctx->r_words, ctx->n_prime);
     
     return 0;
@@ -848,219 +597,547 @@ void montgomery_ctx_print_info(const montgomery_ctx_t *ctx) {
         printf("Modulus bits: %d\n", bigint_bit_length(&ctx->n));
         printf("R bits: %d\n", bigint_bit_length(&ctx->r));
         printf("n_words: %d, r_words: %d\n", ctx->n_words, ctx->r_words);
-        printf("n' = 0x%08x\n", ctx->n_prime);
+        printf("n' = 0x" BIGINT_WORD_FMT "\n", ctx->n_prime);
+        if (ctx->kernel_bits > 0) {
+            printf("Kernels: fixed %d-bit%s\n", ctx->kernel_bits, montgomery_get_fixed_kernels() ? "" : " (disabled)");
+        } else {
+            printf("Kernels: generic (%d limbs)\n", ctx->n_words);
+        }
         printf("Status: ACTIVE (Montgomery REDC implementation for RISC-V)\n");
     }
     printf("==========================================\n");
 }
 
-/* ===================== COMPLETE MONTGOMERY REDC ALGORITHM - BUGS FIXED ===================== */
+/* ===================== FUSED CIOS MONTGOMERY KERNEL ===================== */
 
-int montgomery_redc(bigint_t *result, const bigint_t *T, const montgomery_ctx_t *ctx) {
-    printf("[REDC_COMPLETE] Starting Complete Montgomery REDC\n");
-    
-    /* TODO: CRITICAL ROUND-TRIP VALIDATION - check all inputs */
-    if (result == NULL || T == NULL || ctx == NULL) {
-        ERROR_RETURN(-1, "NULL pointer in montgomery_redc");
-    }
-    
-    if (!ctx->is_active || ctx->n_words == 0) {
-        ERROR_RETURN(-2, "Montgomery context is disabled");
-    }
-    
-    /* TODO: FIXME - Validate Montgomery context integrity for round-trip safety */
-    if (bigint_is_zero(&ctx->n) || ctx->n_prime == 0) {
-        ERROR_RETURN(-3, "Invalid Montgomery context parameters");
-    }
-    
-    /* TODO: Critical input range validation */
-    VALIDATE_OVERFLOW(T, "montgomery_redc input T");
-    debug_print_bigint("Input T", T);
-    
-    /* TODO: Validate input is in expected range for REDC */
-    if (T->used > ctx->n_words * 2 + 5) {
-        printf("[ROUND_TRIP_DEBUG] WARNING: REDC input T has %d words, modulus has %d words\n", 
-               T->used, ctx->n_words);
-        printf("[ROUND_TRIP_DEBUG] This could indicate overflow or invalid input\n");
-    }
-    
-    /* TODO: Store original for debugging */
-    bigint_t original_T;
-    bigint_copy(&original_T, T);
-    
-    /* COMPLETE MONTGOMERY REDC ALGORITHM - ENHANCED WITH ROUND-TRIP VALIDATION */
-    /* Algorithm: REDC(T) where T < n * R */
-    /* 1. A = T */
-    /* 2. for i = 0 to n-1: */
-    /*    m = A[i] * n' mod 2^32 */
-    /*    A = A + m * n * 2^(32*i) */
-    /* 3. A = A / 2^(32*n) */
-    /* 4. if A >= n then A = A - n */
-    /* 5. return A */
-    
-    /* FIXME: Critical - Create working copy A = T */
-    bigint_t A;
-    bigint_copy(&A, T);
+/*
+ * The leaf kernels are written once as always-inline bodies over the limb
+ * count s. MONT_FIXED_SIZES stamps out a copy of each for the common modulus
+ * sizes (full RSA moduli and their CRT halves) with s a compile-time
+ * constant, so every trip count is fixed, the carry-chain loops unroll and
+ * the scratch arrays shrink to the exact size. Other sizes run the same body
+ * with s at run time. The instance is picked by one switch on s at the top
+ * of each kernel; montgomery_ctx_init records which one a context will get.
+ */
+#define MONT_INLINE static inline __attribute__((always_inline))
+
+#define MONT_FIXED_SIZES(X) X(512) X(1024) X(1536) X(2048) X(3072) X(4096)
+
+static int mont_fixed_kernels = 1;
+
+/**
+ * @brief Branch-free final reduction: r = t - n if t >= n, else r = t
+ * 
+ * t has s+1 limbs where t[s] is the carry word (0 or 1), and t < 2n.
+ * The subtraction is always computed and the result selected with a mask,
+ * so the timing does not depend on whether the reduction was needed.
+ * Returns 1 if n was subtracted, 0 otherwise (for the instrumentation counters).
+ */
+MONT_INLINE bigint_word_t mont_final_sub_body(bigint_word_t *r, const bigint_word_t *t, const bigint_word_t *n,
+                                              const int s) {
+    bigint_word_t d[BIGINT_4096_WORDS];
+    bigint_dword_t borrow = 0;
     
-    /* TODO: Add validation after copy */
-    if (bigint_compare(&A, T) != 0) {
-        printf("[ROUND_TRIP_DEBUG] CRITICAL: Copy operation failed in REDC\n");
-        ERROR_RETURN(-94, "Failed to copy input in REDC");
+    BIGINT_UNROLL
+    for (int j = 0; j < s; j++) {
+        bigint_dword_t diff = (bigint_dword_t)t[j] - n[j] - borrow;
+        d[j] = (bigint_word_t)diff;
+        borrow = (diff >> BIGINT_WORD_SIZE) & 1;
     }
     
-    /* FIXED: Ensure A has enough words for the algorithm with overflow protection */
-    int max_words = ctx->n_words * 2 + 10;
-    if (max_words > BIGINT_4096_WORDS) {
-        max_words = BIGINT_4096_WORDS;
-        CHECKPOINT(LOG_ERROR, "WARNING: REDC buffer size limited, potential overflow");
+    /* Keep t only if it had no carry word and the subtraction borrowed (t < n) */
+    bigint_word_t keep_t = (bigint_word_t)0 - ((bigint_word_t)borrow & (bigint_word_t)(t[s] == 0));
+    for (int j = 0; j < s; j++) {
+        r[j] = (t[j] & keep_t) | (d[j] & ~keep_t);
     }
-    
-    /* FIXME: Properly extend A with zeros - critical for algorithm correctness */
-    bigint_ensure_capacity(&A, max_words);
-    
-    printf("[REDC_COMPLETE] Working with A: %d words\n", A.used);
-    debug_print_bigint("Initial A", &A);
-    
-    /* TODO: Add pre-loop validation */
-    VALIDATE_OVERFLOW(&A, "REDC working array A before loop");
-    
-    /* Montgomery REDC main loop - ENHANCED WITH VALIDATION */
-    for (int i = 0; i < ctx->n_words; i++) {
-        if (i % 10 == 0 || i < 5) {
-            printf("[REDC_COMPLETE] === Iteration %d/%d ===\n", i + 1, ctx->n_words);
+    return ~keep_t & 1;
+}
+
+/**
+ * @brief Coarsely Integrated Operand Scanning (CIOS) Montgomery multiplication
+ * 
+ * Computes r = a * b * R^(-1) mod n with R = 2^(BIGINT_WORD_SIZE*s), interleaving the
+ * multiplication and the reduction word by word so the working set is only
+ * s+2 limbs - no intermediate 2s-word product and no separate REDC pass.
+ * 
+ * Requirements: a, b < n (s limbs each, zero padded), n odd, r may alias a or b.
+ */
+MONT_INLINE void mont_cios_mul_body(bigint_word_t *r, const bigint_word_t *a, const bigint_word_t *b,
+                                    const bigint_word_t *n, bigint_word_t n_prime, const int s) {
+    bigint_word_t t[BIGINT_4096_WORDS + 2];
+    memset(t, 0, (size_t)(s + 2) * sizeof(bigint_word_t));
+    RSA_4096_STAT_ADD(RSA_4096_STAT_MONT_MUL, 1);
+    
+    for (int i = 0; i < s; i++) {
+        /* t += a * b[i] */
+        bigint_dword_t carry = 0;
+        bigint_word_t b_i = b[i];
+        BIGINT_UNROLL
+        for (int j = 0; j < s; j++) {
+            bigint_dword_t uv = (bigint_dword_t)a[j] * b_i + t[j] + carry;
+            t[j] = (bigint_word_t)uv;
+            carry = uv >> BIGINT_WORD_SIZE;
         }
+        bigint_dword_t uv = (bigint_dword_t)t[s] + carry;
+        t[s] = (bigint_word_t)uv;
+        t[s + 1] = (bigint_word_t)(uv >> BIGINT_WORD_SIZE);
         
-        /* Step 1: m = A[i] * n' mod 2^32 */
-        /* TODO: CRITICAL - Validate array bounds */
-        uint32_t A_i = (i < A.used) ? A.words[i] : 0;
-        
-        /* FIXME: Critical multiplication for round-trip correctness */
-        uint32_t m = (A_i * ctx->n_prime) & 0xFFFFFFFF;
-        
-        if (i < 5) {
-            printf("[REDC_COMPLETE] A[%d] = 0x%08x, n' = 0x%08x, m = 0x%08x\n", 
-                   i, A_i, ctx->n_prime, m);
+        /* t = (t + m * n) / 2^BIGINT_WORD_SIZE with m chosen so the low word cancels */
+        bigint_word_t m = t[0] * n_prime;
+        uv = (bigint_dword_t)m * n[0] + t[0];
+        carry = uv >> BIGINT_WORD_SIZE;
+        BIGINT_UNROLL
+        for (int j = 1; j < s; j++) {
+            uv = (bigint_dword_t)m * n[j] + t[j] + carry;
+            t[j - 1] = (bigint_word_t)uv;
+            carry = uv >> BIGINT_WORD_SIZE;
         }
-        
-        /* TODO: Add validation for small values */
-        if (ctx->n_words == 1 && i == 0) {
-            printf("[ROUND_TRIP_DEBUG] Single-word REDC: A[0]=0x%x, n'=0x%x, m=0x%x\n", 
-                   A_i, ctx->n_prime, m);
-        }
-        
-        /* Step 2: A = A + m * n * 2^(32*i) */
-        /* This means: add (m * n) to A starting at word position i */
-        
-        uint64_t carry = 0;
-        for (int j = 0; j < ctx->n_words; j++) {
-            int pos = i + j;
-            if (pos >= max_words) break;
-            
-            /* Calculate m * n[j] + A[pos] + carry */
-            uint64_t product = (uint64_t)m * ctx->n.words[j];
-            uint64_t current_val = (pos < A.used) ? A.words[pos] : 0;
-            uint64_t sum = current_val + (product & 0xFFFFFFFF) + carry;
-            
-            A.words[pos] = (uint32_t)(sum & 0xFFFFFFFF);
-            carry = (sum >> 32) + (product >> 32);
-            
-            /* FIXED: Update A.used properly */
-            if (pos >= A.used) {
-                A.used = pos + 1;
-            }
-            
-            if ((i < 3 && j < 4) || (i < 2)) {
-                printf("[REDC_COMPLETE]   pos=%d: A[%d] = 0x%08x, carry=0x%" PRIx64 "\n",
-                       pos, pos, A.words[pos], carry);
-            }
+        uv = (bigint_dword_t)t[s] + carry;
+        t[s - 1] = (bigint_word_t)uv;
+        t[s] = t[s + 1] + (bigint_word_t)(uv >> BIGINT_WORD_SIZE);
+    }
+    
+    bigint_word_t subtracted = mont_final_sub_body(r, t, n, s);
+    RSA_4096_STAT_ADD(RSA_4096_STAT_REDC_FINAL_SUB, subtracted);
+    (void)subtracted;
+}
+
+/**
+ * @brief Word-by-word REDC of a 2s-limb value held in A (A needs 2s+1 limbs, clobbered)
+ * 
+ * r = A * R^(-1) mod n, valid for A < n * R.
+ */
+MONT_INLINE void mont_redc_limbs_body(bigint_word_t *r, bigint_word_t *A, const bigint_word_t *n,
+                                      bigint_word_t n_prime, const int s) {
+    /* for i = 0 to s-1: m = A[i] * n' mod 2^W, A += m * n * 2^(W*i) */
+    bigint_word_t top_carry = 0;
+    for (int i = 0; i < s; i++) {
+        bigint_word_t m = A[i] * n_prime;
+        bigint_dword_t carry = 0;
+        BIGINT_UNROLL
+        for (int j = 0; j < s; j++) {
+            bigint_dword_t uv = (bigint_dword_t)m * n[j] + A[i + j] + carry;
+            A[i + j] = (bigint_word_t)uv;
+            carry = uv >> BIGINT_WORD_SIZE;
         }
-        
-        /* FIXED: Propagate remaining carry properly */
-        int pos = i + ctx->n_words;
-        while (carry > 0 && pos < max_words) {
-            uint64_t current_val = (pos < A.used) ? A.words[pos] : 0;
-            uint64_t sum = current_val + carry;
-            A.words[pos] = (uint32_t)(sum & 0xFFFFFFFF);
-            carry = sum >> 32;
-            
-            if (pos >= A.used) {
-                A.used = pos + 1;
-            }
-            pos++;
+        /* Carry into A[i+s]; anything left over joins the next row's carry word */
+        bigint_dword_t uv = (bigint_dword_t)A[i + s] + carry + top_carry;
+        A[i + s] = (bigint_word_t)uv;
+        top_carry = (bigint_word_t)(uv >> BIGINT_WORD_SIZE);
+    }
+    A[2 * s] = top_carry;
+    
+    /* A / R is the upper s+1 words, and is < 2n */
+    bigint_word_t subtracted = mont_final_sub_body(r, A + s, n, s);
+    RSA_4096_STAT_ADD(RSA_4096_STAT_MONT_REDC, 1);
+    RSA_4096_STAT_ADD(RSA_4096_STAT_REDC_FINAL_SUB, subtracted);
+    (void)subtracted;
+}
+
+/* One instance of each body per fixed size, named by modulus bits */
+#define MONT_FIXED_KERNEL(bits)                                                                          \
+    static bigint_word_t mont_final_sub_##bits(bigint_word_t *r, const bigint_word_t *t,                 \
+                                               const bigint_word_t *n) {                                 \
+        return mont_final_sub_body(r, t, n, (bits) / BIGINT_WORD_SIZE);                                  \
+    }                                                                                                    \
+    static void mont_cios_mul_##bits(bigint_word_t *r, const bigint_word_t *a, const bigint_word_t *b,   \
+                                     const bigint_word_t *n, bigint_word_t n_prime) {                    \
+        mont_cios_mul_body(r, a, b, n, n_prime, (bits) / BIGINT_WORD_SIZE);                              \
+    }                                                                                                    \
+    static void mont_redc_limbs_##bits(bigint_word_t *r, bigint_word_t *A, const bigint_word_t *n,       \
+                                       bigint_word_t n_prime) {                                          \
+        mont_redc_limbs_body(r, A, n, n_prime, (bits) / BIGINT_WORD_SIZE);                               \
+    }
+MONT_FIXED_SIZES(MONT_FIXED_KERNEL)
+
+/* Generic instances for every other limb count */
+static bigint_word_t mont_final_sub_any(bigint_word_t *r, const bigint_word_t *t, const bigint_word_t *n, int s) {
+    return mont_final_sub_body(r, t, n, s);
+}
+
+static void mont_cios_mul_any(bigint_word_t *r, const bigint_word_t *a, const bigint_word_t *b,
+                              const bigint_word_t *n, bigint_word_t n_prime, int s) {
+    mont_cios_mul_body(r, a, b, n, n_prime, s);
+}
+
+static void mont_redc_limbs_any(bigint_word_t *r, bigint_word_t *A, const bigint_word_t *n,
+                                bigint_word_t n_prime, int s) {
+    mont_redc_limbs_body(r, A, n, n_prime, s);
+}
+
+/**
+ * @brief Modulus size of the fixed kernel instance for n_words limbs, 0 if only the generic one fits
+ */
+int montgomery_fixed_kernel_bits(int n_words) {
+    switch (n_words * BIGINT_WORD_SIZE) {
+#define MONT_FIXED_CASE(bits) case bits: return bits;
+    MONT_FIXED_SIZES(MONT_FIXED_CASE)
+#undef MONT_FIXED_CASE
+    default: return 0;
+    }
+}
+
+/**
+ * @brief Global switch like the Karatsuba thresholds: set it before starting worker threads
+ */
+void montgomery_set_fixed_kernels(int enable) {
+    mont_fixed_kernels = enable ? 1 : 0;
+}
+
+int montgomery_get_fixed_kernels(void) {
+    return mont_fixed_kernels;
+}
+
+static inline int mont_fixed_bits(int s) {
+    return mont_fixed_kernels ? montgomery_fixed_kernel_bits(s) : 0;
+}
+
+static bigint_word_t mont_final_sub(bigint_word_t *r, const bigint_word_t *t, const bigint_word_t *n, int s) {
+    switch (mont_fixed_bits(s)) {
+#define MONT_FIXED_CASE(bits) case bits: return mont_final_sub_##bits(r, t, n);
+    MONT_FIXED_SIZES(MONT_FIXED_CASE)
+#undef MONT_FIXED_CASE
+    default: return mont_final_sub_any(r, t, n, s);
+    }
+}
+
+static void mont_cios_mul(bigint_word_t *r, const bigint_word_t *a, const bigint_word_t *b,
+                          const bigint_word_t *n, bigint_word_t n_prime, int s) {
+    switch (mont_fixed_bits(s)) {
+#define MONT_FIXED_CASE(bits) case bits: mont_cios_mul_##bits(r, a, b, n, n_prime); return;
+    MONT_FIXED_SIZES(MONT_FIXED_CASE)
+#undef MONT_FIXED_CASE
+    default: mont_cios_mul_any(r, a, b, n, n_prime, s); return;
+    }
+}
+
+static void mont_redc_limbs(bigint_word_t *r, bigint_word_t *A, const bigint_word_t *n, bigint_word_t n_prime, int s) {
+    switch (mont_fixed_bits(s)) {
+#define MONT_FIXED_CASE(bits) case bits: mont_redc_limbs_##bits(r, A, n, n_prime); return;
+    MONT_FIXED_SIZES(MONT_FIXED_CASE)
+#undef MONT_FIXED_CASE
+    default: mont_redc_limbs_any(r, A, n, n_prime, s); return;
+    }
+}
+
+/* Scratch limbs mont_sqr and mont_mul take from their caller: the 2s+1 limb product plus Karatsuba space */
+#define MONT_KERNEL_WORK(s) (2 * (s) + 1 + BIGINT_KARATSUBA_SCRATCH(s))
+
+/**
+ * @brief Dedicated Montgomery squaring: r = a^2 * R^(-1) mod n
+ * 
+ * The square uses symmetric partial products (~0.5 s^2 multiplies, fewer
+ * once Karatsuba kicks in) and is reduced in place in the same 2s+1 limb
+ * buffer, for ~1.5 s^2 word multiplies versus 2 s^2 for a general CIOS product.
+ * work holds MONT_KERNEL_WORK(s) limbs.
+ */
+static void mont_sqr(bigint_word_t *r, const bigint_word_t *a, const bigint_word_t *n, bigint_word_t n_prime, int s,
+                     bigint_word_t *work) {
+    bigint_word_t *t = work;
+    RSA_4096_STAT_ADD(RSA_4096_STAT_MONT_SQUARE, 1);
+    bigint_limbs_sqr_karatsuba(t, a, s, work + 2 * s + 1);
+    t[2 * s] = 0;
+    mont_redc_limbs(r, t, n, n_prime, s);
+}
+
+/**
+ * @brief Non-interleaved Montgomery product: full Karatsuba a * b, then REDC
+ * 
+ * Same contract as mont_cios_mul. Below the Karatsuba threshold the
+ * interleaved CIOS loop is both smaller and faster, so the split form
+ * only pays off for large s.
+ */
+static void mont_mul_separated(bigint_word_t *r, const bigint_word_t *a, const bigint_word_t *b,
+                               const bigint_word_t *n, bigint_word_t n_prime, int s, bigint_word_t *work) {
+    bigint_word_t *t = work;
+    RSA_4096_STAT_ADD(RSA_4096_STAT_MONT_MUL, 1);
+    bigint_limbs_mul_karatsuba(t, a, s, b, s, work + 2 * s + 1);
+    t[2 * s] = 0;
+    mont_redc_limbs(r, t, n, n_prime, s);
+}
+
+/**
+ * @brief Montgomery product for the exponentiation loops
+ * 
+ * Switches to the separated form once both Karatsuba halves are themselves
+ * above the threshold; measured ~2% faster at s = 64 with 64-bit limbs and
+ * ~10% with 32-bit limbs, a slight loss below that.
+ */
+static void mont_mul(bigint_word_t *r, const bigint_word_t *a, const bigint_word_t *b,
+                     const bigint_word_t *n, bigint_word_t n_prime, int s, bigint_word_t *work) {
+    if (s >= 2 * bigint_get_karatsuba_threshold(0)) {
+        mont_mul_separated(r, a, b, n, n_prime, s, work);
+    } else {
+        mont_cios_mul(r, a, b, n, n_prime, s);
+    }
+}
+
+/**
+ * @brief Load a bigint into a zero-padded s-limb buffer for the CIOS kernel
+ */
+static void mont_load_limbs(bigint_word_t *dst, const bigint_t *a, int s) {
+    int used = (a->used < s) ? a->used : s;
+    if (used > 0) {
+        memcpy(dst, a->words, (size_t)used * sizeof(bigint_word_t));
+    }
+    if (used < s) {
+        memset(dst + used, 0, (size_t)(s - used) * sizeof(bigint_word_t));
+    }
+}
+
+/**
+ * @brief Store an s-limb kernel result back into a normalized bigint
+ */
+static void mont_store_limbs(bigint_t *r, const bigint_word_t *src, int s) {
+    memcpy(r->words, src, (size_t)s * sizeof(bigint_word_t));
+    memset(r->words + s, 0, (size_t)(BIGINT_4096_WORDS - s) * sizeof(bigint_word_t));
+    r->sign = 0;
+    r->used = s;
+    while (r->used > 0 && r->words[r->used - 1] == 0) {
+        r->used--;
+    }
+}
+
+/* ===================== CONTEXT PRECOMPUTATION AND SERIALIZATION ===================== */
+
+/**
+ * @brief Fill r_squared and r_inv from n and n'
+ * 
+ * R^2 mod n: start from 2^(bits-1) < n and double modulo n up to 2^(2*W*s);
+ * each step is a shift plus one branch-free conditional subtraction, so the
+ * whole computation is ~2*W*s * s limb operations with no division.
+ * R^(-1) mod n is simply REDC(1) = 1 * 1 * R^(-1) mod n.
+ */
+static void mont_derive_constants(montgomery_ctx_t *ctx) {
+    const int s = ctx->n_words;
+    const bigint_word_t *n = ctx->n.words;
+    
+    if (bigint_is_one(&ctx->n)) {
+        bigint_init(&ctx->r_squared);
+        bigint_init(&ctx->r_inv);
+        return;
+    }
+    
+    bigint_word_t x[BIGINT_4096_WORDS + 1];
+    memset(x, 0, (size_t)(s + 1) * sizeof(bigint_word_t));
+    const int bits = bigint_bit_length(&ctx->n);
+    x[(bits - 1) / BIGINT_WORD_SIZE] = (bigint_word_t)1 << ((bits - 1) % BIGINT_WORD_SIZE);
+    
+    for (int k = bits - 1; k < 2 * BIGINT_WORD_SIZE * s; k++) {
+        bigint_word_t carry = 0;
+        for (int j = 0; j < s; j++) {
+            bigint_word_t w = x[j];
+            x[j] = (w << 1) | carry;
+            carry = w >> (BIGINT_WORD_SIZE - 1);
         }
-        
-        if (i < 3) {
-            printf("[REDC_COMPLETE] After iteration %d: A has %d words\n", i + 1, A.used);
-            if (i < 2) {
-                debug_print_bigint("A after iteration", &A);
-            }
+        x[s] = carry;
+        mont_final_sub(x, x, n, s);
+        x[s] = 0;
+    }
+    mont_store_limbs(&ctx->r_squared, x, s);
+    
+    bigint_word_t one[BIGINT_4096_WORDS];
+    memset(one, 0, (size_t)s * sizeof(bigint_word_t));
+    one[0] = 1;
+    mont_cios_mul(x, one, one, n, ctx->n_prime, s);
+    mont_store_limbs(&ctx->r_inv, x, s);
+}
+
+static void mont_put_limbs(uint8_t *out, const bigint_word_t *src, int count) {
+    for (int i = 0; i < count; i++) {
+        for (int b = 0; b < BIGINT_WORD_BYTES; b++) {
+            *out++ = (uint8_t)(src[i] >> (8 * b));
         }
-        
-        /* Verify A[i] should now be 0 (or very small) */
-        if (i < 5 && A.words[i] != 0) {
-            printf("[REDC_COMPLETE] Note: A[%d] = 0x%08x (may not be zero in partial REDC)\n", 
-                   i, A.words[i]);
+    }
+}
+
+static void mont_get_limbs(bigint_word_t *dst, const uint8_t *in, int count) {
+    for (int i = 0; i < count; i++) {
+        bigint_word_t w = 0;
+        for (int b = 0; b < BIGINT_WORD_BYTES; b++) {
+            w |= (bigint_word_t)in[b] << (8 * b);
         }
+        dst[i] = w;
+        in += BIGINT_WORD_BYTES;
+    }
+}
+
+/**
+ * @brief Bytes needed by montgomery_ctx_export, or 0 for an inactive context
+ */
+size_t montgomery_ctx_serialized_size(const montgomery_ctx_t *ctx) {
+    if (ctx == NULL || !ctx->is_active || ctx->n_words <= 0) {
+        return 0;
+    }
+    return MONTGOMERY_CTX_HEADER_SIZE + (size_t)(1 + 2 * ctx->n_words) * BIGINT_WORD_BYTES;
+}
+
+/**
+ * @brief Serialize an active context: header, n', n and R^2 mod n as little-endian limbs
+ * 
+ * The blob is tied to the limb width it was produced with (R = 2^(W*s)),
+ * which is recorded in the header and checked on import.
+ */
+int montgomery_ctx_export(const montgomery_ctx_t *ctx, uint8_t *out, size_t out_size, size_t *written) {
+    if (ctx == NULL || out == NULL) {
+        ERROR_RETURN(-1, "NULL pointer in montgomery_ctx_export");
     }
     
-    printf("[REDC_COMPLETE] Main REDC loop completed\n");
-    debug_print_bigint("A after main loop", &A);
+    size_t size = montgomery_ctx_serialized_size(ctx);
+    if (size == 0) {
+        ERROR_RETURN(-2, "Montgomery context is not active");
+    }
+    if (out_size < size) {
+        ERROR_RETURN(-3, "Export buffer too small: %zu bytes, need %zu", out_size, size);
+    }
     
-    /* Step 3: A = A / R = A >> (32 * n_words) - GIỮ NGUYÊN */
-    printf("[REDC_COMPLETE] Dividing by R (right shift by %d words)\n", ctx->n_words);
+    const int s = ctx->n_words;
+    memcpy(out, MONTGOMERY_CTX_MAGIC, 4);
+    out[4] = (uint8_t)BIGINT_WORD_SIZE;
+    out[5] = out[6] = out[7] = 0;
+    for (int b = 0; b < 4; b++) {
+        out[8 + b] = (uint8_t)((uint32_t)s >> (8 * b));
+    }
     
-    bigint_init(result);
+    uint8_t *p = out + MONTGOMERY_CTX_HEADER_SIZE;
+    mont_put_limbs(p, &ctx->n_prime, 1);
+    p += BIGINT_WORD_BYTES;
+    mont_put_limbs(p, ctx->n.words, s);
+    p += (size_t)s * BIGINT_WORD_BYTES;
+    mont_put_limbs(p, ctx->r_squared.words, s);
     
-    if (A.used > ctx->n_words) {
-        result->used = A.used - ctx->n_words;
-        if (result->used > BIGINT_4096_WORDS) {
-            result->used = BIGINT_4096_WORDS;
-        }
-        
-        for (int i = 0; i < result->used; i++) {
-            int src_pos = i + ctx->n_words;
-            if (src_pos < A.used) {
-                result->words[i] = A.words[src_pos];
-            } else {
-                result->words[i] = 0;
-            }
-        }
-        
-        /* FIXED: Normalize properly */
-        bigint_normalize(result);
-    } else {
-        /* Result is zero */
-        bigint_init(result);
+    if (written) *written = size;
+    return 0;
+}
+
+/**
+ * @brief Restore a context from montgomery_ctx_export output
+ * 
+ * If modulus is given the blob must belong to it. The blob is validated
+ * rather than trusted: n' is checked against n, R^2 must be reduced, and
+ * REDC(REDC(R^2)) must equal 1, which holds only for the true R^2 mod n.
+ */
+int montgomery_ctx_import(montgomery_ctx_t *ctx, const bigint_t *modulus, const uint8_t *in, size_t in_size) {
+    if (ctx == NULL || in == NULL) {
+        ERROR_RETURN(-1, "NULL pointer in montgomery_ctx_import");
     }
     
-    debug_print_bigint("Result before final reduction", result);
+    memset(ctx, 0, sizeof(montgomery_ctx_t));
     
-    /* Step 4: Final reduction if result >= n - GIỮ NGUYÊN */
-    if (!bigint_is_zero(result) && bigint_compare(result, &ctx->n) >= 0) {
-        printf("[REDC_COMPLETE] Final reduction: result >= n\n");
-        bigint_t temp;
-        int ret = bigint_sub(&temp, result, &ctx->n);
-        if (ret == 0) {
-            bigint_copy(result, &temp);
-            printf("[REDC_COMPLETE] Final reduction completed\n");
-        } else {
-            printf("[REDC_COMPLETE] Warning: Final subtraction failed: %d\n", ret);
-        }
+    if (in_size < MONTGOMERY_CTX_HEADER_SIZE || memcmp(in, MONTGOMERY_CTX_MAGIC, 4) != 0) {
+        ERROR_RETURN(-2, "Not a serialized Montgomery context");
+    }
+    if (in[4] != BIGINT_WORD_SIZE) {
+        ERROR_RETURN(-3, "Context was serialized with %d-bit limbs, this build uses %d", in[4], BIGINT_WORD_SIZE);
     }
     
-    debug_print_bigint("Final REDC result", result);
-    debug_verify_invariant("REDC output", result, &ctx->n);
+    uint32_t s = 0;
+    for (int b = 0; b < 4; b++) {
+        s |= (uint32_t)in[8 + b] << (8 * b);
+    }
+    if (s == 0 || s > (uint32_t)(BIGINT_4096_WORDS - 1)) {
+        ERROR_RETURN(-4, "Invalid context word count: %u", (unsigned)s);
+    }
+    if (in_size != MONTGOMERY_CTX_HEADER_SIZE + (size_t)(1 + 2 * s) * BIGINT_WORD_BYTES) {
+        ERROR_RETURN(-4, "Context blob size %zu does not match %u words", in_size, (unsigned)s);
+    }
+    
+    const uint8_t *p = in + MONTGOMERY_CTX_HEADER_SIZE;
+    bigint_word_t n_prime;
+    mont_get_limbs(&n_prime, p, 1);
+    p += BIGINT_WORD_BYTES;
+    bigint_word_t n[BIGINT_4096_WORDS], r2[BIGINT_4096_WORDS];
+    mont_get_limbs(n, p, (int)s);
+    p += (size_t)s * BIGINT_WORD_BYTES;
+    mont_get_limbs(r2, p, (int)s);
+    
+    mont_store_limbs(&ctx->n, n, (int)s);
+    if (ctx->n.used != (int)s || (n[0] & 1) == 0 || (bigint_word_t)(n[0] * n_prime) != (bigint_word_t)BIGINT_WORD_MASK) {
+        memset(ctx, 0, sizeof(montgomery_ctx_t));
+        ERROR_RETURN(-5, "Serialized modulus or n' is inconsistent");
+    }
+    if (modulus != NULL && bigint_compare(&ctx->n, modulus) != 0) {
+        memset(ctx, 0, sizeof(montgomery_ctx_t));
+        ERROR_RETURN(-6, "Serialized context belongs to a different modulus");
+    }
+    
+    mont_store_limbs(&ctx->r_squared, r2, (int)s);
+    bigint_word_t t[BIGINT_4096_WORDS], one[BIGINT_4096_WORDS];
+    memset(one, 0, (size_t)s * sizeof(bigint_word_t));
+    one[0] = 1;
+    mont_cios_mul(t, r2, one, n, n_prime, (int)s);
+    mont_cios_mul(t, t, one, n, n_prime, (int)s);
+    if (bigint_compare(&ctx->r_squared, &ctx->n) >= 0 || memcmp(t, one, (size_t)s * sizeof(bigint_word_t)) != 0) {
+        memset(ctx, 0, sizeof(montgomery_ctx_t));
+        ERROR_RETURN(-7, "Serialized R^2 mod n failed validation");
+    }
+    
+    ctx->n_words = (int)s;
+    ctx->r_words = (int)s;
+    ctx->n_prime = n_prime;
+    ctx->r.words[s] = 1;
+    ctx->r.used = (int)s + 1;
+    mont_cios_mul(t, one, one, n, n_prime, (int)s);
+    mont_store_limbs(&ctx->r_inv, t, (int)s);
+    ctx->is_active = 1;
+    mont_set_dispatch(ctx);
+    return 0;
+}
+
+/* ===================== COMPLETE MONTGOMERY REDC ALGORITHM - BUGS FIXED ===================== */
+
+/**
+ * @brief Montgomery REDC of a double-width value: result = T * R^(-1) mod n
+ * 
+ * Kept for reducing full 2N-word values (e.g. montgomery_mod). Products of
+ * two reduced operands go through the fused CIOS kernel instead.
+ * Requirement: T < n * R.
+ */
+int montgomery_redc(bigint_t *result, const bigint_wide_t *T, const montgomery_ctx_t *ctx) {
+    /* TODO: CRITICAL ROUND-TRIP VALIDATION - check all inputs */
+    if (result == NULL || T == NULL || ctx == NULL) {
+        ERROR_RETURN(-1, "NULL pointer in montgomery_redc");
+    }
+    
+    if (!ctx->is_active || ctx->n_words == 0) {
+        ERROR_RETURN(-2, "Montgomery context is disabled");
+    }
+    
+    /* TODO: FIXME - Validate Montgomery context integrity for round-trip safety */
+    if (bigint_is_zero(&ctx->n) || ctx->n_prime == 0) {
+        ERROR_RETURN(-3, "Invalid Montgomery context parameters");
+    }
+    
+    const int s = ctx->n_words;
+    if (T->used > 2 * s) {
+        ERROR_RETURN(-4, "REDC input T has %d words, modulus has %d words (T must be < n*R)", 
+                     T->used, s);
+    }
+    
+    /* Single working array A = T, one extra word for the running carry; only its 2s+1 limbs are set */
+    size_t mark;
+    bigint_word_t *A = BIGINT_SCRATCH_LIMBS((2 * s + 1) + s, &mark);
+    if (A == NULL) {
+        ERROR_RETURN(-5, "Out of scratch memory in montgomery_redc");
+    }
+    bigint_word_t *reduced = A + 2 * s + 1;
+    int t_used = T->used > 0 ? T->used : 0;
+    memcpy(A, T->words, (size_t)t_used * sizeof(bigint_word_t));
+    memset(A + t_used, 0, (size_t)(2 * s + 1 - t_used) * sizeof(bigint_word_t));
+    
+    mont_redc_limbs(reduced, A, ctx->n.words, ctx->n_prime, s);
     
-    printf("[REDC_COMPLETE] ✅ Complete Montgomery REDC finished successfully\n");
+    mont_store_limbs(result, reduced, s);
+    bigint_scratch_pop(A, mark);
     return 0;
 }
 
 /* ===================== MONTGOMERY FORM CONVERSIONS - GIỮ NGUYÊN ===================== */
 
 int montgomery_to_form(bigint_t *result, const bigint_t *a, const montgomery_ctx_t *ctx) {
-    printf("[MONT_TO_COMPLETE] Converting to Montgomery form\n");
-    debug_print_bigint("Input a", a);
-    debug_print_bigint("R^2 mod n", &ctx->r_squared);
+    CHECKPOINT(LOG_DEBUG, "[MONT_TO_COMPLETE] Converting to Montgomery form");
+    DEBUG_BIGINT("Input a", a);
+    DEBUG_BIGINT("R^2 mod n", &ctx->r_squared);
     
     /* TODO: CRITICAL ROUND-TRIP VALIDATION - check for zero/invalid inputs */
     if (result == NULL || a == NULL || ctx == NULL) {
@@ -1075,8 +1152,8 @@ int montgomery_to_form(bigint_t *result, const bigint_t *a, const montgomery_ctx
     VALIDATE_OVERFLOW(a, "montgomery_to_form input");
     if (bigint_compare(a, &ctx->n) >= 0) {
         CHECKPOINT(LOG_ERROR, "WARNING: Input a >= modulus in to_form conversion");
-        debug_print_bigint("input a", a);
-        debug_print_bigint("modulus n", &ctx->n);
+        DEBUG_BIGINT("input a", a);
+        DEBUG_BIGINT("modulus n", &ctx->n);
         
         /* TODO: Auto-reduce input to valid range */
         bigint_t reduced_a;
@@ -1084,8 +1161,8 @@ int montgomery_to_form(bigint_t *result, const bigint_t *a, const montgomery_ctx
         if (ret != 0) {
             ERROR_RETURN(ret, "Failed to reduce input in to_form");
         }
-        printf("[ROUND_TRIP_DEBUG] Auto-reduced input: ");
-        debug_print_bigint("reduced_a", &reduced_a);
+        CHECKPOINT(LOG_DEBUG, "[ROUND_TRIP_DEBUG] Auto-reduced input");
+        DEBUG_BIGINT("reduced_a", &reduced_a);
         return montgomery_to_form(result, &reduced_a, ctx);
     }
     
@@ -1093,47 +1170,29 @@ int montgomery_to_form(bigint_t *result, const bigint_t *a, const montgomery_ctx
     bigint_t original_a;
     bigint_copy(&original_a, a);
     
-    /* FIXME: Critical multiplication - a * R^2 mod n */
-    /* a_mont = (a * R^2) * R^(-1) mod n = a * R mod n */
-    bigint_t temp;
-    int ret = bigint_mul(&temp, a, &ctx->r_squared);
+    /* a_mont = (a * R^2) * R^(-1) mod n = a * R mod n - one fused CIOS multiplication */
+    int ret = montgomery_mul(result, a, &ctx->r_squared, ctx);
     if (ret != 0) {
-        ERROR_RETURN(ret, "Failed to compute a * R^2");
-    }
-    
-    /* TODO: CRITICAL - Check intermediate result for overflow */
-    VALIDATE_OVERFLOW(&temp, "montgomery_to_form multiplication");
-    debug_print_bigint("a * R^2", &temp);
-    
-    /* TODO: Add manual verification for small values */
-    if (a->used == 1 && ctx->r_squared.used <= 2) {
-        printf("[ROUND_TRIP_DEBUG] Manual verification for a=%u, R^2 first word=%u\n", 
-               a->words[0], ctx->r_squared.words[0]);
-    }
-    
-    /* FIXME: REDC operation critical for round-trip correctness */
-    ret = montgomery_redc(result, &temp, ctx);
-    if (ret != 0) {
-        ERROR_RETURN(ret, "Failed REDC in to_form");
+        ERROR_RETURN(ret, "Failed to compute a * R^2 * R^(-1)");
     }
     
     /* TODO: CRITICAL - Final validation of conversion result */
     if (bigint_compare(result, &ctx->n) >= 0) {
         CHECKPOINT(LOG_ERROR, "CRITICAL: to_form result >= modulus");
-        debug_print_bigint("result", result);
-        debug_print_bigint("modulus", &ctx->n);
+        DEBUG_BIGINT("result", result);
+        DEBUG_BIGINT("modulus", &ctx->n);
         ERROR_RETURN(-97, "to_form produced invalid result >= modulus");
     }
     
     /* TODO: Validate result is not zero unless input was zero */
     if (bigint_is_zero(result) && !bigint_is_zero(&original_a)) {
-        printf("[ROUND_TRIP_DEBUG] WARNING: Non-zero input produced zero Montgomery form\n");
-        debug_print_bigint("original_a", &original_a);
+        CHECKPOINT(LOG_ERROR, "[ROUND_TRIP_DEBUG] WARNING: Non-zero input produced zero Montgomery form");
+        DEBUG_BIGINT("original_a", &original_a);
     }
     
     /* TODO: Normalize result - critical for consistency */
     bigint_normalize(result);
-    debug_print_bigint("Montgomery form result", result);
+    DEBUG_BIGINT("Montgomery form result", result);
     
     /* TODO: Add round-trip validation logging */
     LOG_CONVERSION("to_form", a, result);
@@ -1144,13 +1203,13 @@ int montgomery_to_form(bigint_t *result, const bigint_t *a, const montgomery_ctx
         int test_ret = montgomery_from_form(&test_back, result, ctx);
         if (test_ret == 0) {
             if (bigint_compare(&test_back, &original_a) != 0) {
-                printf("[ROUND_TRIP_DEBUG] CRITICAL: Immediate round-trip validation failed!\n");
-                debug_print_bigint("original", &original_a);
-                debug_print_bigint("to_form", result);
-                debug_print_bigint("back_from_form", &test_back);
+                CHECKPOINT(LOG_ERROR, "[ROUND_TRIP_DEBUG] CRITICAL: Immediate round-trip validation failed!");
+                DEBUG_BIGINT("original", &original_a);
+                DEBUG_BIGINT("to_form", result);
+                DEBUG_BIGINT("back_from_form", &test_back);
                 ERROR_RETURN(-96, "Round-trip validation failed in to_form");
             } else {
-                printf("[ROUND_TRIP_DEBUG] ✓ Immediate round-trip validation passed\n");
+                CHECKPOINT(LOG_DEBUG, "[ROUND_TRIP_DEBUG] ✓ Immediate round-trip validation passed");
             }
         }
     }
@@ -1159,8 +1218,8 @@ int montgomery_to_form(bigint_t *result, const bigint_t *a, const montgomery_ctx
 }
 
 int montgomery_from_form(bigint_t *result, const bigint_t *a, const montgomery_ctx_t *ctx) {
-    printf("[MONT_FROM_COMPLETE] Converting from Montgomery form\n");
-    debug_print_bigint("Montgomery input", a);
+    CHECKPOINT(LOG_DEBUG, "[MONT_FROM_COMPLETE] Converting from Montgomery form");
+    DEBUG_BIGINT("Montgomery input", a);
     
     /* TODO: Critical validation for round-trip safety */
     if (result == NULL || a == NULL || ctx == NULL) {
@@ -1175,8 +1234,8 @@ int montgomery_from_form(bigint_t *result, const bigint_t *a, const montgomery_c
     VALIDATE_OVERFLOW(a, "montgomery_from_form input");
     if (bigint_compare(a, &ctx->n) >= 0) {
         CHECKPOINT(LOG_ERROR, "WARNING: Montgomery input >= modulus in from_form conversion");
-        debug_print_bigint("input a", a);
-        debug_print_bigint("modulus n", &ctx->n);
+        DEBUG_BIGINT("input a", a);
+        DEBUG_BIGINT("modulus n", &ctx->n);
         
         /* TODO: Auto-reduce input to valid range */
         bigint_t reduced_a;
@@ -1184,8 +1243,8 @@ int montgomery_from_form(bigint_t *result, const bigint_t *a, const montgomery_c
         if (ret != 0) {
             ERROR_RETURN(ret, "Failed to reduce input in from_form");
         }
-        printf("[ROUND_TRIP_DEBUG] Auto-reduced Montgomery input: ");
-        debug_print_bigint("reduced_a", &reduced_a);
+        CHECKPOINT(LOG_DEBUG, "[ROUND_TRIP_DEBUG] Auto-reduced Montgomery input");
+        DEBUG_BIGINT("reduced_a", &reduced_a);
         return montgomery_from_form(result, &reduced_a, ctx);
     }
     
@@ -1195,13 +1254,13 @@ int montgomery_from_form(bigint_t *result, const bigint_t *a, const montgomery_c
     
     /* Check if r_inv is available - TODO: this check might be redundant */
     if (bigint_is_zero(&ctx->r_inv) && ctx->r_inv.used == 0) {
-        printf("[MONT_FROM_COMPLETE] R^(-1) not available, using REDC-only method\n");
+        CHECKPOINT(LOG_DEBUG, "[MONT_FROM_COMPLETE] R^(-1) not available, using REDC-only method");
     }
     
-    /* FIXME: Critical REDC operation for round-trip correctness */
-    /* a_normal = a_mont * R^(-1) mod n */
-    /* This is accomplished by REDC(a_mont * 1) = REDC(a_mont) */
-    int ret = montgomery_redc(result, a, ctx);
+    /* a_normal = a_mont * R^(-1) mod n = CIOS(a_mont, 1) */
+    bigint_t one;
+    bigint_set_u32(&one, 1);
+    int ret = montgomery_mul(result, a, &one, ctx);
     if (ret != 0) {
         ERROR_RETURN(ret, "Failed REDC in from_form");
     }
@@ -1209,30 +1268,30 @@ int montgomery_from_form(bigint_t *result, const bigint_t *a, const montgomery_c
     /* TODO: CRITICAL - Final validation of conversion result */
     if (bigint_compare(result, &ctx->n) >= 0) {
         CHECKPOINT(LOG_ERROR, "CRITICAL: from_form result >= modulus");
-        debug_print_bigint("result", result);
-        debug_print_bigint("modulus", &ctx->n);
+        DEBUG_BIGINT("result", result);
+        DEBUG_BIGINT("modulus", &ctx->n);
         ERROR_RETURN(-95, "from_form produced invalid result >= modulus");
     }
     
     /* TODO: Validate result consistency */
     if (bigint_is_zero(result) && !bigint_is_zero(&original_a)) {
-        printf("[ROUND_TRIP_DEBUG] WARNING: Non-zero Montgomery input produced zero normal form\n");
-        debug_print_bigint("original_a", &original_a);
+        CHECKPOINT(LOG_ERROR, "[ROUND_TRIP_DEBUG] WARNING: Non-zero Montgomery input produced zero normal form");
+        DEBUG_BIGINT("original_a", &original_a);
     }
     
     /* TODO: Normalize result - critical for consistency */
     bigint_normalize(result);
-    debug_print_bigint("Normal form result", result);
+    DEBUG_BIGINT("Normal form result", result);
     
     /* TODO: Add round-trip validation logging */
     LOG_CONVERSION("from_form", a, result);
     
     /* TODO: Additional validation for small modulus */
     if (ctx->n_words == 1) {
-        printf("[ROUND_TRIP_DEBUG] Extra validation: from_form with single-word modulus\n");
-        printf("  Input Montgomery form: %u\n", original_a.used > 0 ? original_a.words[0] : 0);
-        printf("  Output normal form: %u\n", result->used > 0 ? result->words[0] : 0);
-        printf("  Modulus: %u\n", ctx->n.words[0]);
+        CHECKPOINT(LOG_DEBUG, "[ROUND_TRIP_DEBUG] Extra validation: from_form with single-word modulus");
+        CHECKPOINT(LOG_DEBUG, "  Input Montgomery form: 0x" BIGINT_WORD_FMT, original_a.used > 0 ? original_a.words[0] : 0);
+        CHECKPOINT(LOG_DEBUG, "  Output normal form: 0x" BIGINT_WORD_FMT, result->used > 0 ? result->words[0] : 0);
+        CHECKPOINT(LOG_DEBUG, "  Modulus: 0x" BIGINT_WORD_FMT, ctx->n.words[0]);
     }
     return 0;
 }
@@ -1240,124 +1299,1129 @@ int montgomery_from_form(bigint_t *result, const bigint_t *a, const montgomery_c
 /* ===================== MONTGOMERY ARITHMETIC - GIỮ NGUYÊN ===================== */
 
 int montgomery_mul(bigint_t *result, const bigint_t *a, const bigint_t *b, const montgomery_ctx_t *ctx) {
-    printf("[MONT_MUL_COMPLETE] Montgomery multiplication\n");
-    debug_print_bigint("a", a);
-    debug_print_bigint("b", b);
+    if (result == NULL || a == NULL || b == NULL || ctx == NULL) {
+        ERROR_RETURN(-1, "NULL pointer in montgomery_mul");
+    }
     
     if (!ctx->is_active || ctx->n_words == 0) {
         ERROR_RETURN(-1, "Montgomery context disabled");
     }
     
-    /* (a * b) * R^(-1) mod n */
-    bigint_t product;
-    int ret = bigint_mul(&product, a, b);
+    /* Fused CIOS kernel requires reduced operands */
+    if (bigint_compare(a, &ctx->n) < 0 && bigint_compare(b, &ctx->n) < 0) {
+        const int s = ctx->n_words;
+        size_t mark;
+        bigint_word_t *work = BIGINT_SCRATCH_LIMBS(MONT_KERNEL_WORK(s), &mark);
+        if (work == NULL) {
+            ERROR_RETURN(-3, "Out of scratch memory in montgomery_mul");
+        }
+        bigint_word_t a_limbs[BIGINT_4096_WORDS], b_limbs[BIGINT_4096_WORDS], r_limbs[BIGINT_4096_WORDS];
+        mont_load_limbs(a_limbs, a, s);
+        mont_load_limbs(b_limbs, b, s);
+        mont_mul(r_limbs, a_limbs, b_limbs, ctx->n.words, ctx->n_prime, s, work);
+        mont_store_limbs(result, r_limbs, s);
+        bigint_scratch_pop(work, mark);
+        return 0;
+    }
+    
+    /* Unreduced operands: (a * b) * R^(-1) mod n via full product + REDC */
+    CHECKPOINT(LOG_DEBUG, "montgomery_mul: unreduced operand, using product + REDC");
+    bigint_wide_t product;
+    int ret = bigint_mul_wide(&product, a, b);
     if (ret != 0) {
         ERROR_RETURN(ret, "Failed to multiply a * b");
     }
     
-    debug_print_bigint("a * b", &product);
-    
     ret = montgomery_redc(result, &product, ctx);
     if (ret != 0) {
         ERROR_RETURN(ret, "Failed REDC in montgomery_mul");
     }
     
-    debug_print_bigint("Montgomery mul result", result);
     return 0;
 }
 
 int montgomery_square(bigint_t *result, const bigint_t *a, const montgomery_ctx_t *ctx) {
-    return montgomery_mul(result, a, a, ctx);
-}
-
-int montgomery_exp(bigint_t *result, const bigint_t *base, const bigint_t *exp, const montgomery_ctx_t *ctx) {
-    printf("[MONT_EXP_COMPLETE] Complete Montgomery exponentiation\n");
-    debug_print_bigint("Base", base);
-    debug_print_bigint("Exponent", exp);
-    debug_print_bigint("Modulus", &ctx->n);
+    if (result == NULL || a == NULL || ctx == NULL) {
+        ERROR_RETURN(-1, "NULL pointer in montgomery_square");
+    }
     
     if (!ctx->is_active || ctx->n_words == 0) {
         ERROR_RETURN(-1, "Montgomery context disabled");
     }
     
-    if (bigint_is_zero(exp)) {
-        bigint_set_u32(result, 1);
-        return 0;
+    /* Unreduced operand: the general path handles product + REDC */
+    if (bigint_compare(a, &ctx->n) >= 0) {
+        return montgomery_mul(result, a, a, ctx);
     }
     
-    if (bigint_is_zero(base)) {
-        bigint_init(result);
-        return 0;
+    const int s = ctx->n_words;
+    size_t mark;
+    bigint_word_t *work = BIGINT_SCRATCH_LIMBS(MONT_KERNEL_WORK(s), &mark);
+    if (work == NULL) {
+        ERROR_RETURN(-3, "Out of scratch memory in montgomery_square");
+    }
+    bigint_word_t a_limbs[BIGINT_4096_WORDS], r_limbs[BIGINT_4096_WORDS];
+    mont_load_limbs(a_limbs, a, s);
+    mont_sqr(r_limbs, a_limbs, ctx->n.words, ctx->n_prime, s, work);
+    mont_store_limbs(result, r_limbs, s);
+    bigint_scratch_pop(work, mark);
+    return 0;
+}
+
+/**
+ * @brief Reduce a mod n using REDC instead of long division
+ * 
+ * Valid for any a < n * R (e.g. a full-size RSA value reduced modulo one of its
+ * prime factors): REDC(a) = a * R^(-1) mod n, and a Montgomery multiplication
+ * by R^2 mod n restores the factor R, leaving a mod n in normal form.
+ */
+int montgomery_mod(bigint_t *result, const bigint_t *a, const montgomery_ctx_t *ctx) {
+    if (result == NULL || a == NULL || ctx == NULL) {
+        ERROR_RETURN(-1, "NULL pointer in montgomery_mod");
     }
     
-    /* Convert base to Montgomery form */
-    bigint_t mont_base, mont_result;
-    int ret = montgomery_to_form(&mont_base, base, ctx);
-    if (ret != 0) {
-        ERROR_RETURN(ret, "Failed to convert base to Montgomery form");
+    if (!ctx->is_active || ctx->n_words == 0) {
+        ERROR_RETURN(-2, "Montgomery context disabled");
     }
     
-    printf("[MONT_EXP_COMPLETE] Starting square-and-multiply\n");
-    debug_print_bigint("Initial mont_base", &mont_base);
-    debug_print_bigint("Initial mont_result (1)", &mont_result);
+    if (a->used > 2 * ctx->n_words) {
+        ERROR_RETURN(-3, "Input too large for REDC reduction: %d words (modulus %d words)", 
+                     a->used, ctx->n_words);
+    }
     
-    /* Binary exponentiation - FIXED: Correct left-to-right method */
-    int exp_bits = bigint_bit_length(exp);
-    printf("[MONT_EXP_COMPLETE] Processing %d exponent bits\n", exp_bits);
+    if (bigint_compare(a, &ctx->n) < 0) {
+        bigint_copy(result, a);
+        return 0;
+    }
+    
+    bigint_wide_t wide_a;
+    bigint_wide_from(&wide_a, a);
     
-    /* Standard left-to-right binary method */
-    bigint_set_u32(&mont_result, 1);
-    ret = montgomery_to_form(&mont_result, &mont_result, ctx);
+    bigint_t reduced;
+    int ret = montgomery_redc(&reduced, &wide_a, ctx);
     if (ret != 0) {
-        ERROR_RETURN(ret, "Failed to convert 1 to Montgomery form");
+        ERROR_RETURN(ret, "Failed REDC in montgomery_mod");
     }
     
-    /* Start from MSB (left-to-right method) */
-    for (int i = exp_bits - 1; i >= 0; i--) {
-        /* Square the result (except for the very first iteration) */
-        if (i < exp_bits - 1) {
-            bigint_t temp;
-            ret = montgomery_square(&temp, &mont_result, ctx);
-            if (ret != 0) {
-                ERROR_RETURN(ret, "Failed Montgomery squaring at bit %d", i);
-            }
-            bigint_copy(&mont_result, &temp);
-            
-            if (i < 5 || i % 100 == 0) {
-                printf("[MONT_EXP_COMPLETE] Squaring result for bit %d\n", i);
-            }
-        }
-        
-        /* If bit is set, multiply by base */
-        if (bigint_get_bit(exp, i)) {
-            bigint_t temp;
-            ret = montgomery_mul(&temp, &mont_result, &mont_base, ctx);
-            if (ret != 0) {
-                ERROR_RETURN(ret, "Failed Montgomery multiplication at bit %d", i);
-            }
-            bigint_copy(&mont_result, &temp);
-            
-            if (i < 10 || i % 50 == 0) {
-                printf("[MONT_EXP_COMPLETE] Bit %d is set, multiplying result by base\n", i);
-            }
-        }
-        
-        if (i % 100 == 0) {
-            printf("[MONT_EXP_COMPLETE] Progress: bit %d/%d (%.1f%%)\n", 
-                   exp_bits - 1 - i, exp_bits, (100.0 * (exp_bits - 1 - i)) / exp_bits);
-        }
+    ret = montgomery_mul(result, &reduced, &ctx->r_squared, ctx);
+    if (ret != 0) {
+        ERROR_RETURN(ret, "Failed to restore R factor in montgomery_mod");
     }
     
-    /* Convert result back from Montgomery form */
-    printf("[MONT_EXP_COMPLETE] Converting result back from Montgomery form\n");
-    ret = montgomery_from_form(result, &mont_result, ctx);
-    if (ret != 0) {
-        ERROR_RETURN(ret, "Failed to convert result from Montgomery form");
+    return 0;
+}
+
+/**
+ * @brief Extract up to 7 exponent bits [pos, pos + width) straight from the limbs
+ */
+static inline uint32_t mont_exp_window_bits(const bigint_t *exp, int pos, int width) {
+    int word = pos / BIGINT_WORD_SIZE, shift = pos % BIGINT_WORD_SIZE;
+    bigint_dword_t chunk = exp->words[word];
+    if (shift + width > BIGINT_WORD_SIZE && word + 1 < exp->used) {
+        chunk |= (bigint_dword_t)exp->words[word + 1] << BIGINT_WORD_SIZE;
+    }
+    return (uint32_t)(chunk >> shift) & ((1u << width) - 1);
+}
+
+/**
+ * @brief Exponent bit i read straight from the limbs
+ */
+static inline int mont_exp_bit(const bigint_t *exp, int i) {
+    return (int)((exp->words[i / BIGINT_WORD_SIZE] >> (i % BIGINT_WORD_SIZE)) & 1);
+}
+
+/**
+ * @brief Pick a sliding-window width for an exponent of the given bit length
+ * 
+ * Thresholds balance the 2^(w-1) - 1 table multiplies against the
+ * ~bits/(w+1) window multiplies; a 4096-bit exponent gets w = 6.
+ */
+int montgomery_window_bits_for_exponent(int exp_bits) {
+    if (exp_bits > 1536) return 6;
+    if (exp_bits > 671)  return 5;
+    if (exp_bits > 239)  return 4;
+    if (exp_bits > 79)   return 3;
+    if (exp_bits > 23)   return 2;
+    return 1;
+}
+
+/**
+ * @brief Montgomery exponentiation - automatic window width
+ */
+int montgomery_exp(bigint_t *result, const bigint_t *base, const bigint_t *exp, const montgomery_ctx_t *ctx) {
+    return montgomery_exp_window(result, base, exp, ctx, MONTGOMERY_WINDOW_AUTO);
+}
+
+/**
+ * @brief Short-exponent Montgomery exponentiation: result = base^e mod n for a one-limb e
+ * 
+ * Public operations (e = 65537 = 2^16 + 1 almost always) need no window
+ * table: plain left-to-right binary on the limbs costs bits(e) - 1
+ * squarings plus one multiply per further set bit, with a single CIOS
+ * into Montgomery form (base * R^2) and one out (acc * 1). For F4 that is
+ * 16 squarings and 3 multiplies in total.
+ */
+int montgomery_exp_short(bigint_t *result, const bigint_t *base, bigint_word_t e, const montgomery_ctx_t *ctx) {
+    if (result == NULL || base == NULL || ctx == NULL) {
+        ERROR_RETURN(-1, "NULL pointer in montgomery_exp_short");
     }
     
-    debug_print_bigint("Final exponentiation result", result);
-    debug_verify_invariant("Final result", result, &ctx->n);
+    if (!ctx->is_active || ctx->n_words == 0) {
+        ERROR_RETURN(-1, "Montgomery context disabled");
+    }
     
-    printf("[MONT_EXP_COMPLETE] ✅ Complete Montgomery exponentiation finished\n");
-    return 0;
-}
\ No newline at end of file
+    if (e == 0) {
+        bigint_set_u32(result, 1);
+        return 0;
+    }
+    
+    bigint_t reduced;
+    if (bigint_compare(base, &ctx->n) >= 0) {
+        int ret = bigint_mod(&reduced, base, &ctx->n);
+        if (ret != 0) {
+            ERROR_RETURN(ret, "Failed to reduce base in montgomery_exp_short");
+        }
+        base = &reduced;
+    }
+    
+    if (bigint_is_zero(base)) {
+        bigint_init(result);
+        return 0;
+    }
+    
+    const int s = ctx->n_words;
+    const bigint_word_t *n = ctx->n.words;
+    const bigint_word_t n_prime = ctx->n_prime;
+    bigint_word_t x[BIGINT_4096_WORDS], acc[BIGINT_4096_WORDS], r2[BIGINT_4096_WORDS];
+    size_t mark;
+    bigint_word_t *work = BIGINT_SCRATCH_LIMBS(MONT_KERNEL_WORK(s), &mark);
+    if (work == NULL) {
+        ERROR_RETURN(-3, "Out of scratch memory in montgomery_exp_short");
+    }
+    
+    RSA_4096_PHASE_BEGIN(to_form_start);
+    mont_load_limbs(acc, base, s);
+    mont_load_limbs(r2, &ctx->r_squared, s);
+    mont_cios_mul(x, acc, r2, n, n_prime, s);
+    memcpy(acc, x, (size_t)s * sizeof(bigint_word_t));
+    RSA_4096_PHASE_END(RSA_4096_PHASE_TO_FORM, to_form_start);
+    
+    RSA_4096_PHASE_BEGIN(loop_start);
+    int top = BIGINT_WORD_SIZE - 1;
+    while (((e >> top) & 1) == 0) {
+        top--;
+    }
+    for (int bit = top - 1; bit >= 0; bit--) {
+        mont_sqr(acc, acc, n, n_prime, s, work);
+        if ((e >> bit) & 1) {
+            mont_mul(acc, acc, x, n, n_prime, s, work);
+        }
+    }
+    RSA_4096_PHASE_END(RSA_4096_PHASE_EXP_LOOP, loop_start);
+    
+    RSA_4096_PHASE_BEGIN(from_form_start);
+    memset(x, 0, (size_t)s * sizeof(bigint_word_t));
+    x[0] = 1;
+    mont_cios_mul(acc, acc, x, n, n_prime, s);
+    mont_store_limbs(result, acc, s);
+    RSA_4096_PHASE_END(RSA_4096_PHASE_FROM_FORM, from_form_start);
+    bigint_scratch_pop(work, mark);
+    return 0;
+}
+
+/* Window list of a recoding, whether it lives in a montgomery_exp_recoding_t or in scratch */
+typedef struct {
+    int window_bits;
+    int top;
+    int count;
+    const uint16_t *pos;
+    const uint8_t *digit;
+} mont_windows_t;
+
+/**
+ * @brief Width a recoding uses: the requested one, or the automatic choice; never wider than the exponent
+ */
+static int mont_exp_width(int exp_bits, int window_bits) {
+    int w = window_bits == MONTGOMERY_WINDOW_AUTO ? montgomery_window_bits_for_exponent(exp_bits) : window_bits;
+    if (w > exp_bits) {
+        w = exp_bits > 0 ? exp_bits : 1;
+    }
+    return w;
+}
+
+/**
+ * @brief Windows of exp at width w into pos / digit, most significant first
+ * @return The window count, or -1 when more than capacity are needed
+ */
+static int mont_exp_windows(uint16_t *pos, uint8_t *digit, int capacity, const bigint_t *exp, int exp_bits, int w) {
+    int count = 0;
+    int i = exp_bits - 1;
+    while (i >= 0) {
+        if (!mont_exp_bit(exp, i)) {
+            i--;
+            continue;
+        }
+        
+        /* Longest window [low, i] of at most w bits that ends in a 1 bit */
+        int low = i - w + 1;
+        if (low < 0) {
+            low = 0;
+        }
+        while (!mont_exp_bit(exp, low)) {
+            low++;
+        }
+        if (count == capacity) {
+            return -1;
+        }
+        pos[count] = (uint16_t)low;
+        digit[count] = (uint8_t)mont_exp_window_bits(exp, low, i - low + 1);
+        count++;
+        i = low - 1;
+    }
+    return count;
+}
+
+/**
+ * @brief Sliding-window recoding of an exponent: exp = sum digit[k] * 2^pos[k]
+ * 
+ * Scans left to right like the exponentiation itself: zero bits are
+ * skipped, and each window of up to w bits starting and ending in a 1 bit
+ * becomes one odd digit at its low bit. Done once per key, the recoding
+ * leaves the exponentiation loop with nothing to decide but "square, and
+ * multiply where the next window ends". Only the windows are stored, so a
+ * 4096-bit exponent takes under 700 entries rather than a byte per bit.
+ * 
+ * The automatic width always fits MONTGOMERY_RECODING_WINDOWS. An explicit
+ * width is kept as given; if this exponent has more windows at that width
+ * than the recoding holds, the call fails with -4 (montgomery_exp_window
+ * takes any width, recoding into the scratch arena).
+ * 
+ * @param window_bits MONTGOMERY_WINDOW_MIN..MONTGOMERY_WINDOW_MAX, or
+ *                    MONTGOMERY_WINDOW_AUTO to choose from the exponent length
+ */
+int montgomery_exp_recode(montgomery_exp_recoding_t *rec, const bigint_t *exp, int window_bits) {
+    if (rec == NULL || exp == NULL) {
+        ERROR_RETURN(-1, "NULL pointer in montgomery_exp_recode");
+    }
+    
+    if (window_bits != MONTGOMERY_WINDOW_AUTO &&
+        (window_bits < MONTGOMERY_WINDOW_MIN || window_bits > MONTGOMERY_WINDOW_MAX)) {
+        ERROR_RETURN(-2, "Invalid window width %d (expected %d-%d)", window_bits,
+                     MONTGOMERY_WINDOW_MIN, MONTGOMERY_WINDOW_MAX);
+    }
+    
+    int exp_bits = bigint_bit_length(exp);
+    if (exp_bits > MONTGOMERY_RECODING_BITS) {
+        ERROR_RETURN(-3, "Exponent of %d bits exceeds the recoding capacity", exp_bits);
+    }
+    
+    const int w = mont_exp_width(exp_bits, window_bits);
+    memset(rec, 0, sizeof(*rec));
+    int count = mont_exp_windows(rec->pos, rec->digit, MONTGOMERY_RECODING_WINDOWS, exp, exp_bits, w);
+    if (count < 0) {
+        rec->top = -1;
+        ERROR_RETURN(-4, "A %d-bit exponent needs more than %d windows at width %d", exp_bits,
+                     MONTGOMERY_RECODING_WINDOWS, w);
+    }
+    rec->window_bits = w;
+    rec->count = count;
+    rec->top = count > 0 ? rec->pos[0] : -1;
+    return 0;
+}
+
+/**
+ * @brief Recoding's windows as the exponentiation loops read them
+ */
+static mont_windows_t mont_exp_view(const montgomery_exp_recoding_t *rec) {
+    mont_windows_t view = { rec->window_bits, rec->top, rec->count, rec->pos, rec->digit };
+    return view;
+}
+
+/**
+ * @brief Fill table[1..entries-1] with base^3, base^5, ... from base (Montgomery form) in table[0]
+ */
+static void mont_exp_odd_powers(bigint_word_t *table, int entries, const bigint_word_t *n, bigint_word_t n_prime,
+                                int s, bigint_word_t *work) {
+    if (entries > 1) {
+        bigint_word_t base_sq[BIGINT_4096_WORDS];
+        mont_sqr(base_sq, table, n, n_prime, s, work);
+        for (int k = 1; k < entries; k++) {
+            mont_mul(table + k * s, table + (k - 1) * s, base_sq, n, n_prime, s, work);
+        }
+    }
+}
+
+/**
+ * @brief Bits from down to to (inclusive): square, then multiply in window k where it ends
+ * @return The next window still to be multiplied in
+ */
+static int mont_exp_digits(bigint_word_t *acc, const bigint_word_t *table, const mont_windows_t *win,
+                           int k, int from, int to, const bigint_word_t *n, bigint_word_t n_prime, int s,
+                           bigint_word_t *work) {
+    for (int i = from; i >= to; i--) {
+        mont_sqr(acc, acc, n, n_prime, s, work);
+        if (k < win->count && win->pos[k] == i) {
+            mont_mul(acc, acc, table + (win->digit[k] >> 1) * s, n, n_prime, s, work);
+            k++;
+        }
+    }
+    return k;
+}
+
+/**
+ * @brief Convert acc back from Montgomery form, CIOS(acc, 1), and store it in result
+ */
+static void mont_exp_leave_form(bigint_t *result, bigint_word_t *acc, const bigint_word_t *n,
+                                bigint_word_t n_prime, int s) {
+    bigint_word_t one[BIGINT_4096_WORDS];
+    memset(one, 0, (size_t)s * sizeof(bigint_word_t));
+    one[0] = 1;
+    mont_cios_mul(acc, acc, one, n, n_prime, s);
+    mont_store_limbs(result, acc, s);
+}
+
+/**
+ * @brief Sliding-window loop over a window list (context and width already checked)
+ */
+static int mont_exp_sliding(bigint_t *result, const bigint_t *base, const mont_windows_t *win,
+                            const montgomery_ctx_t *ctx) {
+    if (win->top < 0) {
+        bigint_set_u32(result, 1);
+        return 0;
+    }
+    
+    if (bigint_is_zero(base)) {
+        bigint_init(result);
+        return 0;
+    }
+    
+    /* Convert base to Montgomery form (reduces base >= n) */
+    bigint_t mont_base;
+    RSA_4096_PHASE_BEGIN(to_form_start);
+    int ret = montgomery_to_form(&mont_base, base, ctx);
+    if (ret != 0) {
+        ERROR_RETURN(ret, "Failed to convert base to Montgomery form");
+    }
+    RSA_4096_PHASE_END(RSA_4096_PHASE_TO_FORM, to_form_start);
+    
+    const int s = ctx->n_words;
+    const bigint_word_t *n = ctx->n.words;
+    const bigint_word_t n_prime = ctx->n_prime;
+    const int w = win->window_bits;
+    
+    CHECKPOINT(LOG_DEBUG, "Montgomery exponentiation: leading digit at bit %d, %d-word modulus, window %d",
+               win->top, s, w);
+    
+    /* Odd-power table: table[k] = base^(2k+1) in Montgomery form, s limbs each */
+    const int entries = 1 << (w - 1);
+    size_t mark;
+    bigint_word_t *table = BIGINT_SCRATCH_LIMBS(entries * s + MONT_KERNEL_WORK(s), &mark);
+    if (table == NULL) {
+        ERROR_RETURN(-3, "Out of scratch memory for the %d-entry window table", entries);
+    }
+    bigint_word_t *work = table + entries * s;
+    bigint_word_t acc[BIGINT_4096_WORDS];
+    
+    RSA_4096_PHASE_BEGIN(loop_start);
+    mont_load_limbs(table, &mont_base, s);
+    mont_exp_odd_powers(table, entries, n, n_prime, s, work);
+    
+    /* The leading digit initializes acc, so no Montgomery form of 1 is needed */
+    memcpy(acc, table + (win->digit[0] >> 1) * s, (size_t)s * sizeof(bigint_word_t));
+    mont_exp_digits(acc, table, win, 1, win->top - 1, 0, n, n_prime, s, work);
+    RSA_4096_PHASE_END(RSA_4096_PHASE_EXP_LOOP, loop_start);
+    
+    RSA_4096_PHASE_BEGIN(from_form_start);
+    mont_exp_leave_form(result, acc, n, n_prime, s);
+    RSA_4096_PHASE_END(RSA_4096_PHASE_FROM_FORM, from_form_start);
+    bigint_scratch_pop(table, mark);
+    
+    debug_verify_invariant("Final result", result, &ctx->n);
+    return 0;
+}
+
+/**
+ * @brief Montgomery exponentiation over a precomputed recoding: result = base^exp mod n
+ * 
+ * Precomputes the odd powers base^1, base^3, ..., base^(2^w - 1) in
+ * Montgomery form; the leading digit initializes the accumulator, then
+ * every lower position costs one squaring plus a table multiply where its
+ * digit is non-zero.
+ */
+int montgomery_exp_recoded(bigint_t *result, const bigint_t *base, const montgomery_exp_recoding_t *rec,
+                           const montgomery_ctx_t *ctx) {
+    if (result == NULL || base == NULL || rec == NULL || ctx == NULL) {
+        ERROR_RETURN(-1, "NULL pointer in montgomery_exp_recoded");
+    }
+    
+    if (!ctx->is_active || ctx->n_words == 0) {
+        ERROR_RETURN(-1, "Montgomery context disabled");
+    }
+    
+    if (rec->window_bits < MONTGOMERY_WINDOW_MIN || rec->window_bits > MONTGOMERY_WINDOW_MAX) {
+        ERROR_RETURN(-2, "Recoding not initialized (window width %d)", rec->window_bits);
+    }
+    
+    const mont_windows_t win = mont_exp_view(rec);
+    return mont_exp_sliding(result, base, &win, ctx);
+}
+
+/**
+ * @brief Sliding-window Montgomery exponentiation: result = base^exp mod n
+ * 
+ * Recodes the exponent for this call into ceil(bits / w) windows of scratch,
+ * so every width is honoured for any exponent length, then runs the same
+ * loop as montgomery_exp_recoded; keys keep their recoding in the
+ * exponentiation plan instead.
+ * 
+ * @param window_bits MONTGOMERY_WINDOW_MIN..MONTGOMERY_WINDOW_MAX, or
+ *                    MONTGOMERY_WINDOW_AUTO to choose from the exponent length
+ */
+int montgomery_exp_window(bigint_t *result, const bigint_t *base, const bigint_t *exp,
+                          const montgomery_ctx_t *ctx, int window_bits) {
+    if (result == NULL || base == NULL || exp == NULL || ctx == NULL) {
+        ERROR_RETURN(-1, "NULL pointer in montgomery_exp");
+    }
+    
+    if (!ctx->is_active || ctx->n_words == 0) {
+        ERROR_RETURN(-1, "Montgomery context disabled");
+    }
+    
+    if (window_bits != MONTGOMERY_WINDOW_AUTO &&
+        (window_bits < MONTGOMERY_WINDOW_MIN || window_bits > MONTGOMERY_WINDOW_MAX)) {
+        ERROR_RETURN(-2, "Invalid window width %d (expected %d-%d)", window_bits,
+                     MONTGOMERY_WINDOW_MIN, MONTGOMERY_WINDOW_MAX);
+    }
+    
+    const int exp_bits = bigint_bit_length(exp);
+    if (exp_bits > MONTGOMERY_RECODING_BITS) {
+        ERROR_RETURN(-3, "Exponent of %d bits exceeds the recoding capacity", exp_bits);
+    }
+    
+    /* Positions (uint16_t) first so they stay aligned, then the digits */
+    const int w = mont_exp_width(exp_bits, window_bits);
+    const int capacity = (exp_bits + w - 1) / w;
+    const size_t bytes = (size_t)capacity * (sizeof(uint16_t) + sizeof(uint8_t));
+    size_t mark;
+    bigint_word_t *buf = BIGINT_SCRATCH_LIMBS((bytes + sizeof(bigint_word_t) - 1) / sizeof(bigint_word_t) + 1, &mark);
+    if (buf == NULL) {
+        ERROR_RETURN(-3, "Out of scratch memory for %d recoding windows", capacity);
+    }
+    uint16_t *pos = (uint16_t *)buf;
+    uint8_t *digit = (uint8_t *)(pos + capacity);
+    
+    const int count = mont_exp_windows(pos, digit, capacity, exp, exp_bits, w);
+    const mont_windows_t win = { w, count > 0 ? pos[0] : -1, count, pos, digit };
+    int ret = mont_exp_sliding(result, base, &win, ctx);
+    bigint_scratch_pop(buf, mark);
+    return ret;
+}
+
+/* ===================== CONSTANT-TIME FIXED-WINDOW EXPONENTIATION ===================== */
+
+/**
+ * @brief All-ones mask when a == b, zero otherwise, without branching
+ */
+static inline bigint_word_t mont_ct_eq_mask(uint32_t a, uint32_t b) {
+    return (bigint_word_t)0 - (bigint_word_t)(((uint64_t)(a ^ b) - 1) >> 63);
+}
+
+/**
+ * @brief Store an s-limb entry into a scattered table of 'entries' columns
+ * 
+ * Limb j of entry k lives at table[j * entries + k], so every cache line
+ * holds the same limb of several entries and each lookup touches all lines.
+ */
+static void mont_ct_scatter(bigint_word_t *table, int entries, int k, const bigint_word_t *src, int s) {
+    for (int j = 0; j < s; j++) {
+        table[j * entries + k] = src[j];
+    }
+}
+
+/**
+ * @brief Read entry 'index' from a scattered table by masking every entry
+ */
+static void mont_ct_gather(bigint_word_t *dst, const bigint_word_t *table, int entries, uint32_t index, int s) {
+    bigint_word_t masks[1 << MONTGOMERY_WINDOW_MAX];
+    for (int k = 0; k < entries; k++) {
+        masks[k] = mont_ct_eq_mask((uint32_t)k, index);
+    }
+    for (int j = 0; j < s; j++) {
+        const bigint_word_t *row = table + j * entries;
+        bigint_word_t v = 0;
+        for (int k = 0; k < entries; k++) {
+            v |= row[k] & masks[k];
+        }
+        dst[j] = v;
+    }
+}
+
+/**
+ * @brief Automatic fixed-window width: a 32-entry table is the sweet spot for 1024-4096 bit exponents
+ */
+static int mont_ct_window_bits(int e_bits) {
+    return e_bits >= 768 ? 5 : (e_bits >= 256 ? 4 : 3);
+}
+
+/**
+ * @brief Bit position of the leading (possibly partial) window
+ */
+static int mont_ct_top_window(int e_bits, int w) {
+    return ((e_bits + w - 1) / w - 1) * w;
+}
+
+/**
+ * @brief The w-bit window at pos of a limb array padded by one zero limb
+ */
+static uint32_t mont_ct_digit(const bigint_word_t *e_limbs, int pos, int w) {
+    int idx = pos / BIGINT_WORD_SIZE;
+    bigint_dword_t chunk = e_limbs[idx] | ((bigint_dword_t)e_limbs[idx + 1] << BIGINT_WORD_SIZE);
+    return (uint32_t)(chunk >> (pos % BIGINT_WORD_SIZE)) & ((1u << w) - 1);
+}
+
+/**
+ * @brief Scattered table of base^0 .. base^(entries - 1) from Montgomery-form one and base
+ */
+static void mont_ct_powers(bigint_word_t *table, int entries, const bigint_word_t *one, const bigint_word_t *base,
+                           const bigint_word_t *n, bigint_word_t n_prime, int s, bigint_word_t *work) {
+    bigint_word_t cur[BIGINT_4096_WORDS];
+    mont_ct_scatter(table, entries, 0, one, s);
+    mont_ct_scatter(table, entries, 1, base, s);
+    memcpy(cur, base, (size_t)s * sizeof(bigint_word_t));
+    for (int k = 2; k < entries; k++) {
+        mont_mul(cur, cur, base, n, n_prime, s, work);
+        mont_ct_scatter(table, entries, k, cur, s);
+    }
+}
+
+/**
+ * @brief Windows at from, from - w, ... down to to: w squarings, then a masked gather and multiply
+ */
+static void mont_ct_windows(bigint_word_t *acc, const bigint_word_t *table, int entries, const bigint_word_t *e_limbs,
+                            int w, int from, int to, const bigint_word_t *n, bigint_word_t n_prime, int s,
+                            bigint_word_t *work) {
+    bigint_word_t cur[BIGINT_4096_WORDS];
+    for (int pos = from; pos >= to; pos -= w) {
+        for (int sq = 0; sq < w; sq++) {
+            mont_sqr(acc, acc, n, n_prime, s, work);
+        }
+        mont_ct_gather(cur, table, entries, mont_ct_digit(e_limbs, pos, w), s);
+        mont_mul(acc, acc, cur, n, n_prime, s, work);
+    }
+}
+
+/**
+ * @brief Constant-time Montgomery exponentiation: result = base^exp mod n
+ * 
+ * Fixed-window method over a public exponent length (the larger of the
+ * modulus and exponent limb counts), so the sequence of squarings and
+ * multiplications does not depend on exponent bits. All 2^w powers
+ * base^0..base^(2^w - 1) are stored in a scattered table and read with
+ * mont_ct_gather; zero windows still perform their multiply by base^0.
+ * The CIOS and squaring kernels themselves are branch-free in the data.
+ * 
+ * @param window_bits MONTGOMERY_WINDOW_MIN..MONTGOMERY_WINDOW_MAX, or AUTO
+ */
+int montgomery_exp_consttime(bigint_t *result, const bigint_t *base, const bigint_t *exp,
+                             const montgomery_ctx_t *ctx, int window_bits) {
+    if (result == NULL || base == NULL || exp == NULL || ctx == NULL) {
+        ERROR_RETURN(-1, "NULL pointer in montgomery_exp_consttime");
+    }
+    
+    if (!ctx->is_active || ctx->n_words == 0) {
+        ERROR_RETURN(-1, "Montgomery context disabled");
+    }
+    
+    if (window_bits != MONTGOMERY_WINDOW_AUTO &&
+        (window_bits < MONTGOMERY_WINDOW_MIN || window_bits > MONTGOMERY_WINDOW_MAX)) {
+        ERROR_RETURN(-2, "Invalid window width %d (expected %d-%d)", window_bits,
+                     MONTGOMERY_WINDOW_MIN, MONTGOMERY_WINDOW_MAX);
+    }
+    
+    const int s = ctx->n_words;
+    const bigint_word_t *n = ctx->n.words;
+    const bigint_word_t n_prime = ctx->n_prime;
+    
+    /* Public exponent length: never shorter than the modulus */
+    int e_words = exp->used > s ? exp->used : s;
+    if (e_words > BIGINT_4096_WORDS) {
+        ERROR_RETURN(-3, "Exponent too large: %d words", exp->used);
+    }
+    bigint_word_t e_limbs[BIGINT_4096_WORDS + 1];
+    memset(e_limbs, 0, sizeof(e_limbs));
+    memcpy(e_limbs, exp->words, (size_t)exp->used * sizeof(bigint_word_t));
+    const int e_bits = e_words * BIGINT_WORD_SIZE;
+    
+    int w = window_bits == MONTGOMERY_WINDOW_AUTO ? mont_ct_window_bits(e_bits) : window_bits;
+    
+    CHECKPOINT(LOG_DEBUG, "Constant-time Montgomery exponentiation: %d exponent bits, %d-word modulus, window %d",
+               e_bits, s, w);
+    
+    /* Montgomery forms of 1 and base */
+    bigint_t one_plain, mont_one, mont_base;
+    bigint_set_u32(&one_plain, 1);
+    RSA_4096_PHASE_BEGIN(to_form_start);
+    int ret = montgomery_to_form(&mont_one, &one_plain, ctx);
+    if (ret != 0) {
+        ERROR_RETURN(ret, "Failed to convert 1 to Montgomery form");
+    }
+    ret = montgomery_to_form(&mont_base, base, ctx);
+    if (ret != 0) {
+        ERROR_RETURN(ret, "Failed to convert base to Montgomery form");
+    }
+    RSA_4096_PHASE_END(RSA_4096_PHASE_TO_FORM, to_form_start);
+    
+    /* Scattered table of base^0 .. base^(2^w - 1) */
+    const int entries = 1 << w;
+    size_t mark;
+    bigint_word_t *table = BIGINT_SCRATCH_LIMBS(entries * s + MONT_KERNEL_WORK(s), &mark);
+    if (table == NULL) {
+        ERROR_RETURN(-4, "Out of scratch memory for the %d-entry window table", entries);
+    }
+    bigint_word_t *work = table + entries * s;
+    bigint_word_t base_limbs[BIGINT_4096_WORDS], cur[BIGINT_4096_WORDS], acc[BIGINT_4096_WORDS];
+    
+    RSA_4096_PHASE_BEGIN(loop_start);
+    mont_load_limbs(cur, &mont_one, s);
+    mont_load_limbs(base_limbs, &mont_base, s);
+    mont_ct_powers(table, entries, cur, base_limbs, n, n_prime, s, work);
+    
+    /* Top window may be partial; every later window is exactly w bits */
+    int pos = mont_ct_top_window(e_bits, w);
+    mont_ct_gather(acc, table, entries, mont_ct_digit(e_limbs, pos, w), s);
+    mont_ct_windows(acc, table, entries, e_limbs, w, pos - w, 0, n, n_prime, s, work);
+    RSA_4096_PHASE_END(RSA_4096_PHASE_EXP_LOOP, loop_start);
+    
+    RSA_4096_PHASE_BEGIN(from_form_start);
+    mont_exp_leave_form(result, acc, n, n_prime, s);
+    RSA_4096_PHASE_END(RSA_4096_PHASE_FROM_FORM, from_form_start);
+    bigint_scratch_pop(table, mark);
+    return 0;
+}
+
+/* ===================== RESUMABLE EXPONENTIATION ===================== */
+
+/*
+ * The same loops as montgomery_exp_recoded and montgomery_exp_consttime,
+ * cut at digit (or window) boundaries. Init converts the base and builds
+ * the table; each step runs a bounded number of squarings with a kernel
+ * workspace borrowed from the calling thread's scratch arena for that step
+ * only; finish leaves Montgomery form. The step boundaries fall on fixed
+ * exponent positions, so constant-time mode keeps its operation sequence.
+ */
+
+static int mont_exp_job_check(montgomery_exp_job_t *job, const bigint_t *base, const montgomery_ctx_t *ctx,
+                              const char *func) {
+    if (job == NULL || base == NULL || ctx == NULL) {
+        ERROR_RETURN(-1, "NULL pointer in %s", func);
+    }
+    if (!ctx->is_active || ctx->n_words == 0) {
+        ERROR_RETURN(-1, "Montgomery context disabled");
+    }
+    job->ctx = ctx;
+    job->rec = NULL;
+    job->trivial = -1;
+    job->pos = -1;
+    return 0;
+}
+
+/**
+ * @brief Start base^exp mod n over a sliding-window recoding
+ * 
+ * Builds the 2^(w-1)-entry odd-power table, the same work
+ * montgomery_exp_recoded does before its loop.
+ */
+int montgomery_exp_job_init(montgomery_exp_job_t *job, const bigint_t *base, const montgomery_exp_recoding_t *rec,
+                            const montgomery_ctx_t *ctx) {
+    int ret = mont_exp_job_check(job, base, ctx, "montgomery_exp_job_init");
+    if (ret != 0) {
+        return ret;
+    }
+    if (rec == NULL) {
+        ERROR_RETURN(-1, "NULL pointer in montgomery_exp_job_init");
+    }
+    if (rec->window_bits < MONTGOMERY_WINDOW_MIN || rec->window_bits > MONTGOMERY_WINDOW_MAX) {
+        ERROR_RETURN(-2, "Recoding not initialized (window width %d)", rec->window_bits);
+    }
+    
+    if (rec->top < 0 || bigint_is_zero(base)) {
+        job->trivial = rec->top < 0 ? 1 : 0;
+        return 0;
+    }
+    
+    bigint_t mont_base;
+    ret = montgomery_to_form(&mont_base, base, ctx);
+    if (ret != 0) {
+        ERROR_RETURN(ret, "Failed to convert base to Montgomery form");
+    }
+    
+    const int s = ctx->n_words;
+    size_t mark;
+    bigint_word_t *work = BIGINT_SCRATCH_LIMBS(MONT_KERNEL_WORK(s), &mark);
+    if (work == NULL) {
+        ERROR_RETURN(-3, "Out of scratch memory in montgomery_exp_job_init");
+    }
+    
+    job->rec = rec;
+    job->window_bits = rec->window_bits;
+    job->entries = 1 << (rec->window_bits - 1);
+    mont_load_limbs(job->table, &mont_base, s);
+    mont_exp_odd_powers(job->table, job->entries, ctx->n.words, ctx->n_prime, s, work);
+    memcpy(job->acc, job->table + (rec->digit[0] >> 1) * s, (size_t)s * sizeof(bigint_word_t));
+    job->window = 1;
+    job->pos = rec->top - 1;
+    bigint_scratch_pop(work, mark);
+    return 0;
+}
+
+/**
+ * @brief Start base^exp mod n with the constant-time fixed-window method (automatic width)
+ * 
+ * The exponent is copied at its public length, so it need not outlive the job.
+ */
+int montgomery_exp_job_init_consttime(montgomery_exp_job_t *job, const bigint_t *base, const bigint_t *exp,
+                                      const montgomery_ctx_t *ctx) {
+    int ret = mont_exp_job_check(job, base, ctx, "montgomery_exp_job_init_consttime");
+    if (ret != 0) {
+        return ret;
+    }
+    if (exp == NULL) {
+        ERROR_RETURN(-1, "NULL pointer in montgomery_exp_job_init_consttime");
+    }
+    
+    const int s = ctx->n_words;
+    int e_words = exp->used > s ? exp->used : s;
+    if (e_words > BIGINT_4096_WORDS) {
+        ERROR_RETURN(-3, "Exponent too large: %d words", exp->used);
+    }
+    memset(job->exp, 0, sizeof(job->exp));
+    memcpy(job->exp, exp->words, (size_t)exp->used * sizeof(bigint_word_t));
+    const int e_bits = e_words * BIGINT_WORD_SIZE;
+    const int w = mont_ct_window_bits(e_bits);
+    
+    bigint_t one_plain, mont_one, mont_base;
+    bigint_set_u32(&one_plain, 1);
+    ret = montgomery_to_form(&mont_one, &one_plain, ctx);
+    if (ret == 0) {
+        ret = montgomery_to_form(&mont_base, base, ctx);
+    }
+    if (ret != 0) {
+        ERROR_RETURN(ret, "Failed to convert operands to Montgomery form");
+    }
+    
+    size_t mark;
+    bigint_word_t *work = BIGINT_SCRATCH_LIMBS(MONT_KERNEL_WORK(s), &mark);
+    if (work == NULL) {
+        ERROR_RETURN(-4, "Out of scratch memory in montgomery_exp_job_init_consttime");
+    }
+    
+    bigint_word_t one_limbs[BIGINT_4096_WORDS], base_limbs[BIGINT_4096_WORDS];
+    job->window_bits = w;
+    job->entries = 1 << w;
+    mont_load_limbs(one_limbs, &mont_one, s);
+    mont_load_limbs(base_limbs, &mont_base, s);
+    mont_ct_powers(job->table, job->entries, one_limbs, base_limbs, ctx->n.words, ctx->n_prime, s, work);
+    
+    int top = mont_ct_top_window(e_bits, w);
+    mont_ct_gather(job->acc, job->table, job->entries, mont_ct_digit(job->exp, top, w), s);
+    job->pos = top - w;
+    bigint_scratch_pop(work, mark);
+    return 0;
+}
+
+/**
+ * @brief Advance by at least one and about max_bits exponent bits (squarings)
+ * 
+ * Constant-time jobs advance whole windows, so a step covers max_bits
+ * rounded up to a multiple of the window width.
+ * 
+ * @return 1 when the loop has finished, 0 when more steps are needed, negative on error
+ */
+int montgomery_exp_job_step(montgomery_exp_job_t *job, int max_bits) {
+    if (job == NULL || job->ctx == NULL) {
+        ERROR_RETURN(-1, "NULL pointer in montgomery_exp_job_step");
+    }
+    if (job->pos < 0) {
+        return 1;
+    }
+    if (max_bits < 1) {
+        max_bits = 1;
+    }
+    
+    const montgomery_ctx_t *ctx = job->ctx;
+    const int s = ctx->n_words;
+    size_t mark;
+    bigint_word_t *work = BIGINT_SCRATCH_LIMBS(MONT_KERNEL_WORK(s), &mark);
+    if (work == NULL) {
+        ERROR_RETURN(-3, "Out of scratch memory in montgomery_exp_job_step");
+    }
+    
+    int to = job->pos - max_bits + 1;
+    if (job->rec != NULL) {
+        to = to > 0 ? to : 0;
+        const mont_windows_t win = mont_exp_view(job->rec);
+        job->window = mont_exp_digits(job->acc, job->table, &win, job->window, job->pos, to,
+                                      ctx->n.words, ctx->n_prime, s, work);
+        job->pos = to - 1;
+    } else {
+        /* Window positions are multiples of w: cover at least one */
+        const int w = job->window_bits;
+        to = to > 0 ? (to + w - 1) / w * w : 0;
+        mont_ct_windows(job->acc, job->table, job->entries, job->exp, w, job->pos, to,
+                        ctx->n.words, ctx->n_prime, s, work);
+        job->pos = to - w;
+    }
+    bigint_scratch_pop(work, mark);
+    return job->pos < 0 ? 1 : 0;
+}
+
+/**
+ * @brief Result of a finished job; -2 while steps remain
+ */
+int montgomery_exp_job_finish(montgomery_exp_job_t *job, bigint_t *result) {
+    if (job == NULL || job->ctx == NULL || result == NULL) {
+        ERROR_RETURN(-1, "NULL pointer in montgomery_exp_job_finish");
+    }
+    if (job->trivial >= 0) {
+        bigint_set_u32(result, (uint32_t)job->trivial);
+        return 0;
+    }
+    if (job->pos >= 0) {
+        ERROR_RETURN(-2, "Exponentiation unfinished at bit %d", job->pos);
+    }
+    
+    const montgomery_ctx_t *ctx = job->ctx;
+    mont_exp_leave_form(result, job->acc, ctx->n.words, ctx->n_prime, ctx->n_words);
+    return 0;
+}
+
+/* ===================== FIXED-BASE COMB EXPONENTIATION ===================== */
+
+/**
+ * @brief Resolve the comb shape: row and column widths for an exponent size
+ * 
+ * Blocks that would start past the end of a row are dropped, so every
+ * stored block covers at least one exponent column.
+ */
+static int mont_comb_shape(int max_exp_bits, int *teeth, int *blocks, int *row_bits, int *block_bits) {
+    if (*teeth == MONTGOMERY_COMB_AUTO) *teeth = MONTGOMERY_COMB_DEFAULT_TEETH;
+    if (*blocks == MONTGOMERY_COMB_AUTO) *blocks = MONTGOMERY_COMB_DEFAULT_BLOCKS;
+    
+    if (max_exp_bits < 1 || max_exp_bits > MONTGOMERY_RECODING_BITS ||
+        *teeth < 1 || *teeth > MONTGOMERY_COMB_TEETH_MAX || *blocks < 1 || *blocks > MONTGOMERY_COMB_BLOCKS_MAX) {
+        return -2;
+    }
+    
+    *row_bits = (max_exp_bits + *teeth - 1) / *teeth;
+    *block_bits = (*row_bits + *blocks - 1) / *blocks;
+    *blocks = (*row_bits + *block_bits - 1) / *block_bits;
+    return 0;
+}
+
+/**
+ * @brief Heap bytes a comb of this shape needs for ctx's modulus, 0 if the shape is invalid
+ */
+size_t montgomery_comb_table_size(int max_exp_bits, int teeth, int blocks, const montgomery_ctx_t *ctx) {
+    int row_bits, block_bits;
+    if (ctx == NULL || ctx->n_words == 0 ||
+        mont_comb_shape(max_exp_bits, &teeth, &blocks, &row_bits, &block_bits) != 0) {
+        return 0;
+    }
+    return (size_t)blocks * (size_t)((1 << teeth) - 1) * (size_t)ctx->n_words * sizeof(bigint_word_t);
+}
+
+/**
+ * @brief Precompute the Lim-Lee comb table for base modulo ctx's modulus
+ * 
+ * One squaring chain of teeth * row_bits steps visits every power
+ * base^(2^(i*row_bits + j*block_bits)); each block is then filled with
+ * one multiply per entry. Memory is set by teeth (2^teeth - 1 entries per
+ * block) and blocks (each one divides the squarings per exponentiation);
+ * montgomery_comb_table_size reports it up front. Release with
+ * montgomery_comb_free.
+ */
+int montgomery_comb_init(montgomery_comb_t *comb, const bigint_t *base, int max_exp_bits,
+                         int teeth, int blocks, const montgomery_ctx_t *ctx) {
+    if (comb == NULL || base == NULL || ctx == NULL) {
+        ERROR_RETURN(-1, "NULL pointer in montgomery_comb_init");
+    }
+    memset(comb, 0, sizeof(*comb));
+    
+    if (!ctx->is_active || ctx->n_words == 0) {
+        ERROR_RETURN(-1, "Montgomery context disabled");
+    }
+    
+    int row_bits, block_bits;
+    if (mont_comb_shape(max_exp_bits, &teeth, &blocks, &row_bits, &block_bits) != 0) {
+        ERROR_RETURN(-2, "Invalid comb shape: %d-bit exponents, %d teeth, %d blocks (limits %d, %d)",
+                     max_exp_bits, teeth, blocks, MONTGOMERY_COMB_TEETH_MAX, MONTGOMERY_COMB_BLOCKS_MAX);
+    }
+    
+    const int s = ctx->n_words;
+    const bigint_word_t *n = ctx->n.words;
+    const bigint_word_t n_prime = ctx->n_prime;
+    const int entries = (1 << teeth) - 1;
+    
+    bigint_word_t *table = (bigint_word_t *)malloc((size_t)blocks * (size_t)entries * (size_t)s * sizeof(bigint_word_t));
+    if (table == NULL) {
+        ERROR_RETURN(-3, "Failed to allocate comb table (%d blocks of %d entries)", blocks, entries);
+    }
+    
+    bigint_t mont_base;
+    int ret = montgomery_to_form(&mont_base, base, ctx);
+    if (ret != 0) {
+        free(table);
+        ERROR_RETURN(ret, "Failed to convert base to Montgomery form");
+    }
+    
+    size_t mark;
+    bigint_word_t *work = BIGINT_SCRATCH_LIMBS(MONT_KERNEL_WORK(s), &mark);
+    if (work == NULL) {
+        free(table);
+        ERROR_RETURN(-3, "Out of scratch memory in montgomery_comb_init");
+    }
+    
+    /* Single-tooth entries: (j, 2^i) = base^(2^(i*row_bits + j*block_bits)) */
+    bigint_word_t cur[BIGINT_4096_WORDS];
+    mont_load_limbs(cur, &mont_base, s);
+    for (int i = 0; i < teeth; i++) {
+        for (int col = 0; col < row_bits; col++) {
+            if (col % block_bits == 0) {
+                int j = col / block_bits;
+                memcpy(table + ((size_t)j * entries + (1u << i) - 1) * s, cur, (size_t)s * sizeof(bigint_word_t));
+            }
+            if (i < teeth - 1 || col < row_bits - 1) {
+                mont_sqr(cur, cur, n, n_prime, s, work);
+            }
+        }
+    }
+    
+    /* Entry u = (u without its lowest tooth) * (lowest tooth) */
+    for (int j = 0; j < blocks; j++) {
+        bigint_word_t *block = table + (size_t)j * entries * s;
+        for (int u = 3; u <= entries; u++) {
+            int low = u & -u;
+            if (low != u) {
+                mont_mul(block + (size_t)(u - 1) * s, block + (size_t)(u - low - 1) * s,
+                         block + (size_t)(low - 1) * s, n, n_prime, s, work);
+            }
+        }
+    }
+    
+    bigint_scratch_pop(work, mark);
+    
+    comb->teeth = teeth;
+    comb->blocks = blocks;
+    comb->max_exp_bits = max_exp_bits;
+    comb->row_bits = row_bits;
+    comb->block_bits = block_bits;
+    comb->n_words = s;
+    bigint_copy(&comb->n, &ctx->n);
+    comb->table = table;
+    
+    CHECKPOINT(LOG_INFO, "Comb table built: %d-bit exponents, %d teeth x %d blocks, %d squarings per exponentiation",
+               max_exp_bits, teeth, blocks, block_bits);
+    return 0;
+}
+
+void montgomery_comb_free(montgomery_comb_t *comb) {
+    if (comb != NULL) {
+        if (comb->table != NULL) {
+            /* Powers of the base: clear before release */
+            memset(comb->table, 0, (size_t)comb->blocks * (size_t)((1 << comb->teeth) - 1) *
+                                   (size_t)comb->n_words * sizeof(bigint_word_t));
+            free(comb->table);
+        }
+        memset(comb, 0, sizeof(*comb));
+    }
+}
+
+/**
+ * @brief result = base^exp mod n from a comb table built for ctx's modulus
+ * 
+ * Each of the block_bits steps squares once and multiplies by at most one
+ * entry per block, selected by the exponent bits one row_bits apart.
+ * Like montgomery_exp, the running time depends on the exponent.
+ */
+int montgomery_exp_comb(bigint_t *result, const montgomery_comb_t *comb, const bigint_t *exp,
+                        const montgomery_ctx_t *ctx) {
+    if (result == NULL || comb == NULL || exp == NULL || ctx == NULL) {
+        ERROR_RETURN(-1, "NULL pointer in montgomery_exp_comb");
+    }
+    
+    if (!ctx->is_active || ctx->n_words == 0) {
+        ERROR_RETURN(-1, "Montgomery context disabled");
+    }
+    
+    if (comb->table == NULL || comb->n_words != ctx->n_words || bigint_compare(&comb->n, &ctx->n) != 0) {
+        ERROR_RETURN(-2, "Comb table not built for this modulus");
+    }
+    
+    const int e_bits = bigint_bit_length(exp);
+    if (e_bits > comb->max_exp_bits) {
+        ERROR_RETURN(-3, "Exponent of %d bits exceeds the comb's %d", e_bits, comb->max_exp_bits);
+    }
+    
+    const int s = ctx->n_words;
+    const bigint_word_t *n = ctx->n.words;
+    const bigint_word_t n_prime = ctx->n_prime;
+    const int entries = (1 << comb->teeth) - 1;
+    const int a = comb->row_bits, b = comb->block_bits;
+    
+    size_t mark;
+    bigint_word_t *work = BIGINT_SCRATCH_LIMBS(MONT_KERNEL_WORK(s), &mark);
+    if (work == NULL) {
+        ERROR_RETURN(-4, "Out of scratch memory in montgomery_exp_comb");
+    }
+    bigint_word_t acc[BIGINT_4096_WORDS];
+    int started = 0;
+    
+    RSA_4096_PHASE_BEGIN(loop_start);
+    for (int t = b - 1; t >= 0; t--) {
+        if (started) {
+            mont_sqr(acc, acc, n, n_prime, s, work);
+        }
+        for (int j = comb->blocks - 1; j >= 0; j--) {
+            int col = j * b + t;
+            if (col >= a) {
+                continue;
+            }
+            uint32_t u = 0;
+            for (int i = comb->teeth - 1; i >= 0; i--) {
+                int pos = i * a + col;
+                u = (u << 1) | (uint32_t)(pos < e_bits && mont_exp_bit(exp, pos));
+            }
+            if (u == 0) {
+                continue;
+            }
+            const bigint_word_t *entry = comb->table + ((size_t)j * entries + u - 1) * s;
+            if (started) {
+                mont_mul(acc, acc, entry, n, n_prime, s, work);
+            } else {
+                /* The first entry initializes acc, so no Montgomery form of 1 is needed */
+                memcpy(acc, entry, (size_t)s * sizeof(bigint_word_t));
+                started = 1;
+            }
+        }
+    }
+    
+    RSA_4096_PHASE_END(RSA_4096_PHASE_EXP_LOOP, loop_start);
+    bigint_scratch_pop(work, mark);
+    if (!started) {
+        bigint_set_u32(result, 1);
+        return 0;
+    }
+    
+    /* Convert result back from Montgomery form: CIOS(acc, 1) */
+    RSA_4096_PHASE_BEGIN(from_form_start);
+    bigint_word_t one[BIGINT_4096_WORDS];
+    memset(one, 0, (size_t)s * sizeof(bigint_word_t));
+    one[0] = 1;
+    mont_cios_mul(acc, acc, one, n, n_prime, s);
+    
+    mont_store_limbs(result, acc, s);
+    RSA_4096_PHASE_END(RSA_4096_PHASE_FROM_FORM, from_form_start);
+    
+    debug_verify_invariant("Final result", result, &ctx->n);
+    return 0;
+}
@@ -0,0 +1,736 @@
+/**
+ * @file rsa_4096_pool.c
+ * @brief Work-Stealing Worker Pool for RSA-4096 Batch Operations
+ *
+ * Each worker owns a deque of jobs, each a run of consecutive batch items
+ * sized to fill the multi-buffer lanes. Submission deals the jobs
+ * round-robin across the deques; a worker pops from the back of
+ * its own deque and, when that is empty, steals from the front of the
+ * others, so a slow item never leaves the remaining cores idle.
+ *
+ * rsa_4096_async_submit layers a completion queue on the same jobs: an
+ * event loop waits on the queue's descriptor instead of a future.
+ *
+ * Concurrency contract with the rest of the library:
+ * - Keys and Montgomery contexts are only read during encrypt/decrypt, so
+ *   one rsa_4096_key_t may be shared by all workers. Do not load, free or
+ *   change the constant-time mode of a key while jobs on it are queued.
+ * - Arithmetic temporaries live on the calling thread's stack and in its
+ *   own scratch arena; the workers are started with RSA_4096_POOL_STACK_SIZE
+ *   bytes of stack.
+ * - The only mutable globals are the log level and sink and the
+ *   instrumentation phase hook. The stdout sink is safe from any thread; a
+ *   custom sink or hook must be thread-safe itself.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <time.h>
+#include "rsa_4096.h"
+
+/* ===================== POOL DATA STRUCTURES ===================== */
+
+typedef struct {
+    rsa_4096_op_t op;
+    const rsa_4096_key_t *key;
+    rsa_4096_batch_item_t *item;
+    size_t count;                 /* Consecutive items run as one batch (1 for a task) */
+    rsa_4096_job_callback_t callback;
+    void *user;
+    rsa_4096_task_fn_t task;      /* Set for rsa_4096_pool_run jobs instead of key/item */
+    void *task_arg;
+    rsa_4096_future_t *future;
+} rsa_4096_pool_job_t;
+
+/**
+ * @brief Ring-buffer deque: the owner works at the back, thieves at the front
+ */
+typedef struct {
+    pthread_mutex_t lock;
+    rsa_4096_pool_job_t *jobs;
+    size_t head;                  /* Index of the oldest job */
+    size_t count;
+    size_t capacity;
+} rsa_4096_pool_deque_t;
+
+typedef struct {
+    rsa_4096_pool_t *pool;
+    int index;
+    pthread_t thread;
+    rsa_4096_pool_deque_t deque;
+} rsa_4096_pool_worker_t;
+
+struct rsa_4096_pool {
+    rsa_4096_pool_worker_t *workers;
+    int num_workers;
+    unsigned int next_worker;     /* Round-robin start for the next submission */
+    long pending;                 /* Jobs sitting in deques (atomic) */
+    int stopping;
+    pthread_mutex_t lock;         /* Guards sleeping, stopping and completion signalling */
+    pthread_cond_t work_cond;
+    pthread_cond_t done_cond;
+};
+
+/* Pool served by the current thread, NULL outside worker threads */
+static __thread rsa_4096_pool_t *pool_current = NULL;
+
+/* ===================== DEQUE OPERATIONS ===================== */
+
+static int pool_deque_init(rsa_4096_pool_deque_t *dq) {
+    memset(dq, 0, sizeof(*dq));
+    dq->capacity = RSA_4096_POOL_DEQUE_INITIAL;
+    dq->jobs = (rsa_4096_pool_job_t *)malloc(dq->capacity * sizeof(rsa_4096_pool_job_t));
+    if (dq->jobs == NULL) {
+        return -1;
+    }
+    if (pthread_mutex_init(&dq->lock, NULL) != 0) {
+        free(dq->jobs);
+        dq->jobs = NULL;
+        return -1;
+    }
+    return 0;
+}
+
+static void pool_deque_free(rsa_4096_pool_deque_t *dq) {
+    if (dq->jobs != NULL) {
+        pthread_mutex_destroy(&dq->lock);
+        free(dq->jobs);
+        dq->jobs = NULL;
+    }
+}
+
+/**
+ * @brief Append a job at the back, doubling the ring when full (caller holds the lock)
+ */
+static int pool_deque_push_locked(rsa_4096_pool_deque_t *dq, const rsa_4096_pool_job_t *job) {
+    if (dq->count == dq->capacity) {
+        size_t new_capacity = dq->capacity * 2;
+        rsa_4096_pool_job_t *jobs = (rsa_4096_pool_job_t *)malloc(new_capacity * sizeof(rsa_4096_pool_job_t));
+        if (jobs == NULL) {
+            return -1;
+        }
+        for (size_t i = 0; i < dq->count; i++) {
+            jobs[i] = dq->jobs[(dq->head + i) % dq->capacity];
+        }
+        free(dq->jobs);
+        dq->jobs = jobs;
+        dq->head = 0;
+        dq->capacity = new_capacity;
+    }
+    dq->jobs[(dq->head + dq->count) % dq->capacity] = *job;
+    dq->count++;
+    return 0;
+}
+
+static int pool_deque_pop_back(rsa_4096_pool_deque_t *dq, rsa_4096_pool_job_t *job) {
+    int found = 0;
+    pthread_mutex_lock(&dq->lock);
+    if (dq->count > 0) {
+        dq->count--;
+        *job = dq->jobs[(dq->head + dq->count) % dq->capacity];
+        found = 1;
+    }
+    pthread_mutex_unlock(&dq->lock);
+    return found;
+}
+
+static int pool_deque_steal_front(rsa_4096_pool_deque_t *dq, rsa_4096_pool_job_t *job) {
+    int found = 0;
+    if (pthread_mutex_trylock(&dq->lock) != 0) {
+        return 0;   /* Contended: try the next victim instead of queueing behind it */
+    }
+    if (dq->count > 0) {
+        *job = dq->jobs[dq->head];
+        dq->head = (dq->head + 1) % dq->capacity;
+        dq->count--;
+        found = 1;
+    }
+    pthread_mutex_unlock(&dq->lock);
+    return found;
+}
+
+/* ===================== WORKER THREADS ===================== */
+
+/**
+ * @brief Own deque first, then one sweep over the other workers
+ */
+static int pool_take_job(rsa_4096_pool_worker_t *self, rsa_4096_pool_job_t *job) {
+    rsa_4096_pool_t *pool = self->pool;
+    if (pool_deque_pop_back(&self->deque, job)) {
+        return 1;
+    }
+    for (int k = 1; k < pool->num_workers; k++) {
+        rsa_4096_pool_worker_t *victim = &pool->workers[(self->index + k) % pool->num_workers];
+        if (pool_deque_steal_front(&victim->deque, job)) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static void pool_run_job(rsa_4096_pool_t *pool, const rsa_4096_pool_job_t *job) {
+    int status = 0;
+    if (job->task != NULL) {
+        job->task(job->task_arg);
+    } else {
+        if (job->op == RSA_4096_OP_DECRYPT) {
+            rsa_4096_decrypt_batch(job->key, job->item, job->count);
+        } else {
+            rsa_4096_encrypt_batch(job->key, job->item, job->count);
+        }
+        for (size_t i = 0; i < job->count; i++) {
+            if (job->item[i].status != 0) {
+                status++;
+            }
+            if (job->callback != NULL) {
+                job->callback(job->user, &job->item[i]);
+            }
+        }
+    }
+
+    rsa_4096_future_t *future = job->future;
+    if (future != NULL) {
+        if (status != 0) {
+            __atomic_add_fetch(&future->failed, (size_t)status, __ATOMIC_RELAXED);
+        }
+        /* The waiter may release the future as soon as remaining hits zero: do not touch it after */
+        if (__atomic_sub_fetch(&future->remaining, job->count, __ATOMIC_ACQ_REL) == 0) {
+            pthread_mutex_lock(&pool->lock);
+            pthread_cond_broadcast(&pool->done_cond);
+            pthread_mutex_unlock(&pool->lock);
+        }
+    }
+}
+
+static void *pool_worker_main(void *arg) {
+    rsa_4096_pool_worker_t *self = (rsa_4096_pool_worker_t *)arg;
+    rsa_4096_pool_t *pool = self->pool;
+    rsa_4096_pool_job_t job;
+
+    pool_current = pool;
+    for (;;) {
+        if (pool_take_job(self, &job)) {
+            __atomic_sub_fetch(&pool->pending, 1, __ATOMIC_ACQ_REL);
+            pool_run_job(pool, &job);
+            continue;
+        }
+
+        pthread_mutex_lock(&pool->lock);
+        while (__atomic_load_n(&pool->pending, __ATOMIC_ACQUIRE) <= 0 && !pool->stopping) {
+            pthread_cond_wait(&pool->work_cond, &pool->lock);
+        }
+        int done = pool->stopping && __atomic_load_n(&pool->pending, __ATOMIC_ACQUIRE) <= 0;
+        pthread_mutex_unlock(&pool->lock);
+        if (done) {
+            break;
+        }
+    }
+    return NULL;
+}
+
+/* ===================== POOL LIFECYCLE ===================== */
+
+static void pool_stop_and_join(rsa_4096_pool_t *pool, int started) {
+    pthread_mutex_lock(&pool->lock);
+    pool->stopping = 1;
+    pthread_cond_broadcast(&pool->work_cond);
+    pthread_mutex_unlock(&pool->lock);
+
+    for (int i = 0; i < started; i++) {
+        pthread_join(pool->workers[i].thread, NULL);
+    }
+}
+
+static void pool_release(rsa_4096_pool_t *pool) {
+    for (int i = 0; i < pool->num_workers; i++) {
+        pool_deque_free(&pool->workers[i].deque);
+    }
+    pthread_cond_destroy(&pool->done_cond);
+    pthread_cond_destroy(&pool->work_cond);
+    pthread_mutex_destroy(&pool->lock);
+    free(pool->workers);
+    free(pool);
+}
+
+/**
+ * @brief Start a pool of num_threads workers (<= 0: one per online CPU)
+ */
+int rsa_4096_pool_create(rsa_4096_pool_t **out_pool, int num_threads) {
+    if (out_pool == NULL) {
+        ERROR_RETURN(-1, "NULL pointer in rsa_4096_pool_create");
+    }
+    *out_pool = NULL;
+
+    if (num_threads <= 0) {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        num_threads = cpus > 0 ? (int)cpus : 1;
+    }
+    if (num_threads > RSA_4096_POOL_MAX_THREADS) {
+        num_threads = RSA_4096_POOL_MAX_THREADS;
+    }
+
+    rsa_4096_pool_t *pool = (rsa_4096_pool_t *)calloc(1, sizeof(rsa_4096_pool_t));
+    if (pool == NULL) {
+        ERROR_RETURN(-2, "Out of memory for worker pool");
+    }
+    pool->workers = (rsa_4096_pool_worker_t *)calloc((size_t)num_threads, sizeof(rsa_4096_pool_worker_t));
+    if (pool->workers == NULL) {
+        free(pool);
+        ERROR_RETURN(-2, "Out of memory for %d workers", num_threads);
+    }
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->work_cond, NULL);
+    pthread_cond_init(&pool->done_cond, NULL);
+
+    for (int i = 0; i < num_threads; i++) {
+        pool->workers[i].pool = pool;
+        pool->workers[i].index = i;
+        if (pool_deque_init(&pool->workers[i].deque) != 0) {
+            pool->num_workers = i;
+            pool_release(pool);
+            ERROR_RETURN(-2, "Out of memory for worker deques");
+        }
+    }
+    pool->num_workers = num_threads;
+
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+    pthread_attr_setstacksize(&attr, RSA_4096_POOL_STACK_SIZE);
+    for (int i = 0; i < num_threads; i++) {
+        if (pthread_create(&pool->workers[i].thread, &attr, pool_worker_main, &pool->workers[i]) != 0) {
+            pthread_attr_destroy(&attr);
+            pool_stop_and_join(pool, i);
+            pool_release(pool);
+            ERROR_RETURN(-3, "Failed to start worker thread %d", i);
+        }
+    }
+    pthread_attr_destroy(&attr);
+
+    CHECKPOINT(LOG_INFO, "Worker pool started with %d threads", num_threads);
+    *out_pool = pool;
+    return 0;
+}
+
+/**
+ * @brief Finish every queued job, then stop and free the pool
+ */
+void rsa_4096_pool_destroy(rsa_4096_pool_t *pool) {
+    if (pool == NULL) {
+        return;
+    }
+    pool_stop_and_join(pool, pool->num_workers);
+    pool_release(pool);
+}
+
+int rsa_4096_pool_size(const rsa_4096_pool_t *pool) {
+    return pool != NULL ? pool->num_workers : 0;
+}
+
+/**
+ * @brief 1 when called from one of this pool's worker threads
+ */
+int rsa_4096_pool_is_worker(const rsa_4096_pool_t *pool) {
+    return pool != NULL && pool_current == pool;
+}
+
+/* ===================== JOB SUBMISSION ===================== */
+
+/**
+ * @brief Items per job: enough to fill the multi-buffer lanes, but never so
+ * many that some workers get nothing
+ */
+static size_t pool_job_grain(const rsa_4096_pool_t *pool, size_t count) {
+    size_t grain = (size_t)rsa_4096_simd_lanes(rsa_4096_simd_kernel());
+    size_t share = (count + (size_t)pool->num_workers - 1) / (size_t)pool->num_workers;
+    if (share < grain) {
+        grain = share;
+    }
+    return grain > 0 ? grain : 1;
+}
+
+/**
+ * @brief Queue count items as batch jobs spread over the workers
+ *
+ * The key, items and future must stay valid until the future completes
+ * (or, without a future, until every callback has run). The callback, if
+ * any, runs on the worker thread right after its item finishes.
+ *
+ * @param future Optional; initialized here and completed by the workers
+ * @return 0 when queued, negative on error (nothing is queued on error)
+ */
+int rsa_4096_pool_submit(rsa_4096_pool_t *pool, rsa_4096_op_t op, const rsa_4096_key_t *key,
+                         rsa_4096_batch_item_t *items, size_t count,
+                         rsa_4096_job_callback_t callback, void *user, rsa_4096_future_t *future) {
+    if (pool == NULL || key == NULL || (items == NULL && count > 0)) {
+        ERROR_RETURN(-1, "NULL pointer in rsa_4096_pool_submit");
+    }
+    if (op != RSA_4096_OP_ENCRYPT && op != RSA_4096_OP_DECRYPT) {
+        ERROR_RETURN(-2, "Unknown pool operation %d", (int)op);
+    }
+    if (op == RSA_4096_OP_DECRYPT && !key->is_private) {
+        ERROR_RETURN(-2, "Decryption requires private key");
+    }
+    if (op == RSA_4096_OP_ENCRYPT && bigint_is_zero(&key->exponent)) {
+        ERROR_RETURN(-2, "Encryption requires a public exponent");
+    }
+
+    if (future != NULL) {
+        future->pool = pool;
+        future->remaining = count;
+        future->failed = 0;
+    }
+    if (count == 0) {
+        return 0;
+    }
+
+    /* Lock every deque so the batch appears atomically and can be rolled back */
+    for (int w = 0; w < pool->num_workers; w++) {
+        pthread_mutex_lock(&pool->workers[w].deque.lock);
+    }
+
+    unsigned int start = __atomic_fetch_add(&pool->next_worker, 1, __ATOMIC_RELAXED);
+    size_t pushed[RSA_4096_POOL_MAX_THREADS] = {0};
+    size_t grain = pool_job_grain(pool, count);
+    size_t jobs = 0;
+    int ret = 0;
+    for (size_t i = 0; i < count; i += grain, jobs++) {
+        int w = (int)((start + jobs) % (size_t)pool->num_workers);
+        size_t n = count - i < grain ? count - i : grain;
+        rsa_4096_pool_job_t job = { op, key, &items[i], n, callback, user, NULL, NULL, future };
+        if (pool_deque_push_locked(&pool->workers[w].deque, &job) != 0) {
+            ret = -3;
+            break;
+        }
+        pushed[w]++;
+    }
+    if (ret != 0) {
+        for (int w = 0; w < pool->num_workers; w++) {
+            pool->workers[w].deque.count -= pushed[w];
+        }
+    }
+
+    for (int w = pool->num_workers - 1; w >= 0; w--) {
+        pthread_mutex_unlock(&pool->workers[w].deque.lock);
+    }
+    if (ret != 0) {
+        ERROR_RETURN(ret, "Out of memory queueing %zu items", count);
+    }
+
+    pthread_mutex_lock(&pool->lock);
+    __atomic_add_fetch(&pool->pending, (long)jobs, __ATOMIC_ACQ_REL);
+    pthread_cond_broadcast(&pool->work_cond);
+    pthread_mutex_unlock(&pool->lock);
+    return 0;
+}
+
+/**
+ * @brief Queue one function call; it runs on the worker whose deque it lands in
+ * 
+ * Pushed on the back of a worker's deque, so that worker picks it up next.
+ * The future (optional) completes when fn returns.
+ */
+int rsa_4096_pool_run(rsa_4096_pool_t *pool, rsa_4096_task_fn_t fn, void *arg, rsa_4096_future_t *future) {
+    if (pool == NULL || fn == NULL) {
+        ERROR_RETURN(-1, "NULL pointer in rsa_4096_pool_run");
+    }
+
+    if (future != NULL) {
+        future->pool = pool;
+        future->remaining = 1;
+        future->failed = 0;
+    }
+
+    unsigned int start = __atomic_fetch_add(&pool->next_worker, 1, __ATOMIC_RELAXED);
+    rsa_4096_pool_deque_t *dq = &pool->workers[start % (unsigned int)pool->num_workers].deque;
+    rsa_4096_pool_job_t job = { RSA_4096_OP_ENCRYPT, NULL, NULL, 1, NULL, NULL, fn, arg, future };
+    pthread_mutex_lock(&dq->lock);
+    int ret = pool_deque_push_locked(dq, &job);
+    pthread_mutex_unlock(&dq->lock);
+    if (ret != 0) {
+        ERROR_RETURN(-3, "Out of memory queueing a pool task");
+    }
+
+    pthread_mutex_lock(&pool->lock);
+    __atomic_add_fetch(&pool->pending, 1, __ATOMIC_ACQ_REL);
+    pthread_cond_broadcast(&pool->work_cond);
+    pthread_mutex_unlock(&pool->lock);
+    return 0;
+}
+
+/**
+ * @brief Block until every item of the submission has finished
+ * @return 0 when all items succeeded, -6 when some failed (see item status)
+ */
+int rsa_4096_future_wait(rsa_4096_future_t *future) {
+    if (future == NULL || future->pool == NULL) {
+        ERROR_RETURN(-1, "NULL pointer in rsa_4096_future_wait");
+    }
+
+    rsa_4096_pool_t *pool = future->pool;
+    pthread_mutex_lock(&pool->lock);
+    while (__atomic_load_n(&future->remaining, __ATOMIC_ACQUIRE) > 0) {
+        pthread_cond_wait(&pool->done_cond, &pool->lock);
+    }
+    pthread_mutex_unlock(&pool->lock);
+
+    size_t failed = __atomic_load_n(&future->failed, __ATOMIC_RELAXED);
+    if (failed > 0) {
+        ERROR_RETURN(-6, "%zu pool jobs failed", failed);
+    }
+    return 0;
+}
+
+/**
+ * @brief Non-blocking completion check: 1 when every item has finished
+ */
+int rsa_4096_future_done(const rsa_4096_future_t *future) {
+    return future != NULL && __atomic_load_n(&future->remaining, __ATOMIC_ACQUIRE) == 0;
+}
+
+/* ===================== COMPLETION QUEUE ===================== */
+
+/*
+ * Each submission is one heap node that doubles as its queue entry: the
+ * worker finishing the last item links it onto the ready list, so posting
+ * a completion never allocates or fails. The descriptor is the read end
+ * of a non-blocking pipe that holds one byte exactly while the list is
+ * non-empty, so it is level-triggered for poll/epoll/select like an
+ * eventfd, and works beyond Linux.
+ */
+
+typedef struct rsa_4096_cq_node {
+    struct rsa_4096_cq_node *next;
+    rsa_4096_cq_t *cq;
+    rsa_4096_completion_t done;
+    size_t remaining;             /* Items still running (atomic) */
+} rsa_4096_cq_node_t;
+
+struct rsa_4096_cq {
+    pthread_mutex_t lock;
+    pthread_cond_t cond;          /* Broadcast on every completion */
+    rsa_4096_cq_node_t *head, *tail;   /* Finished submissions, oldest first */
+    size_t inflight;              /* Submitted and not yet finished */
+    int fds[2];                   /* fds[0] readable while head != NULL */
+};
+
+static int cq_set_flags(int fd) {
+    int fl = fcntl(fd, F_GETFL);
+    int fd_fl = fcntl(fd, F_GETFD);
+    if (fl < 0 || fd_fl < 0) {
+        return -1;
+    }
+    if (fcntl(fd, F_SETFL, fl | O_NONBLOCK) < 0 || fcntl(fd, F_SETFD, fd_fl | FD_CLOEXEC) < 0) {
+        return -1;
+    }
+    return 0;
+}
+
+int rsa_4096_cq_create(rsa_4096_cq_t **out_cq) {
+    if (out_cq == NULL) {
+        ERROR_RETURN(-1, "NULL pointer in rsa_4096_cq_create");
+    }
+    *out_cq = NULL;
+    
+    rsa_4096_cq_t *cq = (rsa_4096_cq_t *)calloc(1, sizeof(*cq));
+    if (cq == NULL) {
+        ERROR_RETURN(-3, "Out of memory allocating completion queue");
+    }
+    if (pipe(cq->fds) != 0) {
+        free(cq);
+        ERROR_RETURN(-5, "Cannot create completion queue pipe: errno %d", errno);
+    }
+    if (cq_set_flags(cq->fds[0]) != 0 || cq_set_flags(cq->fds[1]) != 0) {
+        close(cq->fds[0]);
+        close(cq->fds[1]);
+        free(cq);
+        ERROR_RETURN(-5, "Cannot configure completion queue pipe: errno %d", errno);
+    }
+    pthread_mutex_init(&cq->lock, NULL);
+    pthread_cond_init(&cq->cond, NULL);
+    *out_cq = cq;
+    return 0;
+}
+
+void rsa_4096_cq_destroy(rsa_4096_cq_t *cq) {
+    if (cq == NULL) {
+        return;
+    }
+    
+    pthread_mutex_lock(&cq->lock);
+    while (cq->inflight > 0) {
+        pthread_cond_wait(&cq->cond, &cq->lock);
+    }
+    pthread_mutex_unlock(&cq->lock);
+    
+    while (cq->head != NULL) {
+        rsa_4096_cq_node_t *node = cq->head;
+        cq->head = node->next;
+        free(node);
+    }
+    close(cq->fds[0]);
+    close(cq->fds[1]);
+    pthread_cond_destroy(&cq->cond);
+    pthread_mutex_destroy(&cq->lock);
+    free(cq);
+}
+
+int rsa_4096_cq_fd(const rsa_4096_cq_t *cq) {
+    return cq != NULL ? cq->fds[0] : -1;
+}
+
+size_t rsa_4096_cq_inflight(rsa_4096_cq_t *cq) {
+    if (cq == NULL) {
+        return 0;
+    }
+    pthread_mutex_lock(&cq->lock);
+    size_t n = cq->inflight;
+    pthread_mutex_unlock(&cq->lock);
+    return n;
+}
+
+/**
+ * @brief Link a finished submission onto the ready list; the first one arms the descriptor
+ */
+static void cq_post(rsa_4096_cq_node_t *node) {
+    rsa_4096_cq_t *cq = node->cq;
+    const char byte = 1;
+    
+    node->next = NULL;
+    pthread_mutex_lock(&cq->lock);
+    if (cq->tail != NULL) {
+        cq->tail->next = node;
+    } else {
+        cq->head = node;
+        /* The pipe is empty whenever the list is, so this single byte always fits */
+        ssize_t wrote = write(cq->fds[1], &byte, 1);
+        (void)wrote;
+    }
+    cq->tail = node;
+    cq->inflight--;
+    pthread_cond_broadcast(&cq->cond);
+    pthread_mutex_unlock(&cq->lock);
+}
+
+/**
+ * @brief Move up to max completions out; the last one disarms the descriptor (caller holds the lock)
+ */
+static int cq_take_locked(rsa_4096_cq_t *cq, rsa_4096_completion_t *out, size_t max) {
+    int taken = 0;
+    while (cq->head != NULL && (size_t)taken < max) {
+        rsa_4096_cq_node_t *node = cq->head;
+        cq->head = node->next;
+        out[taken++] = node->done;
+        free(node);
+    }
+    if (cq->head == NULL && taken > 0) {
+        char byte;
+        cq->tail = NULL;
+        while (read(cq->fds[0], &byte, 1) == 1) {
+        }
+    }
+    return taken;
+}
+
+/**
+ * @brief Collect finished submissions without blocking
+ * @return Number of completions written to out (0 when none are ready)
+ */
+int rsa_4096_cq_poll(rsa_4096_cq_t *cq, rsa_4096_completion_t *out, size_t max) {
+    if (cq == NULL || (out == NULL && max > 0)) {
+        ERROR_RETURN(-1, "NULL pointer in rsa_4096_cq_poll");
+    }
+    pthread_mutex_lock(&cq->lock);
+    int taken = cq_take_locked(cq, out, max);
+    pthread_mutex_unlock(&cq->lock);
+    return taken;
+}
+
+/**
+ * @brief Block until at least one submission finishes, the timeout expires or nothing is in flight
+ * @return Number of completions written to out (0 on timeout or when the queue is idle)
+ */
+int rsa_4096_cq_wait(rsa_4096_cq_t *cq, rsa_4096_completion_t *out, size_t max, int timeout_ms) {
+    if (cq == NULL || (out == NULL && max > 0)) {
+        ERROR_RETURN(-1, "NULL pointer in rsa_4096_cq_wait");
+    }
+    
+    struct timespec deadline;
+    if (timeout_ms > 0) {
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        deadline.tv_sec += timeout_ms / 1000;
+        deadline.tv_nsec += (long)(timeout_ms % 1000) * 1000000L;
+        if (deadline.tv_nsec >= 1000000000L) {
+            deadline.tv_sec++;
+            deadline.tv_nsec -= 1000000000L;
+        }
+    }
+    
+    pthread_mutex_lock(&cq->lock);
+    while (cq->head == NULL && cq->inflight > 0 && timeout_ms != 0) {
+        if (timeout_ms < 0) {
+            pthread_cond_wait(&cq->cond, &cq->lock);
+        } else if (pthread_cond_timedwait(&cq->cond, &cq->lock, &deadline) == ETIMEDOUT) {
+            break;
+        }
+    }
+    int taken = cq_take_locked(cq, out, max);
+    pthread_mutex_unlock(&cq->lock);
+    return taken;
+}
+
+/* Per-item pool callback: the submission's last item posts its completion */
+static void cq_item_done(void *user, rsa_4096_batch_item_t *item) {
+    rsa_4096_cq_node_t *node = (rsa_4096_cq_node_t *)user;
+    if (item->status != 0) {
+        __atomic_add_fetch(&node->done.failed, 1, __ATOMIC_RELAXED);
+    }
+    if (__atomic_sub_fetch(&node->remaining, 1, __ATOMIC_ACQ_REL) == 0) {
+        cq_post(node);
+    }
+}
+
+/**
+ * @brief Queue items on the pool; one completion carrying token follows when all have finished
+ * 
+ * The items (and their buffers) belong to the pool until the completion is
+ * collected. An empty submission completes immediately.
+ */
+int rsa_4096_async_submit(rsa_4096_cq_t *cq, rsa_4096_pool_t *pool, rsa_4096_op_t op, const rsa_4096_key_t *key,
+                          rsa_4096_batch_item_t *items, size_t count, void *token) {
+    if (cq == NULL || pool == NULL) {
+        ERROR_RETURN(-1, "NULL pointer in rsa_4096_async_submit");
+    }
+    
+    rsa_4096_cq_node_t *node = (rsa_4096_cq_node_t *)calloc(1, sizeof(*node));
+    if (node == NULL) {
+        ERROR_RETURN(-3, "Out of memory allocating a completion");
+    }
+    node->cq = cq;
+    node->done = (rsa_4096_completion_t){ token, items, count, 0 };
+    node->remaining = count;
+    
+    pthread_mutex_lock(&cq->lock);
+    cq->inflight++;
+    pthread_mutex_unlock(&cq->lock);
+    
+    int ret = rsa_4096_pool_submit(pool, op, key, items, count, cq_item_done, node, NULL);
+    if (ret != 0) {
+        pthread_mutex_lock(&cq->lock);
+        cq->inflight--;
+        pthread_cond_broadcast(&cq->cond);
+        pthread_mutex_unlock(&cq->lock);
+        free(node);
+        return ret;
+    }
+    if (count == 0) {
+        cq_post(node);
+    }
+    return 0;
+}
@@ -0,0 +1,472 @@
+/**
+ * @file rsa_4096_simd.c
+ * @brief Multi-Buffer Montgomery Exponentiation - several bases, one modulus, one exponent
+ *
+ * Batches for one key share the modulus and the exponent, so every lane
+ * follows exactly the same square/multiply schedule and only the data
+ * differs. Operands are kept lane-interleaved in a small radix
+ * (x[digit * lanes + lane]) so one vector instruction advances every lane:
+ *
+ * - AVX-512 IFMA: 8 lanes, radix 2^52, vpmadd52luq/vpmadd52huq
+ * - AVX2:         4 lanes, radix 2^29, vpmuludq with periodic carry folding
+ * - scalar:       montgomery_exp once per base (always available)
+ *
+ * Multiplication is "almost Montgomery" with R' = 2^(radix * m) > 4n, so
+ * values stay below 2n without a conditional subtraction per product; the
+ * single reduction happens when the result leaves Montgomery form.
+ *
+ * The kernel is picked once from the CPU features at first use
+ * (rsa_4096_simd_set_kernel overrides it, e.g. for testing).
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "rsa_4096.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define RSA_4096_SIMD_X86 1
+#endif
+
+/* ===================== MULTI-BUFFER MODULUS ===================== */
+
+#define MB_MAX_DIGITS ((BIGINT_MAX_BITS + 2 + 28) / 29 + 1)   /* Smallest radix needs the most digits */
+
+/**
+ * @brief Modulus in the kernel's radix, shared by every lane
+ */
+typedef struct {
+    int lanes;
+    int radix;                    /* Bits per digit */
+    int m;                        /* Digits per operand, radix * m >= bits(n) + 2 */
+    uint64_t mask;
+    uint64_t n_prime;             /* -n^(-1) mod 2^radix */
+    uint64_t n[MB_MAX_DIGITS];
+    uint64_t r2[MB_MAX_DIGITS];   /* R'^2 mod n */
+} mb_modulus_t;
+
+typedef void (*mb_mul_fn_t)(uint64_t *r, const uint64_t *a, const uint64_t *b, const mb_modulus_t *mod);
+
+typedef struct {
+    const char *name;
+    int lanes;
+    int radix;
+    int max_bits;                 /* Larger moduli go to the scalar path instead */
+    mb_mul_fn_t mul;              /* r = a * b / R' per lane; r may alias a or b */
+} mb_kernel_t;
+
+/**
+ * @brief Digit k of a: bits [k * radix, (k + 1) * radix)
+ */
+static uint64_t mb_get_digit(const bigint_t *a, int k, int radix) {
+    int pos = k * radix;
+    int word = pos / BIGINT_WORD_SIZE, shift = pos % BIGINT_WORD_SIZE;
+    uint64_t v = 0;
+    int got = 0;
+    while (got < radix && word < a->used) {
+        v |= (uint64_t)(a->words[word] >> shift) << got;
+        got += BIGINT_WORD_SIZE - shift;
+        shift = 0;
+        word++;
+    }
+    return v & (((uint64_t)1 << radix) - 1);
+}
+
+/**
+ * @brief Inverse of mb_get_digit for m normalized digits
+ */
+static void mb_set_digits(bigint_t *a, const uint64_t *d, int stride, int m, int radix) {
+    bigint_init(a);
+    for (int k = 0; k < m; k++) {
+        uint64_t v = d[k * stride];
+        int pos = k * radix;
+        int word = pos / BIGINT_WORD_SIZE, shift = pos % BIGINT_WORD_SIZE;
+        while (v != 0 && word < BIGINT_4096_WORDS) {
+            a->words[word] |= (bigint_word_t)(v << shift);
+            int room = BIGINT_WORD_SIZE - shift;
+            v = room >= 64 ? 0 : v >> room;
+            shift = 0;
+            word++;
+        }
+    }
+    a->used = BIGINT_4096_WORDS;
+    bigint_normalize(a);
+    if (bigint_is_zero(a)) {
+        bigint_init(a);   /* Same zero representation as montgomery_exp */
+    }
+}
+
+static int mb_modulus_init(mb_modulus_t *mod, const mb_kernel_t *kernel, const bigint_t *n) {
+    const int bits = bigint_bit_length(n);
+    mod->lanes = kernel->lanes;
+    mod->radix = kernel->radix;
+    mod->m = (bits + 2 + kernel->radix - 1) / kernel->radix;
+    mod->mask = ((uint64_t)1 << kernel->radix) - 1;
+    if (mod->m > MB_MAX_DIGITS || 2 * kernel->radix * mod->m > BIGINT_WIDE_WORDS * BIGINT_WORD_SIZE - 1) {
+        ERROR_RETURN(-3, "Modulus too large for the %s kernel", kernel->name);
+    }
+
+    for (int k = 0; k < mod->m; k++) {
+        mod->n[k] = mb_get_digit(n, k, kernel->radix);
+    }
+
+    /* -n^(-1) mod 2^64 by Newton iteration, then truncated to the radix */
+    uint64_t n0 = mod->n[0] | (kernel->radix < 64 && mod->m > 1 ? mod->n[1] << kernel->radix : 0);
+    uint64_t inv = n0;
+    for (int i = 0; i < 6; i++) {
+        inv *= 2 - n0 * inv;
+    }
+    mod->n_prime = (0 - inv) & mod->mask;
+
+    /* R'^2 mod n with R' = 2^(radix * m) */
+    bigint_wide_t r2_wide;
+    bigint_wide_init(&r2_wide);
+    int r2_bit = 2 * kernel->radix * mod->m;
+    r2_wide.words[r2_bit / BIGINT_WORD_SIZE] = (bigint_word_t)1 << (r2_bit % BIGINT_WORD_SIZE);
+    r2_wide.used = r2_bit / BIGINT_WORD_SIZE + 1;
+    bigint_t r2;
+    int ret = bigint_mod_wide(&r2, &r2_wide, n);
+    if (ret != 0) {
+        ERROR_RETURN(ret, "Failed to compute R'^2 mod n");
+    }
+    for (int k = 0; k < mod->m; k++) {
+        mod->r2[k] = mb_get_digit(&r2, k, kernel->radix);
+    }
+    return 0;
+}
+
+/* ===================== AVX-512 IFMA KERNEL (8 x 52-bit) ===================== */
+
+#ifdef RSA_4096_SIMD_X86
+
+__attribute__((target("avx512f,avx512ifma")))
+static void mb_mul_ifma(uint64_t *r, const uint64_t *a, const uint64_t *b, const mb_modulus_t *mod) {
+    const int m = mod->m;
+    __m512i acc[MB_MAX_DIGITS + 1], nb[MB_MAX_DIGITS];
+    const __m512i zero = _mm512_setzero_si512();
+    const __m512i np = _mm512_set1_epi64((long long)mod->n_prime);
+
+    for (int j = 0; j < m; j++) {
+        nb[j] = _mm512_set1_epi64((long long)mod->n[j]);
+        acc[j] = zero;
+    }
+    acc[m] = zero;
+
+    for (int i = 0; i < m; i++) {
+        const __m512i ai = _mm512_loadu_si512((const void *)(a + i * 8));
+        __m512i bj = _mm512_loadu_si512((const void *)b);
+
+        /* q = (acc0 + a_i * b_0) * n' mod 2^52 clears the low digit */
+        __m512i t0 = _mm512_madd52lo_epu64(acc[0], ai, bj);
+        const __m512i q = _mm512_madd52lo_epu64(zero, t0, np);
+        t0 = _mm512_madd52lo_epu64(t0, q, nb[0]);
+        const __m512i carry = _mm512_srli_epi64(t0, 52);
+
+        /* Low halves land on digit j, high halves of digit j - 1 products on digit j; shift down one */
+        for (int j = 1; j < m; j++) {
+            const __m512i bprev = bj;
+            bj = _mm512_loadu_si512((const void *)(b + j * 8));
+            __m512i x = _mm512_madd52lo_epu64(acc[j], ai, bj);
+            x = _mm512_madd52lo_epu64(x, q, nb[j]);
+            x = _mm512_madd52hi_epu64(x, ai, bprev);
+            acc[j - 1] = _mm512_madd52hi_epu64(x, q, nb[j - 1]);
+        }
+        __m512i x = _mm512_madd52hi_epu64(acc[m], ai, bj);
+        acc[m - 1] = _mm512_madd52hi_epu64(x, q, nb[m - 1]);
+        acc[m] = zero;
+        acc[0] = _mm512_add_epi64(acc[0], carry);
+    }
+
+    /* Digits grew by at most 4 * 2^52 per row: one carry pass restores radix 2^52 */
+    const __m512i mask = _mm512_set1_epi64((long long)mod->mask);
+    __m512i c = zero;
+    for (int j = 0; j < m; j++) {
+        __m512i x = _mm512_add_epi64(acc[j], c);
+        c = _mm512_srli_epi64(x, 52);
+        _mm512_storeu_si512((void *)(r + j * 8), _mm512_and_si512(x, mask));
+    }
+}
+
+/* ===================== AVX2 KERNEL (4 x 29-bit) ===================== */
+
+__attribute__((target("avx2")))
+static void mb_fold_avx2(__m256i *acc, int count, __m256i mask) {
+    __m256i c = _mm256_setzero_si256();
+    for (int j = 0; j < count; j++) {
+        __m256i x = _mm256_add_epi64(acc[j], c);
+        c = _mm256_srli_epi64(x, 29);
+        acc[j] = _mm256_and_si256(x, mask);
+    }
+    acc[count] = _mm256_add_epi64(acc[count], c);
+}
+
+__attribute__((target("avx2")))
+static void mb_mul_avx2(uint64_t *r, const uint64_t *a, const uint64_t *b, const mb_modulus_t *mod) {
+    const int m = mod->m;
+    __m256i acc[MB_MAX_DIGITS + 1], nb[MB_MAX_DIGITS];
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i mask = _mm256_set1_epi64x((long long)mod->mask);
+    const __m256i np = _mm256_set1_epi64x((long long)mod->n_prime);
+
+    for (int j = 0; j < m; j++) {
+        nb[j] = _mm256_set1_epi64x((long long)mod->n[j]);
+        acc[j] = zero;
+    }
+    acc[m] = zero;
+
+    for (int i = 0; i < m; i++) {
+        const __m256i ai = _mm256_loadu_si256((const __m256i *)(a + i * 4));
+
+        __m256i t0 = _mm256_add_epi64(acc[0], _mm256_mul_epu32(ai, _mm256_loadu_si256((const __m256i *)b)));
+        const __m256i q = _mm256_and_si256(_mm256_mul_epu32(_mm256_and_si256(t0, mask), np), mask);
+        t0 = _mm256_add_epi64(t0, _mm256_mul_epu32(q, nb[0]));
+        const __m256i carry = _mm256_srli_epi64(t0, 29);
+
+        for (int j = 1; j < m; j++) {
+            const __m256i bj = _mm256_loadu_si256((const __m256i *)(b + j * 4));
+            __m256i x = _mm256_add_epi64(acc[j], _mm256_mul_epu32(ai, bj));
+            acc[j - 1] = _mm256_add_epi64(x, _mm256_mul_epu32(q, nb[j]));
+        }
+        acc[m - 1] = acc[m];
+        acc[m] = zero;
+        acc[0] = _mm256_add_epi64(acc[0], carry);
+
+        /* Each row adds up to 2^59 per digit: fold carries every 8 rows to stay below 2^64 */
+        if ((i & 7) == 7) {
+            mb_fold_avx2(acc, m, mask);
+        }
+    }
+
+    mb_fold_avx2(acc, m, mask);
+    for (int j = 0; j < m; j++) {
+        _mm256_storeu_si256((__m256i *)(r + j * 4), acc[j]);
+    }
+}
+
+#endif /* RSA_4096_SIMD_X86 */
+
+/* ===================== KERNEL DISPATCH ===================== */
+
+/* Measured crossover: above ~2.5k bits four 29-bit lanes no longer beat the 64-bit scalar CIOS */
+#if BIGINT_WORD_SIZE == 64
+#define MB_AVX2_MAX_BITS 2560
+#else
+#define MB_AVX2_MAX_BITS BIGINT_MAX_BITS
+#endif
+
+static const mb_kernel_t mb_kernels[] = {
+    { "scalar",       1, 0,  BIGINT_MAX_BITS,  NULL },
+#ifdef RSA_4096_SIMD_X86
+    { "avx2",         4, 29, MB_AVX2_MAX_BITS, mb_mul_avx2 },
+    { "avx512-ifma",  8, 52, BIGINT_MAX_BITS,  mb_mul_ifma },
+#else
+    { "avx2",         4, 29, MB_AVX2_MAX_BITS, NULL },
+    { "avx512-ifma",  8, 52, BIGINT_MAX_BITS,  NULL },
+#endif
+};
+
+static int mb_active_kernel = -1;   /* -1 until the first use detects the CPU */
+
+/**
+ * @brief 1 when the CPU (and this build) can run the kernel
+ */
+int rsa_4096_simd_supported(rsa_4096_simd_kernel_t kernel) {
+    switch (kernel) {
+    case RSA_4096_SIMD_SCALAR:
+        return 1;
+#ifdef RSA_4096_SIMD_X86
+    case RSA_4096_SIMD_AVX2:
+        return __builtin_cpu_supports("avx2");
+    case RSA_4096_SIMD_AVX512_IFMA:
+        return __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512ifma");
+#endif
+    default:
+        return 0;
+    }
+}
+
+/**
+ * @brief The kernel used by montgomery_exp_multi (detected once, widest first)
+ */
+rsa_4096_simd_kernel_t rsa_4096_simd_kernel(void) {
+    int k = __atomic_load_n(&mb_active_kernel, __ATOMIC_RELAXED);
+    if (k < 0) {
+        k = RSA_4096_SIMD_SCALAR;
+        if (rsa_4096_simd_supported(RSA_4096_SIMD_AVX512_IFMA)) {
+            k = RSA_4096_SIMD_AVX512_IFMA;
+        } else if (rsa_4096_simd_supported(RSA_4096_SIMD_AVX2)) {
+            k = RSA_4096_SIMD_AVX2;
+        }
+        __atomic_store_n(&mb_active_kernel, k, __ATOMIC_RELAXED);
+        CHECKPOINT(LOG_INFO, "Multi-buffer Montgomery kernel: %s", mb_kernels[k].name);
+    }
+    return (rsa_4096_simd_kernel_t)k;
+}
+
+/**
+ * @brief Force a kernel; fails (-2) if this CPU cannot run it
+ */
+int rsa_4096_simd_set_kernel(rsa_4096_simd_kernel_t kernel) {
+    if (!rsa_4096_simd_supported(kernel)) {
+        ERROR_RETURN(-2, "Multi-buffer kernel %d is not supported on this CPU", (int)kernel);
+    }
+    __atomic_store_n(&mb_active_kernel, (int)kernel, __ATOMIC_RELAXED);
+    return 0;
+}
+
+const char *rsa_4096_simd_kernel_name(rsa_4096_simd_kernel_t kernel) {
+    if ((int)kernel < 0 || (size_t)kernel >= sizeof(mb_kernels) / sizeof(mb_kernels[0])) {
+        return "unknown";
+    }
+    return mb_kernels[kernel].name;
+}
+
+int rsa_4096_simd_lanes(rsa_4096_simd_kernel_t kernel) {
+    if ((int)kernel < 0 || (size_t)kernel >= sizeof(mb_kernels) / sizeof(mb_kernels[0])) {
+        return 1;
+    }
+    return mb_kernels[kernel].lanes;
+}
+
+/* ===================== LOCKSTEP EXPONENTIATION ===================== */
+
+static inline int mb_exp_bit(const bigint_t *exp, int i) {
+    return (int)((exp->words[i / BIGINT_WORD_SIZE] >> (i % BIGINT_WORD_SIZE)) & 1);
+}
+
+/**
+ * @brief One group of at most kernel->lanes bases through the sliding window
+ */
+static int mb_exp_group(bigint_t *results, const bigint_t *bases, int count, const bigint_t *exp,
+                        const montgomery_ctx_t *ctx, const mb_kernel_t *kernel, const mb_modulus_t *mod) {
+    const int L = kernel->lanes, m = mod->m, size = m * L;
+    const int exp_bits = bigint_bit_length(exp);
+    int w = montgomery_window_bits_for_exponent(exp_bits);
+    if (w > RSA_4096_SIMD_WINDOW_MAX) {
+        w = RSA_4096_SIMD_WINDOW_MAX;
+    }
+    if (w > exp_bits) {
+        w = exp_bits;
+    }
+    const int entries = 1 << (w - 1);
+
+    /* Lane-interleaved operands and odd-power table from the thread's scratch arena */
+    size_t mark;
+    uint64_t *x = (uint64_t *)bigint_scratch_push((size_t)(3 + entries) * size * sizeof(uint64_t), &mark);
+    if (x == NULL) {
+        ERROR_RETURN(-4, "Out of scratch memory for the %d-entry lane table", entries);
+    }
+    uint64_t *r2 = x + size, *acc = r2 + size, *table = acc + size;
+
+    /* Interleave the bases (unused lanes repeat the last one) and R'^2 */
+    for (int k = 0; k < m; k++) {
+        for (int lane = 0; lane < L; lane++) {
+            const bigint_t *base = &bases[lane < count ? lane : count - 1];
+            x[k * L + lane] = mb_get_digit(base, k, mod->radix);
+            r2[k * L + lane] = mod->r2[k];
+        }
+    }
+
+    /* table[k] = base^(2k+1) in Montgomery form */
+    kernel->mul(table, x, r2, mod);
+    if (entries > 1) {
+        kernel->mul(x, table, table, mod);
+        for (int k = 1; k < entries; k++) {
+            kernel->mul(table + k * size, table + (k - 1) * size, x, mod);
+        }
+    }
+
+    int started = 0;
+    int i = exp_bits - 1;
+    while (i >= 0) {
+        if (!mb_exp_bit(exp, i)) {
+            kernel->mul(acc, acc, acc, mod);
+            i--;
+            continue;
+        }
+        int low = i - w + 1;
+        if (low < 0) {
+            low = 0;
+        }
+        while (!mb_exp_bit(exp, low)) {
+            low++;
+        }
+        uint32_t value = 0;
+        for (int b = i; b >= low; b--) {
+            value = (value << 1) | (uint32_t)mb_exp_bit(exp, b);
+        }
+
+        if (started) {
+            for (int sq = 0; sq < i - low + 1; sq++) {
+                kernel->mul(acc, acc, acc, mod);
+            }
+            kernel->mul(acc, acc, table + (value >> 1) * size, mod);
+        } else {
+            memcpy(acc, table + (value >> 1) * size, (size_t)size * sizeof(uint64_t));
+            started = 1;
+        }
+        i = low - 1;
+    }
+
+    /* Leave Montgomery form: acc * 1 / R' <= n, equal to n only for a zero residue */
+    memset(x, 0, (size_t)size * sizeof(uint64_t));
+    for (int lane = 0; lane < L; lane++) {
+        x[lane] = 1;
+    }
+    kernel->mul(acc, acc, x, mod);
+
+    for (int lane = 0; lane < count; lane++) {
+        mb_set_digits(&results[lane], acc + lane, L, m, mod->radix);
+        if (bigint_compare(&results[lane], &ctx->n) >= 0) {
+            bigint_t t;
+            bigint_sub(&t, &results[lane], &ctx->n);
+            bigint_copy(&results[lane], &t);
+        }
+    }
+    bigint_scratch_pop(x, mark);
+    return 0;
+}
+
+/**
+ * @brief results[i] = bases[i]^exp mod n for i < count, lanes in lockstep
+ *
+ * Groups of the active kernel's lane count run together; a trailing single
+ * base, a modulus above the kernel's size limit, or the scalar kernel goes
+ * through montgomery_exp. Bases must be
+ * reduced (< n). results may alias bases.
+ */
+int montgomery_exp_multi(bigint_t *results, const bigint_t *bases, int count,
+                         const bigint_t *exp, const montgomery_ctx_t *ctx) {
+    if (results == NULL || bases == NULL || exp == NULL || ctx == NULL) {
+        ERROR_RETURN(-1, "NULL pointer in montgomery_exp_multi");
+    }
+    if (!ctx->is_active || ctx->n_words == 0) {
+        ERROR_RETURN(-1, "Montgomery context disabled");
+    }
+
+    const mb_kernel_t *kernel = &mb_kernels[rsa_4096_simd_kernel()];
+    mb_modulus_t mod;
+    int use_simd = kernel->mul != NULL && count > 1 && !bigint_is_zero(exp) && !bigint_is_one(&ctx->n) &&
+                   bigint_bit_length(&ctx->n) <= kernel->max_bits;
+    if (use_simd && mb_modulus_init(&mod, kernel, &ctx->n) != 0) {
+        use_simd = 0;
+    }
+
+    int done = 0;
+    while (use_simd && count - done > 1) {
+        int group = count - done < kernel->lanes ? count - done : kernel->lanes;
+        int ret = mb_exp_group(results + done, bases + done, group, exp, ctx, kernel, &mod);
+        if (ret != 0) {
+            return ret;
+        }
+        done += group;
+    }
+    for (; done < count; done++) {
+        int ret = montgomery_exp(&results[done], &bases[done], exp, ctx);
+        if (ret != 0) {
+            return ret;
+        }
+    }
+    return 0;
+}
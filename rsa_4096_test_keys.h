@@ -0,0 +1,287 @@
+/**
+ * @file rsa_4096_test_keys.h
+ * @brief Real RSA test keys (generated with OpenSSL) for CRT and round-trip testing
+ * 
+ * Keys were generated with:
+ * openssl genrsa -out key.pem <bits>
+ * openssl rsa -in key.pem -text -noout
+ * and converted to decimal so they can be passed to rsa_4096_load_key()
+ * and rsa_4096_load_crt_key() directly.
+ * 
+ * These keys are TEST VECTORS ONLY - never use them to protect real data.
+ */
+
+#ifndef RSA_4096_TEST_KEYS_H
+#define RSA_4096_TEST_KEYS_H
+
+/* 1024-bit key */
+#define TEST_KEY_1024_N \
+    "1236533742306841217569631690175628422244028442305624251574216545" \
+    "1106968118657147354852680364739444355109384295779697371224020292" \
+    "8475544701317476946806857729155936842121326167071766703805083515" \
+    "1855570058769043155074251063839995107435829394557248986802229613" \
+    "64273642600656215247989353834964064174002118801518073"
+#define TEST_KEY_1024_E "65537"
+#define TEST_KEY_1024_D \
+    "4459951569441554038315906112939485274730967898930428011460904633" \
+    "0052720202148046015839549943041485827254165735941603439430152689" \
+    "6761360094258589814703221459035441835816791359023721715919665680" \
+    "3660538139094897747354329688801916746208076758954658183203614627" \
+    "4317948697270446317281852864735862993227702846228705"
+#define TEST_KEY_1024_P \
+    "1113561155636269997439463499934430746931960475530420861606675861" \
+    "8777889728143510293594166472058801347115246805595855315574970154" \
+    "124814212614920448178628909"
+#define TEST_KEY_1024_Q \
+    "1110431821412005670584940664271178235056960709107448844262183210" \
+    "8718297269783320498238404423172476994637385606622661410702052925" \
+    "440068023443878863218147197"
+#define TEST_KEY_1024_DP \
+    "4014203015381674273999012036857183941325902350489981667677452009" \
+    "8360871694980000715040691960631274215419946866991482953210960204" \
+    "34239220181386019931032973"
+#define TEST_KEY_1024_DQ \
+    "3771303459265517526874835483062679884019383167266368063168542030" \
+    "8505403151019599256876330263968901986151170916002746186033277997" \
+    "84015656282921948479630137"
+#define TEST_KEY_1024_QINV \
+    "1483087447467933121662263211631988117454915536916282179241154630" \
+    "5100976785415594511738704788472531953556278585080479834327150937" \
+    "12137782480384279919872904"
+
+/* 2048-bit key */
+#define TEST_KEY_2048_N \
+    "2266552609517985963179197309431714120031961631721877880023396420" \
+    "4723110132783828359441489592931146671360537926136019735506913705" \
+    "9598580932839059194001931891388918416299288879756426317810716225" \
+    "9737321195693552781293186313556002869732936843065084456179775611" \
+    "3640264331788325119954459431043781199970268327971071520583999635" \
+    "6593032616275474227448363553885486327073976477475599239284565720" \
+    "7450377503765603362517003937450110877079756109740741182599208110" \
+    "3142002035696972358989055422446973014423758692358830909920452765" \
+    "4015479806001944826330432229072164843499199158177314557720404577" \
+    "21442098281812223808224902030454858005051"
+#define TEST_KEY_2048_E "65537"
+#define TEST_KEY_2048_D \
+    "2282964199739031333213097675991395902145033603169706252536239233" \
+    "3025193003656703971866408164235896711344555361344472865034851712" \
+    "3849618979197703525469180477728259596102770780290848322473466109" \
+    "3608404628840810205000754517974090810313046595964349235570598922" \
+    "8539595174451250910159873706984335139814720945242176484921726478" \
+    "9037925667606554652931550911248308003421854317268872205991328479" \
+    "5410307123713564953341173886624971996513763805818504117667637680" \
+    "2589605539662372295127000746815949214059112731618305252385988512" \
+    "5149274059629402853618073053454030672341926784820939432569208719" \
+    "382091560329560380333768067528021223769"
+#define TEST_KEY_2048_P \
+    "1761771830792726934458397422562148701469247310555529457361575274" \
+    "4006051936566489105703794997092304625620097389732255511700284046" \
+    "9201686135615695265524548485601551660932114841030741197538361017" \
+    "4047333703806760983524679728940009757223933478010560988615684693" \
+    "72802860715294840464841540285360744863971278422927209"
+#define TEST_KEY_2048_Q \
+    "1286518815832199931464161218897416103642738455791280748372928756" \
+    "9182310844345117341399028338854827461147742943988660644804440024" \
+    "7330073100198572886115195462681955722028323160093752715644242065" \
+    "2942297126021921158679973828922936209004841747479383998430322803" \
+    "43331616727342074015930379823735932633533092294747139"
+#define TEST_KEY_2048_DP \
+    "9200396861144251236986534596821572441183604559830781951905017587" \
+    "9824698647937514631843444737397825016684900615467055997061541038" \
+    "7785176006141137138193336881412500663045551434193984693493813543" \
+    "5978149139079664107470919285742684886550974760045691721527047109" \
+    "7001356607427345086122369291643979629360773365040873"
+#define TEST_KEY_2048_DQ \
+    "4607652111816744250015532009393190226086387389464415784336997998" \
+    "4412957587083417647636906353601860043648598864962058479156784146" \
+    "4414220334751499577779859911206015641156720816290120655751964501" \
+    "9738712199518826531049078491917414391528700657161008470201037099" \
+    "9873044353940112628010404431431554858694916495144801"
+#define TEST_KEY_2048_QINV \
+    "1102454670609920854358696914910793556788265139678699799081982584" \
+    "0824540665684728974904272898543145051919149317413394883994457726" \
+    "7209017748459687942587403771923240846012582618723017351471769997" \
+    "8427249570869326380008028234314780056957988857849964823346793761" \
+    "67406433030060802393654261891710166346143671613368268"
+
+/* 3072-bit key */
+#define TEST_KEY_3072_N \
+    "3727257002560968403066559949049718245693568613317268640523921515" \
+    "0919726815592931371532641308454957520262521774391052692019142226" \
+    "2347639431081201369977444553877508289614606333748202395638586501" \
+    "2752385784582609187982543356363694930507253312287892673723261825" \
+    "5157340402231845277785827534844829825284363950499213215986827699" \
+    "9345973447203850533048611480245310409651864704770815125046145434" \
+    "7786174378759526485444736980258537588554645120794466438729536426" \
+    "1918787175520172158417280320831158227786554367441068921284413526" \
+    "8890503251576980808282752979981517370412132229205616986641439185" \
+    "9795786866653854870875678294823091505944849315462153679451535367" \
+    "4630411284593468546971933010954547742874912399883891672068086426" \
+    "5694727041948053050965004415272794543144724360842133306833149242" \
+    "3965086670807159878045860869023962722479907844442447753519729450" \
+    "3185108055313954922867329488323564683061647721141974846846743162" \
+    "21501197978164608692541481939"
+#define TEST_KEY_3072_E "65537"
+#define TEST_KEY_3072_D \
+    "3071402633982408389270329280382532521456294504817112362962820718" \
+    "4116145790562525881862463858020812378988624569723801831522556356" \
+    "3759163029670877214178737097092555887218469186170738214694933610" \
+    "0427126574246361737598566519071995128279356930132713487715714098" \
+    "7072526487671556589816799914846499453964662330389093332459048017" \
+    "6841773288619313487606852052896043283538290635536382056366893269" \
+    "5304825477591409857735981516072788233667906827418178433916545076" \
+    "7733098881760910772727907541259973437118538146812599198521758217" \
+    "9551312228346815539269001524560492148255727629707341062020489440" \
+    "6955114868764664062331939267802789591907648712838871638788831154" \
+    "2957020630435745607541875393291821556469535900939013330878309762" \
+    "3448550481112237340743163217525502643247430216442004744797767185" \
+    "6044094354725193757050434098441887307219604316206364434803209059" \
+    "5566177250977527970490595791813768478966190806727946269119246500" \
+    "1172057969091681981647990493"
+#define TEST_KEY_3072_P \
+    "2034232909401992709836455123422892544250417470254524953623021428" \
+    "4238673234443049965403971307263132824374846643956033845410442502" \
+    "4746939074260393261367084664916051685099669478895579018705939566" \
+    "3270914524744571405118116123907093208296242070814598422191731519" \
+    "2510633724054333117443817871906347955889775662587657715165522719" \
+    "7571473844045248661645144309751532639329844177890551751645458952" \
+    "9668149821830182462828713426908330665754982689208372926440224598" \
+    "191115974936949"
+#define TEST_KEY_3072_Q \
+    "1832266593138873750344904334468202720286978038095052896072116475" \
+    "3995849934748263396084166590300741111990641614736242731592905226" \
+    "7436467263490774092832144480558604758708991712735123257213024900" \
+    "4461698654321452915299451908071086385173037190773351007690875600" \
+    "8130819993889671768034511956822496261764655802937372684370433453" \
+    "8649168786112555343795785745271276170752491041212916981101884795" \
+    "9240298299552298446653561801382160479392623440421471051720419919" \
+    "243790571849511"
+#define TEST_KEY_3072_DP \
+    "4573043235762936752372017842346991143085798951624260515697693624" \
+    "2075220526275150699650076944307450127640053039566084295044333641" \
+    "9060477803542788641488206412897781326056034062067010342645316024" \
+    "6421164181006419352671804454510155215806114779332511185155069727" \
+    "5013987008330025759387791431831823921467883003021798543957405165" \
+    "0490642559824015217666037675751000255618443668898713544561476227" \
+    "7888956059176355070396178482176546942729780118117545558271484658" \
+    "30747694565605"
+#define TEST_KEY_3072_DQ \
+    "2439313063633775343967421505139855155790451711610134201783605634" \
+    "6584950589846742775963860643662963852803507650422466367570700230" \
+    "9135782363238629165198355218101809133731472709097754004483519577" \
+    "7031039070899595142589333948444425089740871490836853615835770574" \
+    "9567634229013745849840718498447637194851247673929013636744439306" \
+    "7994262425627057292005772407570057309583210146113294880771769358" \
+    "4444146461326243793132478861873346381845467372274796668486605092" \
+    "60449406280223"
+#define TEST_KEY_3072_QINV \
+    "1147898158382149842213819369023696316106071418311748815337437681" \
+    "8422531582972146661168601485452984350108068062697736817112719671" \
+    "2089294354060548622406184887828349649078346393625835730487187815" \
+    "3587339878307665087062569214690668031511404834126664974028165649" \
+    "4735788765607219025739147011929790526919082365209465075802101569" \
+    "1066435656856382778457913462281498307624996719969381718390669144" \
+    "0330722236985464469944270998924582197719845870873694915807886056" \
+    "850787564090898"
+
+/* 4096-bit key */
+#define TEST_KEY_4096_N \
+    "7662494433041156016909101636592823040769603408373121053969958467" \
+    "8434840885318125420617042794542487175316730869680592248619467684" \
+    "5827095201174606172797467472803468950417581675250402640659562121" \
+    "4362367198820618080212237062847766723509710734124100363679063803" \
+    "6950618799067858962472480741116556755949753330818124427142787874" \
+    "1320629003327848379857324469278417152031706400966667454313889121" \
+    "8822866346087396505157011821762614827531999390803591007283949149" \
+    "6760791335539080624455800302773729024567143542230856459389608700" \
+    "9131769705836385925794919215915501024926394737666052931597363869" \
+    "9641230365755795759136953217382098930223292541520664496083834971" \
+    "8699211555223581567744596947656668636562124140967375250378176497" \
+    "5676709291728191316479614753769919616943351313964934026218569941" \
+    "0111222175428713497061707074863019048063272403229672383576475534" \
+    "8118198298934556199680354861960418819333921796880261822325274687" \
+    "9058412053022599685578225738713459143252205977527244436847965837" \
+    "9034925227488277773687986595096890328025487212948291313727128362" \
+    "4228124721601770974760941523763263303435400510703618157754165246" \
+    "1967568579051821207566662776984504634597536484264814531422627750" \
+    "1408487838514801412030316669231118555926321125378737703816750172" \
+    "03056289161471553"
+#define TEST_KEY_4096_E "65537"
+#define TEST_KEY_4096_D \
+    "6158395074909750069436267390228961832475348818644936733680709177" \
+    "9832143011305353635617302998238234214899530139207638360245493562" \
+    "6620499442816568406193060491954784599399882063408865726080546650" \
+    "6149225418921815246806827543110746490441509966021509626712932972" \
+    "2161244315331824789063151225055492862471022206044183573991462750" \
+    "8158915287208540119139339962281877831459939506002972236863883375" \
+    "3810022241089588971388417309028355425228180080139495969164957376" \
+    "5401723936420376645126388779587854830805695534250191294340588740" \
+    "6937960843960923412369087422376813521147375174629830066062867516" \
+    "6804289278427028275983660654936274255796834292095252188599389733" \
+    "6189446262544016179138691761566291739215770999125027305031598712" \
+    "0830940951686143099884596864072555204201214266798152230604191245" \
+    "9088607988466418488745990885581776482624135006413760076848632674" \
+    "5038311743174150783014578564465411148752515831652589566129792638" \
+    "8710119755031366196606975555758748457563850537299904717323891932" \
+    "4906062689115778156735755899799071686727713194842248710150592786" \
+    "6104228641940611004239274231150318765698570859556178809957039535" \
+    "8574956315777736700879363152114852846958762913810361301327587880" \
+    "4734413406991055328154101691074292957972358049716975518322540354" \
+    "7380175802854237"
+#define TEST_KEY_4096_P \
+    "2989860958561262869187873602505707742980759202685368485514938654" \
+    "6884522594134714111912295842244079329870521337540038972845908170" \
+    "8525282785114559945562688214313757134436286992099475799129668505" \
+    "4214891324245678004576329790093255811393730114027161672406470282" \
+    "0637864380073821664215518313948326663073356223019364574423307009" \
+    "4252425642223427646544916774807380725922872160702551544996027751" \
+    "7184190599945821362729924101932652625421299746013424595795992521" \
+    "6979450778530271428654531493903805597893292763121267521354246630" \
+    "8462230059875978206710117830206485152605542098286270595069142889" \
+    "23181301377486262096282494108962794123877"
+#define TEST_KEY_4096_Q \
+    "2562826345185091630331341098457431165689074103401123472827973611" \
+    "3801764452646506769689445928776719339233788883840822714430006314" \
+    "1955078251001963646585688031227052493837350618356857816124695106" \
+    "9906755412917826196490264432318119920270640501323468869916559867" \
+    "8695903176018720170671913463717257414808565303161056416104559706" \
+    "4083838685447964563540994722624269343763548202660484671420407197" \
+    "2271516579781836362414926366206640016990932125767431135791560805" \
+    "2543540783107536944171681198864601312382892912975789207777830538" \
+    "4982240023904894402760335766249430556694079790393633190400590850" \
+    "28539183145058063658990575926379651004589"
+#define TEST_KEY_4096_DP \
+    "5260096869281682237779602764375972393696408686232555447760386146" \
+    "5367432978374544716778120918118655823947863195116750744909489480" \
+    "7405970751235313818505240568081788876520193023621306432086466861" \
+    "0875947475251028791791672258384613196418772329330481114919297854" \
+    "9819884386262899398569499085985657937536932915973156162641062273" \
+    "0172340457273924769925826695382623521047761724354245588568930524" \
+    "3318082551440456583651376305794205528343925732263421516018095697" \
+    "8771238762295196541249484737585009772145454561360485606789212758" \
+    "2368663898312408063134970868712448511457939849739948420151550652" \
+    "737049918187308851442905773954164847717"
+#define TEST_KEY_4096_DQ \
+    "8450205913164265230301959167579631362341151151318320509687608796" \
+    "3004459779550233423290543826378401239224093869251924567209058462" \
+    "1588917088957601421955556810166070668375316159127415131702478991" \
+    "5561450435287136469468868596054481187287832917756204710320420859" \
+    "1778655069745109505782897910717032436119793038437412163450177868" \
+    "3459369539930888849589904170344665799378444712344235052676133958" \
+    "6617514041305781765327089101936201554413087615500926104844566800" \
+    "5464603625764189057571426679015696440069263615437665592088612555" \
+    "7178574648909907861093442722871651875978816575463634223624268380" \
+    "2763373492554735456415877369930541198989"
+#define TEST_KEY_4096_QINV \
+    "1974107254682442565701685407859947380056946699084737730303487627" \
+    "8307314155140464666565875158619758884827818527982601088145566835" \
+    "9819829650783800944056828227665692349150676179688400392575567860" \
+    "9377388622190421421272246348512836253013247587151292019092857886" \
+    "5523673597658870759621173403036891641726569481343129017981064498" \
+    "8721317715790976688197188500660712353475334018810800751054270262" \
+    "4246080922146359294597500212988874951979512827768937858827574281" \
+    "8412684859889090286747642506307292792468534170164252910497537782" \
+    "0478856632609450767094295220881432910542682653392226705917295607" \
+    "63075895264941579657203402559054631141218"
+
+#endif /* RSA_4096_TEST_KEYS_H */
@@ -28,7 +28,7 @@ int generate_4096_bit_test_modulus(bigint_t *modulus) {
     // Use a pattern that's more likely to be coprime with 65537
     
     // Start with a base pattern - FIXED: Prevent integer overflow completely
-    for (int i = 0; i < 120 && i < BIGINT_4096_WORDS; i++) { // Use 120 words ≈ 3840 bits
+    for (int i = 0; i < 3840 / BIGINT_WORD_SIZE && i < BIGINT_4096_WORDS; i++) { // ≈ 3840 bits of limbs
         uint32_t value = 0x12345678 + (uint32_t)(i * 0x1234);  // FIXED: Much smaller multiplier to prevent overflow
         modulus->words[i] = value;
         modulus->used = i + 1;
@@ -165,7 +165,7 @@ int test_4096_bit_montgomery_context(void) {
         printf("✅ Montgomery context initialized successfully\n");
         printf("   Context active: %s\n", ctx.is_active ? "YES" : "NO");
         printf("   R words: %d\n", ctx.r.used);
-        printf("   n' computed: 0x%08x\n", ctx.n_prime);
+        printf("   n' computed: 0x" BIGINT_WORD_FMT "\n", ctx.n_prime);
         
         // Test for reasonable performance
         if (duration > 30.0) {
@@ -194,7 +194,7 @@ int test_4096_bit_system_capability(void) {
     
     printf("System configuration:\n");
     printf("  BIGINT_4096_WORDS: %d\n", BIGINT_4096_WORDS);
-    printf("  Maximum supported bits: %d\n", BIGINT_4096_WORDS * 32);
+    printf("  Maximum supported bits: %d\n", BIGINT_MAX_BITS);
     printf("  Memory per bigint: %zu bytes\n", sizeof(bigint_t));
     
     // Test 1: Multiple large number allocations
@@ -118,7 +118,7 @@ int test_real_4096_bit_key(void) {
         printf("✅ Montgomery context initialized successfully\n");
         printf("   n_words: %d\n", pub_key.mont_ctx.n_words);
         printf("   r_words: %d\n", pub_key.mont_ctx.r_words);
-        printf("   n_prime: 0x%08x\n", pub_key.mont_ctx.n_prime);
+        printf("   n_prime: 0x" BIGINT_WORD_FMT "\n", pub_key.mont_ctx.n_prime);
     } else {
         printf("⚠️  Montgomery context not active for 4096-bit key\n");
         printf("   This may indicate performance issues or initialization bugs\n");